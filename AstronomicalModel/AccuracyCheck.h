@@ -0,0 +1,148 @@
+//
+//  AccuracyCheck.h
+//  AstronomicalModel
+//
+//  Created by Matthew McGuire on 10/19/26.
+//  Copyright (c) 2026 Matthew McGuire. All rights reserved.
+//
+
+#ifndef AstronomicalModel_AccuracyCheck_h
+#define AstronomicalModel_AccuracyCheck_h
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include "AstronObject.h"
+
+/*---  (BEGIN) AccuracyCheck Classes ---*/
+// What the model's fast paths (the float stepping itself, stepping at a reduced cadence, the orbits
+// in closed form, the object tree on the GPU) are measured against. ReferenceOrbits steps a group's
+// orbits and spins as AstroObject::incremObject does, but with every rate, angle and position in
+// double, so it places each object where the float stepping would with no rounding at all.
+// PathErrors keeps, for one path, each object's worst position and angle errors against it over a
+// run, and the time the path took, and checks them against an AccuracyTolerance.
+struct ReferenceOrbits
+{
+    std::vector<int> parent;
+    std::vector<int> order;             // every parent before its children
+    std::vector<bool> held;
+    std::vector<double> orbitRadius;    // at the viewing scale
+    std::vector<double> rate;           // radians per minute
+    std::vector<double> orbitAngle;
+    std::vector<double> tilt;
+    std::vector<double> spinRate;
+    std::vector<double> spinAngle;
+    std::vector<glm::dvec3> position;
+    double minutes;                     // stepped since capture
+    void capture(AstroGroup&);
+    void step(double);
+    glm::dquat orientation(int body) const  // as in the body's modelTransform: spun, then tilted
+    {
+        double spin = 0.5*spinAngle[body], half = 0.5*tilt[body];
+        return glm::dquat(cos(half), 0.0, 0.0, sin(half)) * glm::dquat(cos(spin), 0.0, sin(spin), 0.0);
+    }
+    int size(void) const { return int(parent.size()); }
+};
+void ReferenceOrbits::capture(AstroGroup& group)
+{
+    int n = group.numObjects;
+    parent = group.parentOf;
+    held.resize(n);
+    orbitRadius.resize(n);
+    rate.resize(n);
+    orbitAngle.resize(n);
+    tilt.resize(n);
+    spinRate.resize(n);
+    spinAngle.resize(n);
+    position.assign(n, glm::dvec3(0.0));
+    order.clear();
+    for (size_t k = 0; k < group.order.size(); k++)
+        if (group.montum.valid(group.order[k])) order.push_back(group.order[k].slot);
+    double scale = group.currentScaleFactor();
+    for (int i = 0; i < n; i++) {
+        held[i] = group.alive(i);
+        AstroObject& obj = group.montum[i];
+        orbitRadius[i] = pow(double(obj.trueOrbitRadius()), scale);
+        rate[i] = obj.orbitRate();
+        orbitAngle[i] = obj.currentOrbitAngle;
+        tilt[i] = obj.tilt();
+        spinRate[i] = obj.rotationRate();
+        spinAngle[i] = obj.currentRotAngle;
+    }
+    minutes = 0.0;
+    step(0.0);
+}
+void ReferenceOrbits::step(double inc)
+{
+    const double twoPi = 2.0*M_PI;
+    for (size_t k = 0; k < order.size(); k++) {
+        int i = order[k];
+        orbitAngle[i] = fmod(orbitAngle[i] + rate[i]*inc, twoPi);
+        if (orbitAngle[i] < 0.0) orbitAngle[i] += twoPi;
+        spinAngle[i] = fmod(spinAngle[i] + spinRate[i]*inc, twoPi);
+        if (spinAngle[i] < 0.0) spinAngle[i] += twoPi;
+        glm::dvec3 relative(orbitRadius[i]*cos(orbitAngle[i]), 0.0, -orbitRadius[i]*sin(orbitAngle[i]));
+        position[i] = parent[i] < 0 ? relative : position[parent[i]] + relative;
+    }
+    minutes += inc;
+}
+
+// a float rotation, as the reference's double ones
+inline glm::dquat doubleRotation(const glm::quat& q) { return glm::dquat(q.w, q.x, q.y, q.z); }
+
+// The most each error may reach, for any object at any time of the run, before a path fails
+struct AccuracyTolerance
+{
+    double position;                    // over the object's distance from the root
+    double orbitAngle;                  // radians, of the object about its parent
+    double spinAngle;                   // radians, of its orientation
+};
+class PathErrors
+{
+public:
+    std::string name;
+    AccuracyTolerance tolerance;
+    std::vector<double> position, orbitAngle, spinAngle;    // the worst of each error, per object
+    std::vector<double> relativePosition;                   // position error over distance from the root
+    double seconds;                     // spent in the path
+    double evaluations;                 // object-steps of the run it covered in that time
+    PathErrors(const char* pathName, AccuracyTolerance limits, int objects)
+    : name(pathName), tolerance(limits), position(objects, 0.0), orbitAngle(objects, 0.0), spinAngle(objects, 0.0),
+      relativePosition(objects, 0.0), seconds(0.0), evaluations(0.0) {}
+    void compare(const ReferenceOrbits&, const std::vector<glm::dvec3>&, const std::vector<glm::dquat>&);
+    static double worst(const std::vector<double>& errors, int& body)
+    {
+        body = int(std::max_element(errors.begin(), errors.end()) - errors.begin());
+        return errors[body];
+    }
+    bool passed(void) const;
+    double throughput(void) const { return seconds > 0.0 ? evaluations/seconds : 0.0; }
+};
+// Compare a path's positions and orientations (one per slot of the group) with the reference's now
+void PathErrors::compare(const ReferenceOrbits& reference, const std::vector<glm::dvec3>& where,
+                         const std::vector<glm::dquat>& facing)
+{
+    for (int i = 0; i < reference.size(); i++) {
+        if (!reference.held[i]) continue;
+        double error = glm::length(where[i] - reference.position[i]), distance = glm::length(reference.position[i]);
+        position[i] = std::max(position[i], error);
+        if (distance > 0.0) relativePosition[i] = std::max(relativePosition[i], error/distance);
+        int p = reference.parent[i];
+        if (p >= 0 && reference.orbitRadius[i] > 0.0) {
+            // the angle between the two offsets from the parent, each as its own path places it
+            glm::dvec3 a = where[i] - where[p], b = reference.position[i] - reference.position[p];
+            orbitAngle[i] = std::max(orbitAngle[i], atan2(glm::length(glm::cross(a, b)), glm::dot(a, b)));
+        }
+        // the angle of the rotation from one orientation to the other (atan2 keeps it exact when small)
+        glm::dquat d = glm::conjugate(reference.orientation(i)) * facing[i];
+        spinAngle[i] = std::max(spinAngle[i], 2.0*atan2(glm::length(glm::dvec3(d.x, d.y, d.z)), fabs(d.w)));
+    }
+}
+bool PathErrors::passed(void) const
+{
+    int body;
+    return worst(relativePosition, body) <= tolerance.position && worst(orbitAngle, body) <= tolerance.orbitAngle
+        && worst(spinAngle, body) <= tolerance.spinAngle;
+}
+/*---  (END) AccuracyCheck Classes ---*/
+#endif
@@ -0,0 +1,109 @@
+//
+//  AntiAliasing.h
+//  AstronomicalModel
+//
+//  Created by Matthew McGuire on 10/19/26.
+//  Copyright (c) 2026 Matthew McGuire. All rights reserved.
+//
+
+#ifndef AstronomicalModel_AntiAliasing_h
+#define AstronomicalModel_AntiAliasing_h
+
+#include <cstddef>
+#include <algorithm>
+#include "lib3DMath.h"
+
+/*---  (BEGIN) AntiAliasing Class ---*/
+// The anti-aliasing chosen at run time, and what goes with it that needs no GL: the sample count
+// of the offscreen scene target, the post-pass run over it, the sub-pixel jitter and history
+// bookkeeping for the temporal filter, and what the targets cost in memory. main.h makes the
+// targets themselves (makeSceneTargets) and draws through them (beginSceneTarget, finishSceneTarget).
+//
+// With no samples and no post-pass there is no target at all: the scene is drawn into the window,
+// which asks for no samples of its own, so that mode costs nothing. Otherwise the scene is drawn
+// into a target of 'samples' samples, resolved (by a blit) into a one-sample colour texture, and
+// the post-pass draws that into the window: FXAA straight from it, TAA blended with the history
+// texture of the frames before, reprojected by the camera's movement through the scene's depth.
+enum PostFilters {NOPOST, FXAAPOST, TAAPOST, numPostFilters};
+class AntiAliasing
+{
+public:
+    static const int numSampleChoices = 5;
+    int sampleChoice;                       // which of sampleCount()'s counts
+    int postFilter;                         // one of PostFilters
+    int maxSamples;                         // the most the GL allows (GL_MAX_SAMPLES)
+    int width, height;                      // of the targets, in pixels
+    bool historyValid;                      // the TAA history holds a frame of this size and mode
+    int lastHistory;                        // which of the two history textures was written last
+    AntiAliasing() : sampleChoice(0), postFilter(NOPOST), maxSamples(16), width(0), height(0),
+                     historyValid(false), lastHistory(0), frame(0), stillFrames(0) {}
+    static int sampleCount(int choice)
+    {
+        static const int counts[numSampleChoices] = {0, 2, 4, 8, 16};
+        return counts[choice];
+    }
+    int samples(void) const { return std::min(sampleCount(sampleChoice), maxSamples); }
+    bool needsTarget(void) const { return samples() > 0 || postFilter != NOPOST; }
+    const char* postFilterName(void) const
+    {
+        return postFilter == FXAAPOST ? "FXAA" : postFilter == TAAPOST ? "TAA" : "none";
+    }
+    size_t targetBytes(void) const;         // the GPU memory the targets of this mode take
+    // TAA
+    glm::vec2 jitterOffset(void) const;     // this frame's offset from the pixel centre, in pixels
+    void jitter(matr4&) const;              // move a projection by this frame's jitter
+    matr4 reprojection(const matr4&) const; // this frame's clip space (unjittered) to the last one's
+    void advance(const matr4&, bool);       // the frame is drawn, with this view-projection
+    bool settling(void) const { return postFilter == TAAPOST && stillFrames < jitterPeriod; }
+    void restart(void) { historyValid = false; stillFrames = 0; }
+private:
+    static const int jitterPeriod = 8;      // Halton (2,3) points before the jitter repeats
+    static float halton(int, int);
+    long frame;
+    int stillFrames;                        // frames drawn in a row with nothing moving
+    matr4 lastViewProj;
+};
+float AntiAliasing::halton(int index, int base)
+{
+    float f = 1.0f, r = 0.0f;
+    for (int i = index; i > 0; i /= base) {
+        f /= base;
+        r += f * (i % base);
+    }
+    return r;
+}
+size_t AntiAliasing::targetBytes(void) const
+{
+    if (!needsTarget()) return 0;
+    size_t pixels = size_t(width) * size_t(height);
+    size_t bytes = pixels * 4 * 2;                          // the resolved colour and depth
+    if (samples() > 0) bytes += pixels * 4 * 2 * samples(); // the multisampled colour and depth
+    if (postFilter == TAAPOST) bytes += pixels * 4 * 2;     // two history textures, read one, write the other
+    return bytes;
+}
+glm::vec2 AntiAliasing::jitterOffset(void) const
+{
+    int index = int(frame % jitterPeriod) + 1;              // Halton's index 0 is the corner, not a spread point
+    return glm::vec2(halton(index, 2) - 0.5f, halton(index, 3) - 0.5f);
+}
+void AntiAliasing::jitter(matr4& projection) const
+{
+    if (postFilter != TAAPOST || width == 0 || height == 0) return;
+    glm::vec2 offset = jitterOffset();
+    projection[2][0] += 2.0f * offset.x / width;            // shifts clip x by a fraction of w, so NDC by so many pixels
+    projection[2][1] += 2.0f * offset.y / height;
+}
+matr4 AntiAliasing::reprojection(const matr4& viewProj) const
+{
+    return lastViewProj * glm::inverse(viewProj);
+}
+void AntiAliasing::advance(const matr4& viewProj, bool moving)
+{
+    if (moving || viewProj != lastViewProj) stillFrames = 0;
+    else if (stillFrames < jitterPeriod) stillFrames++;
+    lastViewProj = viewProj;
+    historyValid = true;
+    frame++;
+}
+/*---  (END) AntiAliasing Class ---*/
+#endif
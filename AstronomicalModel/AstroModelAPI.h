@@ -0,0 +1,67 @@
+/*
+//  AstroModelAPI.h
+//  AstronomicalModel
+//
+//  Created by Matthew McGuire on 10/19/26.
+//  Copyright (c) 2026 Matthew McGuire. All rights reserved.
+//
+//  The model with no window and no GL, for other programs: a C interface to AstroGroup, so it
+//  can be called from C, or from any language that calls C. Build it with AstroModelLib.cpp.
+//
+//  A model is a tree of objects in circular orbits, known by their slots (the Sun of the solar
+//  system is slot 0). Times are simulation minutes from when the model was made. Positions are
+//  in the viewing scale the app draws in, or in km with trueSizes set. Orientations are unit
+//  quaternions (x, y, z, w): the object's spin about its axis, then the tilt of the axis.
+//  A model may be used from any thread, but by one at a time.
+*/
+
+#ifndef AstronomicalModel_AstroModelAPI_h
+#define AstronomicalModel_AstroModelAPI_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct AstroModel AstroModel;
+enum AstroStatus {ASTRO_OK = 0, ASTRO_BAD_ARGUMENT = -1, ASTRO_NO_OBJECT = -2};
+
+/* the solar system, drawn with this scale factor (the app starts with 0.35); NULL if it could not be made */
+AstroModel* astroCreate(float scaleFactor);
+/* a system of only its star, to add to */
+AstroModel* astroCreateSystem(const char* name, float radiusKm, float tiltDegrees, float rotationDays, float scaleFactor);
+void astroDestroy(AstroModel* model);
+
+/* add an object orbiting 'parent': replies its slot, or a negative AstroStatus */
+int astroAddObject(AstroModel* model, int parent, const char* name, float radiusKm, float tiltDegrees,
+                   float rotationDays, float orbitRadiusKm, float orbitYears);
+/* remove an object and everything orbiting it: replies how many went, or a negative AstroStatus */
+int astroRemoveObject(AstroModel* model, int slot);
+int astroSlots(const AstroModel* model);                   /* every slot below this may hold an object */
+int astroCount(const AstroModel* model);                   /* objects held */
+int astroIsAlive(const AstroModel* model, int slot);
+int astroFindObject(const AstroModel* model, const char* name);    /* its slot, or ASTRO_NO_OBJECT */
+const char* astroObjectName(const AstroModel* model, int slot);    /* NULL if there is no such object */
+int astroParent(const AstroModel* model, int slot);        /* -1 for the root */
+
+/* move the model on by so many minutes, as the app's step does */
+int astroStep(AstroModel* model, double minutes);
+double astroMinutes(const AstroModel* model);
+
+/* worker threads for the batch queries besides the caller's (-1: one per core, the default) */
+int astroSetThreads(AstroModel* model, int threads);
+
+/* The positions (and, unless NULL, orientations) of numBodies objects at each of numTimes
+   times, computed in closed form in parallel. Nothing is stepped: any time, past or future,
+   costs the same. The result for time t and body b is at positions[3*(t*numBodies + b)] and
+   orientations[4*(t*numBodies + b)]; the caller's buffers must hold that many doubles. */
+int astroPositions(AstroModel* model, const int* bodies, int numBodies, const double* minutes, int numTimes,
+                   int trueSizes, double* positions, double* orientations);
+
+/* the point at radius r, azimuth theta and polar angle phi (radians), with y up, as the app places its camera */
+void astroEuclidSpherical(float r, float theta, float phi, float* xyz);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,13 @@
+//
+//  AstroModelLib.cpp
+//  AstronomicalModel
+//
+//  Created by Matthew McGuire on 10/19/26.
+//  Copyright (c) 2026 Matthew McGuire. All rights reserved.
+//
+//  The model as a library of its own, with no window and no GL (see AstroModelAPI.h). It is not
+//  part of the app, which has it already through main.h. Build it with e.g.
+//      c++ -std=c++11 -O2 -fPIC -shared -I<GLM's parent> AstroModelLib.cpp -o libastromodel.dylib
+
+#define ASTRO_MODEL_ONLY
+#include "AstroModelLib.h"
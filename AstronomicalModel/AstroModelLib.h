@@ -0,0 +1,196 @@
+//
+//  AstroModelLib.h
+//  AstronomicalModel
+//
+//  Created by Matthew McGuire on 10/19/26.
+//  Copyright (c) 2026 Matthew McGuire. All rights reserved.
+//
+
+#ifndef AstronomicalModel_AstroModelLib_h
+#define AstronomicalModel_AstroModelLib_h
+
+#include "AstroModelAPI.h"
+#include "AstronObject.h"
+#include "OrbitModel.h"
+#include "WorkPool.h"
+
+/*---  (BEGIN) AstroModel library ---*/
+// The C interface of AstroModelAPI.h, over an AstroGroup. Batch queries are answered from an
+// OrbitModel of the group, captured at the group's clock when first needed after a step or a
+// change (one for the viewing scale and one for true sizes), and shared out over a WorkPool in
+// runs of the (time, body) results, so they are spread evenly whatever the shape of the batch.
+struct AstroModel
+{
+    AstroGroup group;
+    double minutes;                         // simulation minutes the group has been stepped
+    OrbitModel orbits[2];                   // [0] viewing scale, [1] true sizes, as of 'minutes'
+    bool captured[2];
+    int workers;                            // for the pool, when it is started
+    WorkPool* pool;
+    AstroModel(float scaleFact) : group(scaleFact), minutes(0.0), workers(-1), pool(NULL) { captured[0] = captured[1] = false; }
+    AstroModel(float scaleFact, const AstroObject& root)
+    : group(scaleFact, root), minutes(0.0), workers(-1), pool(NULL) { captured[0] = captured[1] = false; }
+    ~AstroModel() { if (pool != NULL) releasePool(pool); }
+    bool holds(int slot) const { return slot >= 0 && slot < group.numObjects && group.montum.alive(slot); }
+    void changed(void) { captured[0] = captured[1] = false; }
+    const OrbitModel& orbitsFor(bool trueSizes);
+};
+const OrbitModel& AstroModel::orbitsFor(bool trueSizes)
+{
+    int k = trueSizes ? 1 : 0;
+    if (!captured[k]) orbits[k].capture(group, !trueSizes);
+    captured[k] = true;
+    return orbits[k];
+}
+class AstroPositionsJob : public PoolJob
+{
+public:
+    const OrbitModel* orbits;
+    const int* bodies;
+    const double* minutes;
+    long numBodies, results;
+    int tasks;
+    double epoch;                           // the time the orbits were captured at
+    double* positions;
+    double* orientations;
+    void run(int task)
+    {
+        long end = results * (task+1) / tasks;
+        for (long k = results * task / tasks; k < end; k++) {
+            int body = bodies[k % numBodies];
+            double t = minutes[k / numBodies] - epoch;
+            glm::dvec3 p = orbits->positionAt(body, t);
+            positions[3*k] = p.x;
+            positions[3*k+1] = p.y;
+            positions[3*k+2] = p.z;
+            if (orientations == NULL) continue;
+            glm::dquat q = orbits->orientationAt(body, t);
+            orientations[4*k] = q.x;
+            orientations[4*k+1] = q.y;
+            orientations[4*k+2] = q.z;
+            orientations[4*k+3] = q.w;
+        }
+    }
+};
+
+extern "C" {
+AstroModel* astroCreate(float scaleFactor)
+{
+    return new AstroModel(scaleFactor);
+}
+AstroModel* astroCreateSystem(const char* name, float radiusKm, float tiltDegrees, float rotationDays, float scaleFactor)
+{
+    if (name == NULL || radiusKm <= 0.0 || rotationDays == 0.0) return NULL;
+    return new AstroModel(scaleFactor, AstroObject(name, radiusKm, tiltDegrees, rotationDays, 0.0, 9999.0, scaleFactor));
+}
+void astroDestroy(AstroModel* model)
+{
+    delete model;
+}
+int astroAddObject(AstroModel* model, int parent, const char* name, float radiusKm, float tiltDegrees,
+                   float rotationDays, float orbitRadiusKm, float orbitYears)
+{
+    if (model == NULL || name == NULL || radiusKm <= 0.0 || rotationDays == 0.0 || orbitYears == 0.0) return ASTRO_BAD_ARGUMENT;
+    if (!model->holds(parent)) return ASTRO_NO_OBJECT;
+    AstroGroup& group = model->group;
+    int slot = group.addObject(AstroObject(name, radiusKm, tiltDegrees, rotationDays, orbitRadiusKm, orbitYears,
+                                           group.currentScaleFactor()), parent);
+    group.changedSlots.clear();             // no GPU copies to bring up to date
+    model->changed();
+    return slot;
+}
+int astroRemoveObject(AstroModel* model, int slot)
+{
+    if (model == NULL) return ASTRO_BAD_ARGUMENT;
+    if (!model->holds(slot) || model->group.parentOf[slot] < 0) return ASTRO_NO_OBJECT;
+    int removed = model->group.removeObject(slot);
+    model->group.changedSlots.clear();
+    model->changed();
+    return removed;
+}
+int astroSlots(const AstroModel* model)
+{
+    return model != NULL ? model->group.numObjects : ASTRO_BAD_ARGUMENT;
+}
+int astroCount(const AstroModel* model)
+{
+    return model != NULL ? model->group.montum.count() : ASTRO_BAD_ARGUMENT;
+}
+int astroIsAlive(const AstroModel* model, int slot)
+{
+    return model != NULL && model->holds(slot);
+}
+int astroFindObject(const AstroModel* model, const char* name)
+{
+    if (model == NULL || name == NULL) return ASTRO_BAD_ARGUMENT;
+    for (int i = 0; i < model->group.numObjects; i++)
+        if (model->holds(i) && model->group.montum[i].name == name) return i;
+    return ASTRO_NO_OBJECT;
+}
+const char* astroObjectName(const AstroModel* model, int slot)
+{
+    return model != NULL && model->holds(slot) ? model->group.montum[slot].name.c_str() : NULL;
+}
+int astroParent(const AstroModel* model, int slot)
+{
+    if (model == NULL) return ASTRO_BAD_ARGUMENT;
+    return model->holds(slot) ? model->group.parentOf[slot] : ASTRO_NO_OBJECT;
+}
+int astroStep(AstroModel* model, double minutes)
+{
+    if (model == NULL) return ASTRO_BAD_ARGUMENT;
+    model->group.updateMontum(float(minutes));
+    model->minutes += minutes;
+    model->changed();
+    return ASTRO_OK;
+}
+double astroMinutes(const AstroModel* model)
+{
+    return model != NULL ? model->minutes : 0.0;
+}
+int astroSetThreads(AstroModel* model, int threads)
+{
+    if (model == NULL || threads < -1) return ASTRO_BAD_ARGUMENT;
+    if (model->pool != NULL) releasePool(model->pool);     // taken again, with so many, at the next batch
+    model->pool = NULL;
+    model->workers = threads;
+    return ASTRO_OK;
+}
+int astroPositions(AstroModel* model, const int* bodies, int numBodies, const double* minutes, int numTimes,
+                   int trueSizes, double* positions, double* orientations)
+{
+    if (model == NULL || numBodies < 0 || numTimes < 0) return ASTRO_BAD_ARGUMENT;
+    if (numBodies == 0 || numTimes == 0) return ASTRO_OK;
+    if (bodies == NULL || minutes == NULL || positions == NULL) return ASTRO_BAD_ARGUMENT;
+    for (int b = 0; b < numBodies; b++)
+        if (!model->holds(bodies[b])) return ASTRO_NO_OBJECT;
+    AstroPositionsJob job;
+    job.orbits = &model->orbitsFor(trueSizes != 0);
+    job.bodies = bodies;
+    job.minutes = minutes;
+    job.numBodies = numBodies;
+    job.results = long(numBodies) * numTimes;
+    job.epoch = model->minutes;
+    job.positions = positions;
+    job.orientations = orientations;
+    const long serialResults = 4096;        // fewer than this are not worth waking the pool for
+    if (job.results < serialResults) {
+        job.tasks = 1;
+        job.run(0);
+        return ASTRO_OK;
+    }
+    if (model->pool == NULL) model->pool = acquirePool(model->workers);
+    job.tasks = int(std::min(job.results / 1024, long(8 * model->pool->threads())));
+    model->pool->runAll(job, job.tasks);
+    return ASTRO_OK;
+}
+void astroEuclidSpherical(float r, float theta, float phi, float* xyz)
+{
+    point3 p = euclidSpherical(r, theta, phi);
+    xyz[0] = p.x;
+    xyz[1] = p.y;
+    xyz[2] = p.z;
+}
+}
+/*---  (END) AstroModel library ---*/
+#endif
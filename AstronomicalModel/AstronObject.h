@@ -10,6 +10,11 @@
 #define AstronomicalModel_AstronObject_h
 
 #include <vector>
+#include "lib3DMath.h"
+#include "CompactTransform.h"
+#include "BodyPool.h"
+
+// With ASTRO_MODEL_ONLY defined, the drawing is left out and the model needs no GL (see AstroModelLib.cpp)
 
 const float orbitPerInc = (M_PI*2.0)/(365.25*24.0*60.0);
 const float rotPerInc = (M_PI*2.0)/(24.0*60.0);
@@ -17,6 +22,7 @@ const float twoPi = 2.0*M_PI;
 
 class AstroObject
 {
+    friend class Snapshot;      // saves and restores every field as it is
 private:
     float radius;               // radius (in world-space units)
     float scaledRadius;         // radius scaled to make viewing easier
@@ -39,29 +45,67 @@ public:
     glm::vec3 currentRelLocation;  // current location (in world-space coordinates)
     glm::vec3 currentRelVelocity;  // approximate velocity vector (in world-space coordinates
     glm::vec3 currentAbsLocation;
-    glm::mat4 absLocationMatrix;      // current matrix of absolute location transformation in world coords
-    glm::mat4 relLocation;      // current matrix of transformation relative to parent
-    glm::mat4 modelScale;       // current matrix of scale transformation
-    glm::mat4 modelOrientation; // current matrix of orientation transformation
+    CompactTransform absLocation;       // current absolute location transformation in world coords
+    CompactTransform relLocation;       // current transformation relative to parent
+    CompactTransform modelTransform;    // absolute location, spin, tilt and scale: the transform that is drawn
     void incremObject(float);   // this function increments the object in its orbit and rotation
                                 //      (1 unit = 10 earth minutes)
     AstroObject *leftmostChild; // pointer to the leftmost child of this object in the object tree
     AstroObject *rightSibling;  // pointer to the right sibling of this object in the object tree
+    AstroObject *leftSibling;   // pointer to the left sibling (NULL for the leftmost), so it unlinks at once
+    int index;                  // its slot in its group's montum
     void report(float, float);  // print several parameters to stdout for error tracking
-    void adjustScale(float);     // change the scale factor during run-time
+    void rescale(float);        // take this scale factor, if it is not the one it has already
+    float viewingScaleFactor(void) { return scaleFactor; }
     void updateAbsLocationModelOrientation(void); // done after the increment, and the updating of the absolute matrices.
+    float viewingRadius(void);        // radius as currently drawn (world-space units)
+    float viewingOrbitRadius(void);   // orbit radius as currently drawn (world-space units)
+    float trueRadius(void);           // radius as specified (km)
+    float trueOrbitRadius(void);      // orbit radius as specified (km)
+    double orbitRate(void);           // orbital angular speed (radians per 'inc' unit, i.e. per minute)
+    double rotationRate(void);        // spin about its own axis (radians per minute)
+    float tilt(void);                 // tilt of the spin axis (radians)
 };
+float AstroObject::viewingRadius(void)
+{
+    return scaledRadius;
+}
+float AstroObject::viewingOrbitRadius(void)
+{
+    return scaledOrbitRadius;
+}
+float AstroObject::trueRadius(void)
+{
+    return radius;
+}
+float AstroObject::trueOrbitRadius(void)
+{
+    return orbitRadius;
+}
+double AstroObject::orbitRate(void)
+{
+    return double(orbitPerInc) / orbitSpeed;
+}
+double AstroObject::rotationRate(void)
+{
+    return double(rotPerInc) / rotSpeed;
+}
+float AstroObject::tilt(void)
+{
+    return tiltAngle;
+}
 float AstroObject::viewingScale(float value)
 {
     return (pow(value, scaleFactor));
 }
-void AstroObject::adjustScale(float scaleFactorChange)
+// Only the scaled radii change: the object keeps its place in its orbit, and is put there at the
+// new scale by its next incremObject
+void AstroObject::rescale(float newScaleFactor)
 {
-    scaleFactor +=scaleFactorChange;
+    if (newScaleFactor == scaleFactor) return;
+    scaleFactor = newScaleFactor;
     scaledRadius = viewingScale(radius);
     scaledOrbitRadius = viewingScale(orbitRadius);
-    currentRelLocation = glm::vec3(scaledOrbitRadius,0.0,0.0);
-    modelScale = glm::scale(glm::mat4(1.0f),glm::vec3(scaledRadius,scaledRadius,scaledRadius));
 }
 
 /*---  Constructor: creates an astronomical object instance             ---*/
@@ -84,12 +128,14 @@ AstroObject::AstroObject(std::string initName, float initRadius, float initTiltA
     currentRelLocation = glm::vec3(scaledOrbitRadius,0.0,0.0);
     currentAbsLocation = currentRelLocation;
     currentRelVelocity = glm::vec3(0.0);
-    relLocation = glm::translate(glm::mat4(1.0f),currentRelLocation);  // initial loc is on pos x-Axis
-    modelScale = glm::scale(glm::mat4(1.0f),glm::vec3(scaledRadius,scaledRadius,scaledRadius));
-    modelOrientation = glm::rotate(glm::mat4(1.0f),tiltAngle,glm::vec3(0.0,0.0,1.0));
+    relLocation = CompactTransform(glm::quat(), currentRelLocation, 1.0);  // initial loc is on pos x-Axis
+    modelTransform = CompactTransform(CompactTransform::axisRotation(tiltAngle, glm::vec3(0.0,0.0,1.0)),
+                                      glm::vec3(0.0), scaledRadius);
     leftmostChild = NULL;
     rightSibling = NULL;
-    absLocationMatrix = glm::mat4(1.0);
+    leftSibling = NULL;
+    index = -1;
+    absLocation = CompactTransform();
 }
 
 /*---  This function increments the object in its orbit and rotation    ---*/
@@ -110,14 +156,14 @@ void AstroObject::incremObject(float inc)
     while (currentRotAngle > twoPi) currentRotAngle -= twoPi;       // keep angle in [0,2π]
     while (currentRotAngle < 0.0) currentRotAngle += twoPi;       // keep angle in [0,2π]
 
-    // update the relLocation matrix by rotating around the orbital axis
-    glm::mat4 preRotate = glm::rotate(matr4(1.0f),-1*currentOrbitAngle,orbitAxis);
-    glm::mat4 transToOrbit = glm::translate(matr4(1.0f),glm::vec3(scaledOrbitRadius,0.0,0.0));
-    relLocation = glm::rotate(matr4(1.0f),currentOrbitAngle,orbitAxis) * transToOrbit * preRotate;
+    // update relLocation by carrying the orbit radius around the orbital axis. Rotating in,
+    // translating, and rotating back out leaves a pure translation, so that is all that is kept.
+    glm::quat orbitRotation = CompactTransform::axisRotation(currentOrbitAngle, orbitAxis);
+    relLocation = CompactTransform(glm::quat(), orbitRotation * glm::vec3(scaledOrbitRadius,0.0,0.0), 1.0);
 
     // update currentRelLocation
     glm::vec3 oldLocation=currentRelLocation;
-    currentRelLocation = glm::vec3( relLocation * glm::vec4(0.0,0.0,0.0,1.0));
+    currentRelLocation = relLocation.translation;
 
     // update currentRelVelocity
     currentRelVelocity= currentRelLocation - oldLocation;
@@ -125,12 +171,11 @@ void AstroObject::incremObject(float inc)
 void AstroObject::updateAbsLocationModelOrientation(void)
 {
     // update currentAbsLocation
-    currentAbsLocation = glm::vec3( absLocationMatrix * glm::vec4(0.0,0.0,0.0,1.0));    // where is the object?
-    // update the modelScale matrix by rotating around the rotational axis
-    modelOrientation = glm::translate(glm::mat4(1.0f),-currentAbsLocation);             // bring it to the origin
-    modelOrientation = glm::rotate(glm::mat4(1.0f),currentRotAngle,orbitAxis) * modelOrientation;   // rotate it on its axis
-    modelOrientation = glm::rotate(glm::mat4(1.0f),tiltAngle,glm::vec3(0.0,0.0,1.0)) * modelOrientation;    // tilt its axis
-    modelOrientation= glm::translate(glm::mat4(1.0f),currentAbsLocation) * modelOrientation;    // put it back where it was
+    currentAbsLocation = absLocation.translation;    // where is the object?
+    // the drawn transform: rotate it on its axis, tilt its axis, scale it, and put it where it is
+    modelTransform = CompactTransform(CompactTransform::axisRotation(tiltAngle, glm::vec3(0.0,0.0,1.0)) *
+                                      CompactTransform::axisRotation(currentRotAngle, orbitAxis),
+                                      currentAbsLocation, scaledRadius);
 //    report(0.0,0.0);
 }
 void AstroObject::report(float incOrbit,float incRot)
@@ -147,33 +192,50 @@ void AstroObject::report(float incOrbit,float incRot)
 
 class AstroGroup
 {
+    friend class Snapshot;
 private:
     float objectScaleFactor;
+    int staleInOrder;                       // entries of 'order' whose objects have since been removed
+    void compactOrder(void);
 public:
-    std::vector<AstroObject>::iterator iter;
     AstroGroup(float);                      // constructor that brings a custom scale factor
+    AstroGroup(float, const AstroObject&);  // a group of only this root object (a star), to add to
+    AstroGroup(const AstroGroup&);          // a copy has its own tree pointers (see linkMontum)
     void updateMontum(float);               // traverse the objects and increment them all
-    void drawMontum(void);                  // draw the objects as instances of a sphere
-    void traverseM(AstroObject& ,glm::mat4);    // traverse the tree of montum and assign absLocationMatrix
-    BetterSphere s = BetterSphere(100,100,1.0);
-    GLsizei numObjects;
-    std::vector<AstroObject> montum;        // a collection of astronomical objects
-    void adjustScale(float);                // change the scale factor during run-time
+#ifndef ASTRO_MODEL_ONLY
+    void drawMontum(GLsizei);               // draw this many instances of the sphere (see classifyBodies)
+    void drawMontumStrip(GLsizei);          // the same, with the sphere built from gl_VertexID (no buffers)
+    void drawMontumTriangles(GLsizei, GLsizei);  // the same, with a triangle-list sphere of so many indices (SphereMeshes.h)
+    static BetterSphere s;                  // one sphere, shared by every group
+#endif
+    void traverseM(AstroObject& ,CompactTransform);    // traverse the tree of montum and assign absLocation
+    int numObjects;                         // slots in use or freed (montum.size()): the instances drawn
+    BodyPool<AstroObject> montum;           // a collection of astronomical objects, by slot (see BodyPool.h)
+    std::vector<int> parentOf;              // slot of each object's parent in montum (-1 for the root or a free slot)
+    std::vector<BodyHandle> order;          // the objects, every parent before its children
+    std::vector<int> changedSlots;          // slots added to or freed since the GPU's copies were last brought up to date
+    int addObject(AstroObject, int);        // add an object orbiting the given parent, returns its slot
+    int removeObject(int);                  // remove an object and all that orbit it, returns how many
+    bool alive(int slot) { return montum.alive(slot); }
+    void linkMontum(void);                  // rebuild the tree pointers from parentOf
+    void addSyntheticObjects(int, unsigned int);   // append a generated catalog of planets and moons
+    void adjustScale(float);                // change the scale factor during run-time (the objects take it in their next step)
     float currentScaleFactor(void);         // reply with current scale factor for objects
+    bool rescaled(void) { return montum[0].viewingScaleFactor() != objectScaleFactor; }  // not yet stepped at the new scale
 };
 
 float AstroGroup::currentScaleFactor(void)
 {
     return objectScaleFactor;
 }
+// Nothing is done per object here: each takes the new factor (see AstroObject::rescale) in the next
+// updateMontum, which visits every object anyway; shaders that scale for themselves take it as a uniform.
 void AstroGroup::adjustScale(float scaleFactorChange)
 {
-    for (int i =0;i < numObjects; i++)
-        montum[i].adjustScale(scaleFactorChange);
     objectScaleFactor += scaleFactorChange;
 }
 
-AstroGroup::AstroGroup(float scaleFact)
+AstroGroup::AstroGroup(float scaleFact) : staleInOrder(0), numObjects(0)
 {
     //                          initName initRadius initTiltAngle initRotSpeed initOrbitRadius initOrbitSpeed
     AstroObject sol = AstroObject(    "Sol",      1390000,    0.01,   26.0,   0.0,            9999.0, scaleFact);
@@ -196,67 +258,179 @@ AstroGroup::AstroGroup(float scaleFact)
     //    AstroObject deimos = AstroObject("Deimos",  .7,         0.0,    9999.0, 1.45,   0.003462);
     //    AstroObject jupiter = AstroObject("Jupiter",14.2984,    3.1,    0.415,  77,     11.9);
     
-    montum.push_back(sol);
-    montum.push_back(mercury);
-    montum.push_back(venus);
-    montum.push_back(earth);
-    montum.push_back(luna);
-    montum.push_back(mars);
-    montum.push_back(phobos);
-    montum.push_back(deimos);
-    montum.push_back(jupiter);
-    
-    montum[0].leftmostChild = &montum[1];
-    montum[1].rightSibling = &montum[2];
-    montum[2].rightSibling= &montum[3];
-    montum[3].leftmostChild = &montum[4];
-    montum[3].rightSibling = &montum[5];
-    montum[5].leftmostChild = &montum[6];
-    montum[6].rightSibling = &montum[7];
-    montum[5].rightSibling = &montum[8];
-    
-    numObjects = GLsizei(montum.size());
     objectScaleFactor = scaleFact;
+    addObject(sol, -1);
+    addObject(mercury, 0);
+    addObject(venus, 0);
+    addObject(earth, 0);
+    addObject(luna, 3);
+    addObject(mars, 0);
+    addObject(phobos, 5);
+    addObject(deimos, 5);
+    addObject(jupiter, 0);
 }
+AstroGroup::AstroGroup(float scaleFact, const AstroObject& root) : staleInOrder(0), numObjects(0)
+{
+    objectScaleFactor = scaleFact;
+    addObject(root, -1);
+}
+AstroGroup::AstroGroup(const AstroGroup& other)
+: objectScaleFactor(other.objectScaleFactor), staleInOrder(other.staleInOrder), numObjects(other.numObjects),
+  montum(other.montum), parentOf(other.parentOf), order(other.order), changedSlots(other.changedSlots)
+{
+    linkMontum();       // the copied pointers still point into the other group
+}
+#ifndef ASTRO_MODEL_ONLY
+BetterSphere AstroGroup::s = BetterSphere(100,100,1.0);
+#endif
+// The parent must already be in montum. The object takes the lowest free slot and is linked into
+// the tree at once (as its parent's leftmost child); nothing already in montum moves, and it is
+// placed where it belongs now, so it can be drawn before the next step.
+int AstroGroup::addObject(AstroObject obj, int parent)
+{
+    obj.leftmostChild = obj.rightSibling = obj.leftSibling = NULL;
+    BodyHandle h = montum.add(obj);
+    AstroObject& added = montum[h.slot];
+    added.index = h.slot;
+    if (int(parentOf.size()) <= h.slot) parentOf.resize(h.slot+1, -1);
+    parentOf[h.slot] = parent;
+    if (parent >= 0) {
+        AstroObject& p = montum[parent];
+        added.rightSibling = p.leftmostChild;
+        if (p.leftmostChild != NULL) p.leftmostChild->leftSibling = &added;
+        p.leftmostChild = &added;
+    }
+    added.rescale(objectScaleFactor);
+    added.incremObject(0.0);
+    added.absLocation = parent >= 0 ? montum[parent].absLocation * added.relLocation : added.relLocation;
+    added.updateAbsLocationModelOrientation();
+    order.push_back(h);                     // after its parent, which is already in the order
+    changedSlots.push_back(h.slot);
+    numObjects = montum.size();
+    return h.slot;
+}
+// Its slot and those of everything orbiting it are freed for reuse; handles to any of them go stale.
+// The root stays: everything else hangs from it.
+int AstroGroup::removeObject(int slot)
+{
+    if (slot <= 0 || slot >= numObjects || !montum.alive(slot) || parentOf[slot] < 0) return 0;
+    AstroObject& obj = montum[slot];
+    if (obj.leftSibling != NULL) obj.leftSibling->rightSibling = obj.rightSibling;
+    else montum[parentOf[slot]].leftmostChild = obj.rightSibling;
+    if (obj.rightSibling != NULL) obj.rightSibling->leftSibling = obj.leftSibling;
+    obj.rightSibling = obj.leftSibling = NULL;
+    int removed = 0;
+    std::vector<AstroObject*> pending(1, &obj);
+    while (!pending.empty()) {
+        AstroObject* node = pending.back();
+        pending.pop_back();
+        for (AstroObject* child = node->leftmostChild; child != NULL; child = child->rightSibling)
+            pending.push_back(child);
+        node->leftmostChild = NULL;
+        parentOf[node->index] = -1;
+        montum.remove(node->index);
+        changedSlots.push_back(node->index);
+        removed++;
+    }
+    staleInOrder += removed;
+    return removed;
+}
+// Drop the entries of removed objects from the order, once they are half of it
+void AstroGroup::compactOrder(void)
+{
+    size_t kept = 0;
+    for (size_t k = 0; k < order.size(); k++)
+        if (montum.valid(order[k])) order[kept++] = order[k];
+    order.resize(kept);
+    staleInOrder = 0;
+}
+void AstroGroup::linkMontum(void)
+{
+    // every tree pointer is rebuilt from the parent slots, in the same shape addObject leaves
+    for (int i = 0; i < numObjects; i++) {
+        montum[i].leftmostChild = montum[i].rightSibling = montum[i].leftSibling = NULL;
+    }
+    for (size_t k = 0; k < order.size(); k++) {
+        if (!montum.valid(order[k])) continue;
+        int i = order[k].slot, p = parentOf[i];
+        if (p < 0) continue;
+        montum[i].rightSibling = montum[p].leftmostChild;
+        if (montum[p].leftmostChild != NULL) montum[p].leftmostChild->leftSibling = &montum[i];
+        montum[p].leftmostChild = &montum[i];
+    }
+}
+// A reproducible catalog of extra planets (each with a few moons) for stress tests and benchmarks.
+// Orbital periods follow Kepler's third law, and each object starts at its own orbit angle.
+void AstroGroup::addSyntheticObjects(int count, unsigned int seed)
+{
+    srand(seed);
+    montum.reserve(montum.size()+count);
+    parentOf.reserve(parentOf.size()+count);
+    order.reserve(order.size()+count);
+    int added = 0;
+    while (added < count) {
+        float orbitR = 5.0e7 + 5.0e9 * float(rand())/RAND_MAX;
+        float r = 2000.0 + 70000.0 * float(rand())/RAND_MAX;
+        AstroObject planet = AstroObject("P" + std::to_string(added), r, 30.0*float(rand())/RAND_MAX,
+                                         0.4 + 2.0*float(rand())/RAND_MAX, orbitR,
+                                         pow(orbitR/149600000.0, 1.5), objectScaleFactor);
+        planet.currentOrbitAngle = twoPi * float(rand())/RAND_MAX;
+        int planetIndex = addObject(planet, 0);
+        added++;
+        int moons = rand() % 4;
+        for (int m = 0; m < moons && added < count; m++) {
+            float moonOrbitR = 1.0e4 + 2.0e6 * float(rand())/RAND_MAX;
+            AstroObject moon = AstroObject("P" + std::to_string(planetIndex) + "-m" + std::to_string(m),
+                                           5.0 + 2500.0*float(rand())/RAND_MAX, 0.0, 9999.0, moonOrbitR,
+                                           0.0748 * pow(moonOrbitR/238900.0, 1.5), objectScaleFactor);
+            moon.currentOrbitAngle = twoPi * float(rand())/RAND_MAX;
+            addObject(moon, planetIndex);
+            added++;
+        }
+    }
+}
+// One pass in 'order': each object is incremented and placed after its parent already has been
 void AstroGroup::updateMontum(float inc)
 {
-    std::vector<AstroObject>::iterator iterStop = montum.end();
-    for(iter = montum.begin(); iter < iterStop; iter++)     // increment every object in the group
-        (*iter).incremObject(inc);
-//    traverseM(montum[0], montum[0].relLocation); // update every absLocationMatrix matrix with parents' location
-    montum[0].absLocationMatrix = montum[0].relLocation;
-    
-    montum[1].absLocationMatrix = montum[0].absLocationMatrix * montum[1].relLocation;
-    montum[2].absLocationMatrix = montum[0].absLocationMatrix * montum[2].relLocation;
-    montum[3].absLocationMatrix = montum[0].absLocationMatrix * montum[3].relLocation;
-    montum[5].absLocationMatrix = montum[0].absLocationMatrix * montum[5].relLocation;
-    montum[8].absLocationMatrix = montum[0].absLocationMatrix * montum[8].relLocation;
-    
-    montum[4].absLocationMatrix = montum[3].absLocationMatrix * montum[4].relLocation;
-    montum[6].absLocationMatrix = montum[5].absLocationMatrix * montum[6].relLocation;
-    montum[7].absLocationMatrix = montum[5].absLocationMatrix * montum[7].relLocation;
-    
-    for(iter = montum.begin(); iter < iterStop; iter++)     // now, updated the absolute loc vector for all objects
-        (*iter).updateAbsLocationModelOrientation();
+    if (2*staleInOrder > int(order.size())) compactOrder();
+    for (size_t k = 0; k < order.size(); k++) {
+        if (!montum.valid(order[k])) continue;          // removed since it was ordered
+        int i = order[k].slot;
+        AstroObject& obj = montum[i];
+        obj.rescale(objectScaleFactor);
+        obj.incremObject(inc);
+        obj.absLocation = parentOf[i] < 0 ? obj.relLocation : montum[parentOf[i]].absLocation * obj.relLocation;
+        obj.updateAbsLocationModelOrientation();
+    }
 }
 
-void AstroGroup::traverseM(AstroObject& node,glm::mat4 m)
+void AstroGroup::traverseM(AstroObject& node,CompactTransform m)
 {
-    node.absLocationMatrix =  node.relLocation * m;
-    if (node.leftmostChild != NULL) traverseM(*(node.leftmostChild),node.absLocationMatrix);
+    node.absLocation =  node.relLocation * m;
+    if (node.leftmostChild != NULL) traverseM(*(node.leftmostChild),node.absLocation);
     if (node.rightSibling!= NULL) traverseM(*(node.rightSibling),m);
 }
 
+#ifndef ASTRO_MODEL_ONLY
 // This function should only be called when the relevant shader buffers have been bound
-void AstroGroup::drawMontum(void)
+void AstroGroup::drawMontum(GLsizei instances)
 {
-    glDrawElementsInstanced(GL_TRIANGLE_FAN,(s.theSphere.fans+2),GL_UNSIGNED_INT, (void*)(0 * sizeof(GLuint)), numObjects);
+    glDrawElementsInstanced(GL_TRIANGLE_FAN,(s.theSphere.fans+2),GL_UNSIGNED_INT, (void*)(0 * sizeof(GLuint)), instances);
     for (int j = 0; j<(s.theSphere.bands-2); j++) {
         glDrawElementsInstanced(GL_TRIANGLE_STRIP,(2*s.theSphere.fans+2), GL_UNSIGNED_INT,
-                       (void*)(((s.theSphere.fans+2)+j*(2*s.theSphere.fans+2)) * sizeof(GLuint)),numObjects);
+                       (void*)(((s.theSphere.fans+2)+j*(2*s.theSphere.fans+2)) * sizeof(GLuint)),instances);
     }
     glDrawElementsInstanced(GL_TRIANGLE_FAN,(s.theSphere.fans+2),GL_UNSIGNED_INT,
-                   (void*)((s.theSphere.numIndices-s.theSphere.fans-2) * sizeof(GLuint)),numObjects);
+                   (void*)((s.theSphere.numIndices-s.theSphere.fans-2) * sizeof(GLuint)),instances);
+}
+void AstroGroup::drawMontumStrip(GLsizei instances)
+{
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, s.stripVertices(), instances);
 }
+void AstroGroup::drawMontumTriangles(GLsizei instances, GLsizei indices)
+{
+    glDrawElementsInstanced(GL_TRIANGLES, indices, GL_UNSIGNED_INT, (void*)0, instances);
+}
+#endif
 
 #endif
@@ -1,12 +1,146 @@
 #version 330
-in vec4 colour;
+// Compiled twice: for the sphere meshes (AstronObjectGLSL.vert) and, with IMPOSTOR defined,
+// for the ray-cast squares of ImpostorGLSL.vert. Both are lit and shadowed the same way.
+#ifdef IMPOSTOR
+in vec3 quadPosition;
+flat in vec4 sphere;                    // xyz = centre, w = radius
+flat in vec4 rotation;                  // the object's orientation, for its texture coordinates
+flat in vec3 eyePosition;
+uniform camera {
+    mat4 modelvMatrix;
+    mat4 projMatrix;
+};
+#else
 in vec2 textureSTMapFrag;
+in vec3 worldPosition;
+in vec3 worldNormal;
+#endif
+flat in int instanceID;
 uniform sampler2D sample01;
+uniform samplerBuffer bodySpheres;      // xyz = centre, w = radius; one texel per body, body 0 is the Sun
+uniform isamplerBuffer occluderLists;   // up to four possible occluders per body, -1 where unused
+uniform int numBodies;
+uniform int shadowMode;                 // 0 = no shadows, 1 = occluder lists, 2 = test every body
+uniform int selectedObject;             // body picked with the mouse, or -1
+uniform int ownStars;                   // 1 for other systems' objects: bodySpheres holds each one's own star,
+                                        // with a negative radius for a star itself
 out vec4 fColor;
 
+const float PI = 3.14159265;
+const float ambient = 0.08;
+
+// Fraction of the Sun's disc (angular radius sunAngle, in direction toSun) that one
+// sphere hides when seen from p. Both discs are treated as flat circles on the sky,
+// which gives the umbra (full cover) and the penumbra (partial cover) together.
+float discOcclusion(vec3 p, vec3 toSun, float sunDist, float sunAngle, vec4 occluder) {
+    vec3 toOccluder = occluder.xyz - p;
+    float occDist = length(toOccluder);
+    if (occDist >= sunDist || occDist <= occluder.w) return 0.0;
+    float occAngle = asin(occluder.w / occDist);
+    float apart = acos(clamp(dot(toSun, toOccluder/occDist), -1.0, 1.0));
+    if (apart >= sunAngle + occAngle) return 0.0;                   // discs do not touch
+    if (apart <= abs(sunAngle - occAngle))                          // one disc inside the other
+        return min(1.0, (occAngle*occAngle)/(sunAngle*sunAngle));
+    float a2 = sunAngle*sunAngle;
+    float b2 = occAngle*occAngle;
+    float lens = a2*acos(clamp((apart*apart + a2 - b2)/(2.0*apart*sunAngle), -1.0, 1.0))
+               + b2*acos(clamp((apart*apart + b2 - a2)/(2.0*apart*occAngle), -1.0, 1.0))
+               - 0.5*sqrt(max(0.0, (-apart+sunAngle+occAngle)*(apart+sunAngle-occAngle)
+                                   *(apart-sunAngle+occAngle)*(apart+sunAngle+occAngle)));
+    return lens/(PI*a2);
+}
+
+// Flat colours by object; the Sun (object 0) is textured instead
+vec4 bodyColour(int i) {
+    switch(i)
+    {
+        case 1: return vec4(0.8,0.1,0.1,1.0);       // red
+        case 2: return vec4(0.1,0.8,0.1,1.0);       // green
+        case 3: return vec4(0.1,0.1,0.8,1.0);       // blue
+        case 4: return vec4(0.8,0.8,0.8,1.0);       // whitish
+        case 5: return vec4(0.4,0.05,0.05,1.0);     // darker red
+        default: return vec4(0.3,0.3,0.3,1.0);      // grey
+    }
+}
+
+// The texture holds two equirectangular maps: the Sun's below, everything else's above
+vec2 atlasCoords(vec2 st) {
+    return vec2(st.x, 0.5*st.y + (instanceID == 0 ? 0.0 : 0.5));
+}
+
+#ifdef IMPOSTOR
+// Where the ray from the eye through this fragment meets the sphere, its normal there, and the
+// equirectangular coordinates the mesh has at that point. Replies false if the ray misses.
+// Offsets are taken from the centre, so small distant spheres keep their precision.
+bool castSphere(out vec3 hit, out vec3 normal, out vec2 st) {
+    vec3 dir = normalize(quadPosition - eyePosition);
+    vec3 toCentre = sphere.xyz - eyePosition;
+    vec3 offset = toCentre - dot(toCentre, dir)*dir;        // from the ray's closest point to the centre
+    float missBy2 = dot(offset, offset);
+    float r2 = sphere.w*sphere.w;
+    if (missBy2 > r2) return false;
+    normal = (-offset - sqrt(r2 - missBy2)*dir) / sphere.w;
+    hit = sphere.xyz + sphere.w*normal;
+    // back into the object's own frame, then as in BetterSphere: s from θ, t from φ
+    vec3 local = normal + 2.0*cross(-rotation.xyz, cross(-rotation.xyz, normal) + rotation.w*normal);
+    float theta = atan(local.x, local.z);
+    st = vec2(fract(theta/(2.0*PI)), 1.0 - acos(clamp(local.y, -1.0, 1.0))/PI);
+    return true;
+}
+#endif
+
+float sunVisibility(vec3 p, vec3 toSun, float sunDist, float sunAngle) {
+    float hidden = 0.0;
+    if (shadowMode == 1) {
+        ivec4 list = texelFetch(occluderLists, instanceID);
+        for (int k = 0; k < 4; k++) {
+            if (list[k] < 0) break;
+            hidden += discOcclusion(p, toSun, sunDist, sunAngle, texelFetch(bodySpheres, list[k]));
+        }
+    }
+    else if (shadowMode == 2) {
+        for (int i = 1; i < numBodies; i++) {
+            if (i == instanceID) continue;
+            hidden += discOcclusion(p, toSun, sunDist, sunAngle, texelFetch(bodySpheres, i));
+        }
+    }
+    return clamp(1.0 - hidden, 0.0, 1.0);
+}
+
 void main() {
-    if (instanceID==0)
-        fColor = texture(sample01, textureSTMapFrag);
+    vec4 base;
+    bool star = (ownStars != 0) ? texelFetch(bodySpheres, instanceID).w < 0.0 : instanceID == 0;
+#ifdef IMPOSTOR
+    vec3 worldPosition, worldNormal;
+    vec2 st;
+    if (!castSphere(worldPosition, worldNormal, st)) discard;
+    vec4 clip = projMatrix * modelvMatrix * vec4(worldPosition, 1.0);
+    gl_FragDepth = 0.5*(gl_DepthRange.diff*clip.z/clip.w + gl_DepthRange.near + gl_DepthRange.far);
+    // s wraps from 1 to 0 at the seam; take the short way round so the mip level stays right there
+    vec2 stX = dFdx(st), stY = dFdy(st);
+    stX.x -= round(stX.x);
+    stY.x -= round(stY.x);
+    if (star)
+        base = textureGrad(sample01, atlasCoords(st), vec2(stX.x, 0.5*stX.y), vec2(stY.x, 0.5*stY.y));
+#else
+    if (star)
+        base = texture(sample01, atlasCoords(textureSTMapFrag));
+#endif
     else
-        fColor = colour;
+        base = bodyColour(instanceID);
+    if (star)                   // the Sun is its own light
+        fColor = base;
+    else {
+        vec4 sun = texelFetch(bodySpheres, (ownStars != 0) ? instanceID : 0);
+        vec3 toSun = sun.xyz - worldPosition;
+        float sunDist = length(toSun);
+        toSun /= sunDist;
+        float sunAngle = asin(min(1.0, sun.w/sunDist));
+        float diffuse = max(dot(normalize(worldNormal), toSun), 0.0);
+        if (diffuse > 0.0 && shadowMode != 0)
+            diffuse *= sunVisibility(worldPosition, toSun, sunDist, sunAngle);
+        fColor = vec4(base.rgb * (ambient + (1.0-ambient)*diffuse), base.a);
+    }
+    if (instanceID == selectedObject)
+        fColor.rgb = mix(fColor.rgb, vec3(1.0), 0.35);      // highlight the picked body
 }
\ No newline at end of file
@@ -3,43 +3,58 @@ in vec3 vPosition;
 in vec2 textureSTMap;
 out vec2 textureSTMapFrag;
 in vec3 vNormal;
+in int bodyIndex;                           // per instance: which object this sphere is (see classifyBodies)
 uniform camera {
     mat4 modelvMatrix;
     mat4 projMatrix;
 };
-uniform mat4 objectTransform[9];
-out vec4 colour;
-varying int instanceID;
+uniform samplerBuffer objectTransforms;    // two texels per instance: rotation quaternion, translation and scale
+uniform int sphereFans;                     // above 0: no vertex buffers, the sphere is built from gl_VertexID
+uniform int sphereBands;
+out vec3 worldPosition;
+out vec3 worldNormal;
+flat out int instanceID;
+
+// expand a CompactTransform (see CompactTransform.h) to a matrix
+mat4 fetchTransform(int i) {
+    vec4 q = texelFetch(objectTransforms, 2*i);
+    vec4 ts = texelFetch(objectTransforms, 2*i+1);
+    mat3 r = mat3(1.0 - 2.0*(q.y*q.y + q.z*q.z), 2.0*(q.x*q.y + q.w*q.z), 2.0*(q.x*q.z - q.w*q.y),
+                  2.0*(q.x*q.y - q.w*q.z), 1.0 - 2.0*(q.x*q.x + q.z*q.z), 2.0*(q.y*q.z + q.w*q.x),
+                  2.0*(q.x*q.z + q.w*q.y), 2.0*(q.y*q.z - q.w*q.x), 1.0 - 2.0*(q.x*q.x + q.y*q.y));
+    return mat4(vec4(ts.w*r[0], 0.0), vec4(ts.w*r[1], 0.0), vec4(ts.w*r[2], 0.0), vec4(ts.xyz, 1.0));
+}
+
+const float PI = 3.14159265;
+
+// The BetterSphere of sphereFans x sphereBands as one triangle strip, band by band from the top
+// (see BetterSphere::stripVertices). Each ring has a last column at θ = 2π with s = 1, so the
+// texture does not run backwards across the seam as it does with the shared vertices of the mesh.
+void sphereVertex(out vec3 position, out vec2 st) {
+    int perBand = 2*sphereFans + 4;
+    int band = gl_VertexID / perBand;
+    int k = clamp(gl_VertexID - band*perBand - 1, 0, 2*sphereFans + 1);
+    int fan = k / 2;
+    int ring = band + (k - 2*fan);          // upper ring, then lower, as in generateIndices
+    float theta = float(fan) * 2.0*PI / float(sphereFans);
+    float phi = float(ring) * PI / float(sphereBands);
+    position = vec3(sin(phi)*sin(theta), cos(phi), cos(theta)*sin(phi));     // as euclidSpherical
+    st = vec2(float(fan)/float(sphereFans), 1.0 - float(ring)/float(sphereBands));
+}
 
 void main() {
-    gl_Position = projMatrix * modelvMatrix * objectTransform[gl_InstanceID] * vec4(vPosition,1.0);
-    instanceID =gl_InstanceID;
-    if(gl_InstanceID == 0)
-       textureSTMapFrag = vec2(textureSTMap.x, 0.5*textureSTMap.y);
-    else
-       textureSTMapFrag = vec2(textureSTMap.x, 0.5*textureSTMap.y+0.5);
-    switch(gl_InstanceID)
-    {
-        case 0: // yellow
-            colour = vec4(0.96,0.929,0.02,1.0);
-            break;
-        case 1: // red
-            colour = vec4(0.8,0.1,0.1,1.0);
-            break;
-        case 2: // green
-            colour = vec4(0.1,0.8,0.1,1.0);
-            break;
-        case 3: // blue
-            colour = vec4(0.1,0.1,0.8,1.0);
-            break;
-        case 4: // whitish
-            colour = vec4(0.8,0.8,0.8,1.0);
-            break;
-        case 5: //darker red
-            colour = vec4(0.4,0.05,0.05,1.0);
-            break;
-        default: // grey
-            colour = vec4(0.3,0.3,0.3,1.0);
-            break;
+    vec3 position = vPosition;
+    vec3 normal = vNormal;
+    vec2 st = textureSTMap;
+    if (sphereFans > 0) {
+        sphereVertex(position, st);
+        normal = position;                  // exact on a unit sphere
     }
-}
\ No newline at end of file
+    mat4 objectTransform = fetchTransform(bodyIndex);
+    vec4 world = objectTransform * vec4(position,1.0);
+    worldPosition = world.xyz;
+    worldNormal = mat3(objectTransform) * normal;       // the scale is uniform, so no inverse-transpose
+    gl_Position = projMatrix * modelvMatrix * world;
+    instanceID = bodyIndex;
+    textureSTMapFrag = st;
+}
@@ -0,0 +1,1457 @@
+//
+//  Benchmarks.h
+//  AstronomicalModel
+//
+//  Created by Matthew McGuire on 10/19/26.
+//  Copyright (c) 2026 Matthew McGuire. All rights reserved.
+//
+//  Timing runs started from the command line, e.g.  AstronomicalModel -bench shadows 2000
+//  Results go to stdout in the same plain style as reportParam.
+
+#ifndef AstronomicalModel_Benchmarks_h
+#define AstronomicalModel_Benchmarks_h
+
+#include "main.h"
+#include <cstring>
+#include <chrono>
+#include <sys/wait.h>
+
+/*@@##====--- Benchmark helpers (BEGIN) ---====##@@*/
+// grow the solar system with generated objects so that it holds 'total' objects
+void benchGrowSystem(int total)
+{
+    if (total > solarSystem.numObjects)
+        solarSystem.addSyntheticObjects(total - solarSystem.numObjects, 2026);
+    std::cout << "Objects: " << solarSystem.numObjects << std::endl;
+}
+// wall-clock seconds, usable before GLFW is initialised
+double benchNow(void)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+// open the window and prepare every GL resource, as main() would
+void benchStartGL(void)
+{
+    initGLFW();
+    initOpenGL();
+    initTextures();
+    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+    polygonModeToggle = POINT;              // so that 'm' (and drawHud) know filled is in use
+    updateCamera();
+}
+// draw 'frames' frames of the current scene, waiting for the GPU each time; reply in ms per frame
+double benchTimeFrames(int frames)
+{
+    for (int i = 0; i < 5; i++) {           // warm-up frames are not counted
+        glClear(GL_COLOR_BUFFER_BIT| GL_DEPTH_BUFFER_BIT);
+        drawScene();
+        glfwSwapBuffers(mainWin);
+    }
+    glFinish();
+    GLdouble start = glfwGetTime();
+    for (int i = 0; i < frames; i++) {
+        glClear(GL_COLOR_BUFFER_BIT| GL_DEPTH_BUFFER_BIT);
+        drawScene();
+        glfwSwapBuffers(mainWin);
+        glFinish();
+    }
+    return 1000.0 * (glfwGetTime() - start) / frames;
+}
+/*@@##====--- Benchmark helpers (END) ---====##@@*/
+
+/*@@##====--- Benchmarks (BEGIN) ---====##@@*/
+// Eclipse shadows: occluder lists against testing every body in every fragment
+void benchmarkShadows(int numBodies)
+{
+    benchGrowSystem(numBodies > 0 ? numBodies : 1000);
+    benchStartGL();
+
+    const int steps = 20;
+    GLdouble start = glfwGetTime();
+    for (int i = 0; i < steps; i++) {
+        solarSystem.updateMontum(60.0);
+        shadowCasters.update(solarSystem);
+    }
+    double listMs = 1000.0 * (glfwGetTime() - start) / steps;
+    uploadObjectData();
+    std::cout << "Sim step + occluder lists: " << listMs << " ms per step, "
+    << float(shadowCasters.totalOccluders())/solarSystem.numObjects << " occluders per object" << std::endl;
+
+    const char* modeNames[numShadowModes] = {"no shadows", "occluder lists", "every body"};
+    for (int mode = 0; mode < numShadowModes; mode++) {
+        shadowMode = mode;
+        std::cout << "Frame time (" << modeNames[mode] << "): " << benchTimeFrames(50) << " ms" << std::endl;
+    }
+}
+
+// Orbit paths and trails: frame time with each orbit mode, and the cost of a simulation step with trails
+void benchmarkOrbits(int numBodies)
+{
+    benchGrowSystem(numBodies > 0 ? numBodies : 5000);
+    benchStartGL();
+    uploadOrbitParams();
+    const char* modeNames[numOrbitModes] = {"no orbits", "orbit paths", "paths and trails"};
+    for (int mode = 0; mode < numOrbitModes; mode++) {
+        orbitMode = mode;
+        trailFilled = 0;
+        double start = benchNow();
+        for (int i = 0; i < trailLength; i++) modelAnimate(60.0 * simulationSpeed);       // fill the trails
+        glFinish();
+        double stepMs = 1000.0*(benchNow()-start)/trailLength;
+        std::cout << "Frame time (" << modeNames[mode] << "): " << benchTimeFrames(50) << " ms, "
+        << stepMs << " ms per step" << std::endl;
+    }
+}
+
+// Star field: catalog load (map and upload) time, and frame time with and without the stars
+void benchmarkStars(int numStars)
+{
+    benchStartGL();
+    const char* path = "stars-bench.bin";
+    int sizes[2] = {100000, 2000000};
+    int numSizes = 2;
+    if (numStars > 0) { sizes[0] = numStars; numSizes = 1; }
+    for (int k = 0; k < numSizes; k++) {
+        double start = benchNow();
+        StarCatalog::writeSynthetic(path, sizes[k], 2026);
+        std::cout << sizes[k] << " stars: catalog written in " << 1000.0*(benchNow()-start) << " ms" << std::endl;
+        starsDrawn = 0;
+        double without = benchTimeFrames(50);
+        starMagnitudeLimit = 30.0;          // draw every star, however faint
+        start = benchNow();
+        glUseProgram(program[2]);
+        loadStars(path);
+        glUseProgram(program[0]);
+        glFinish();
+        std::cout << "  load: " << 1000.0*(benchNow()-start) << " ms" << std::endl;
+        std::cout << "  frame time: " << without << " ms without stars, " << benchTimeFrames(50) << " ms with" << std::endl;
+    }
+    remove(path);
+}
+
+// Belt and ring particles: build and upload time, and frame time with and without them
+void benchmarkParticles(int numParticles)
+{
+    benchStartGL();
+    int sizes[2] = {1000000, 5000000};
+    int numSizes = 2;
+    if (numParticles > 0) { sizes[0] = numParticles; numSizes = 1; }
+    for (int k = 0; k < numSizes; k++) {
+        double start = benchNow();
+        particleBelts.addDefaultBelts(solarSystem, sizes[k]);
+        double buildMs = 1000.0*(benchNow()-start);
+        start = benchNow();
+        uploadParticles();
+        glFinish();
+        std::cout << particlesDrawn << " particles: built in " << buildMs << " ms, uploaded in "
+        << 1000.0*(benchNow()-start) << " ms" << std::endl;
+        showParticles = GL_FALSE;
+        double without = benchTimeFrames(50);
+        showParticles = GL_TRUE;
+        std::cout << "  frame time: " << without << " ms without particles, " << benchTimeFrames(50)
+        << " ms with (" << 2*sizeof(GLfloat) << " bytes sent per frame)" << std::endl;
+    }
+}
+
+// Object tree on the CPU (updateMontum and uploads) against the GPU (clock only): CPU time per
+// simulation step, and time per animated frame including the GPU
+void benchmarkHierarchy(int numBodies)
+{
+    benchGrowSystem(numBodies > 0 ? numBodies : 100000);
+    benchStartGL();
+    const int frames = 100;
+    for (int mode = 0; mode < 2; mode++) {
+        if (gpuHierarchy != (mode == 1)) toggleGPUHierarchy();
+        double cpuTime = 0.0;
+        double start = benchNow();
+        for (int i = 0; i < frames; i++) {
+            double stepStart = benchNow();
+            modelAnimate(60.0 * simulationSpeed);
+            cpuTime += benchNow()-stepStart;
+            glClear(GL_COLOR_BUFFER_BIT| GL_DEPTH_BUFFER_BIT);
+            drawScene();
+            glfwSwapBuffers(mainWin);
+            glFinish();
+        }
+        std::cout << (gpuHierarchy ? "GPU" : "CPU") << " object tree: " << 1000.0*cpuTime/frames << " ms CPU per step, "
+        << 1000.0*(benchNow()-start)/frames << " ms per frame" << std::endl;
+    }
+}
+
+// Sphere source: generated arrays in vertex and index buffers against the strip built from
+// gl_VertexID. Memory and startup cost of the arrays, then frame time with each.
+void benchmarkSphere(int numBodies)
+{
+    benchGrowSystem(numBodies > 0 ? numBodies : 1000);
+    sphereSpec& spec = solarSystem.s.theSphere;
+    double start = benchNow();
+    solarSystem.s.generate();
+    double generateMs = 1000.0*(benchNow()-start);
+    size_t cpuBytes = spec.vertices.capacity()*sizeof(point3) + spec.norms.capacity()*sizeof(point3) +
+                      spec.stMap.capacity()*sizeof(point2) + spec.indices.capacity()*sizeof(unsigned int) +
+                      spec.verticesCombinedForNorms.capacity()*sizeof(int);
+    size_t gpuBytes = spec.numVertices*(2*sizeof(point3) + sizeof(point2)) + spec.numIndices*sizeof(unsigned int);
+    solarSystem.s.release();
+    std::cout << "Sphere arrays: " << generateMs << " ms to generate, " << cpuBytes << " bytes on the CPU, "
+    << gpuBytes << " bytes in buffers, " << spec.numIndices << " indices in " << spec.bands << " draws" << std::endl;
+    std::cout << "gl_VertexID strip: nothing generated or stored, " << solarSystem.s.stripVertices()
+    << " vertices in 1 draw" << std::endl;
+
+    benchStartGL();
+    start = benchNow();
+    setSphereSource(UVSPHERE);
+    glFinish();
+    std::cout << "Sphere arrays generated and uploaded in " << 1000.0*(benchNow()-start) << " ms" << std::endl;
+    for (int mode = 0; mode < 2; mode++) {
+        setSphereSource(mode == 0 ? UVSPHERE : PROCEDURALSPHERE);
+        std::cout << "Frame time (" << (mode == 0 ? "vertex and index buffers" : "gl_VertexID strip")
+        << "): " << benchTimeFrames(50) << " ms" << std::endl;
+    }
+}
+
+// Sphere models: triangles against greatest distance from the true sphere for each model, then
+// frame time for each with the fewest triangles that are as close as the UV sphere in use
+void benchmarkSphereModels(int numBodies)
+{
+    benchGrowSystem(numBodies > 0 ? numBodies : 1000);
+    solarSystem.s.generate();
+    float target = maxSphereError(solarSystem.s.theSphere);
+    std::cout << "UV sphere " << solarSystem.s.getFans() << "x" << solarSystem.s.getBands() << ": "
+    << solarSystem.s.theSphere.numIndices << " indices, error " << target << std::endl;
+    solarSystem.s.release();
+    for (int n = 16; n <= 160; n *= 2) {
+        BetterSphere uv(n, n, 1.0);
+        uv.generate();
+        std::cout << "  UV sphere " << n << "x" << n << ": " << 2*n*(n-1) << " triangles, error "
+        << maxSphereError(uv.theSphere) << std::endl;
+    }
+    int bestIco = -1, bestCube = -1;
+    for (int level = 1; level <= 7; level++) {
+        double start = benchNow();
+        IcoSphere ico(level);
+        double ms = 1000.0*(benchNow()-start);
+        float error = maxSphereError(ico.theSphere);
+        if (bestIco < 0 && error <= target) bestIco = level;
+        std::cout << "  icosphere " << level << ": " << ico.theSphere.numIndices/3 << " triangles, "
+        << ico.theSphere.numVertices << " vertices, error " << error << ", " << ms << " ms to generate" << std::endl;
+    }
+    const int cubeSizes[8] = {8, 16, 24, 32, 40, 48, 64, 96};
+    for (int k = 0; k < 8; k++) {
+        double start = benchNow();
+        CubeSphere cube(cubeSizes[k]);
+        double ms = 1000.0*(benchNow()-start);
+        float error = maxSphereError(cube.theSphere);
+        if (bestCube < 0 && error <= target) bestCube = cubeSizes[k];
+        std::cout << "  cube-sphere " << cubeSizes[k] << ": " << cube.theSphere.numIndices/3 << " triangles, "
+        << cube.theSphere.numVertices << " vertices, error " << error << ", " << ms << " ms to generate" << std::endl;
+    }
+    std::cout << "As close as the UV sphere: icosphere " << bestIco << ", cube-sphere " << bestCube << std::endl;
+    if (bestIco > 0) icoSubdivisions = bestIco;
+    if (bestCube > 0) cubeDivisions = bestCube;
+
+    benchStartGL();
+    const char* modeNames[numSphereSources] = {"UV sphere, gl_VertexID", "UV sphere", "icosphere", "cube-sphere"};
+    for (int mode = 0; mode < numSphereSources; mode++) {
+        setSphereSource(mode);
+        std::cout << "Frame time (" << modeNames[mode] << "): " << benchTimeFrames(50) << " ms" << std::endl;
+    }
+}
+
+// Impostors: every object as a sphere mesh, the automatic choice at the default threshold, and
+// every object as an impostor. Meshes cost ~2*fans*bands triangles each, impostors two.
+void benchmarkImpostors(int numBodies)
+{
+    benchGrowSystem(numBodies > 0 ? numBodies : 10000);
+    benchStartGL();
+    const GLfloat thresholds[3] = {0.0, impostorRadius, 1.0e9};
+    const char* modeNames[3] = {"meshes only", "automatic", "impostors only"};
+    for (int mode = 0; mode < 3; mode++) {
+        impostorRadius = thresholds[mode];
+        double frameMs = benchTimeFrames(50);
+        std::cout << "Frame time (" << modeNames[mode] << ", under " << impostorRadius << " px): " << frameMs
+        << " ms, " << meshBodies.size() << " meshes and " << impostorBodies.size() << " impostors" << std::endl;
+    }
+    impostorRadius = thresholds[1];
+}
+
+// Transforms: the CompactTransform pipeline against the four-mat4 pipeline it replaced (kept
+// here as a reference), for memory per object and CPU time per simulation step
+void benchmarkTransforms(int numBodies)
+{
+    benchGrowSystem(numBodies > 0 ? numBodies : 100000);
+    int n = solarSystem.numObjects;
+    const int steps = 20;
+    std::vector<matr4> relLocation(n), absLocation(n), modelScale(n), modelOrientation(n), matrixUpload(n);
+    glm::vec3 yAxis(0.0, 1.0, 0.0), zAxis(0.0, 0.0, 1.0);
+    double start = benchNow();
+    for (int step = 0; step < steps; step++) {
+        for (int i = 0; i < n; i++) {
+            AstroObject& obj = solarSystem.montum[i];
+            float angle = obj.currentOrbitAngle + 0.001f*step;
+            relLocation[i] = glm::rotate(matr4(1.0f), angle, yAxis) *
+                             glm::translate(matr4(1.0f), glm::vec3(obj.viewingOrbitRadius(), 0.0, 0.0)) *
+                             glm::rotate(matr4(1.0f), -angle, yAxis);
+        }
+        absLocation[0] = relLocation[0];
+        for (int i = 1; i < n; i++)
+            absLocation[i] = absLocation[solarSystem.parentOf[i]] * relLocation[i];
+        for (int i = 0; i < n; i++) {
+            AstroObject& obj = solarSystem.montum[i];
+            glm::vec3 where = glm::vec3(absLocation[i] * glm::vec4(0.0, 0.0, 0.0, 1.0));
+            modelScale[i] = glm::scale(matr4(1.0f), glm::vec3(obj.viewingRadius()));
+            modelOrientation[i] = glm::translate(matr4(1.0f), where) * glm::rotate(matr4(1.0f), obj.tilt(), zAxis) *
+                                  glm::rotate(matr4(1.0f), obj.currentRotAngle, yAxis) * glm::translate(matr4(1.0f), -where);
+            matrixUpload[i] = modelOrientation[i] * absLocation[i] * modelScale[i];
+        }
+    }
+    double matrixMs = 1000.0*(benchNow()-start)/steps;
+
+    start = benchNow();
+    for (int step = 0; step < steps; step++) {
+        solarSystem.updateMontum(1.0);
+        objTransforms.resize(n);
+        for (int i = 0; i < n; i++) objTransforms[i] = solarSystem.montum[i].modelTransform;
+    }
+    double compactMs = 1000.0*(benchNow()-start)/steps;
+
+    std::cout << "Four mat4s: " << 4*sizeof(matr4) << " bytes of transforms per object, " << sizeof(matr4)
+    << " uploaded; " << matrixMs << " ms per step" << std::endl;
+    std::cout << "CompactTransform: " << 3*sizeof(CompactTransform) << " bytes of transforms per object, "
+    << sizeof(CompactTransform) << " uploaded; " << compactMs << " ms per step (whole updateMontum)" << std::endl;
+    std::cout << "AstroObject is now " << sizeof(AstroObject) << " bytes" << std::endl;
+}
+
+// Bounding volume hierarchy: build, refit and each query type, against a plain scan of every object
+void benchmarkBVHAt(int numBodies)
+{
+    benchGrowSystem(numBodies);
+    solarSystem.updateMontum(60.0);
+    const int queries = 1000;
+    std::vector<glm::vec3> points(queries);
+    for (int q = 0; q < queries; q++)
+        points[q] = solarSystem.montum[rand() % solarSystem.numObjects].currentAbsLocation + glm::vec3(5.0, 5.0, 5.0);
+
+    double start = benchNow();
+    bodyBVH.build(solarSystem);
+    std::cout << "  build: " << 1000.0*(benchNow()-start) << " ms, " << bodyBVH.numNodes() << " nodes" << std::endl;
+    double stepTime = 0.0, refitTime = 0.0;
+    for (int i = 0; i < 10; i++) {
+        start = benchNow();
+        solarSystem.updateMontum(600.0);
+        stepTime += benchNow()-start;
+        start = benchNow();
+        bodyBVH.refit(solarSystem);
+        refitTime += benchNow()-start;
+    }
+    std::cout << "  updateMontum: " << 100.0*stepTime << " ms, refit: " << 100.0*refitTime << " ms per step ("
+    << bodyBVH.rebuilds << " rebuilds)" << std::endl;
+
+    std::vector<int> found;
+    size_t hits = 0;
+    start = benchNow();
+    for (int q = 0; q < queries; q++) { found.clear(); bodyBVH.querySphere(points[q], 20.0, found); hits += found.size(); }
+    double bvhTime = benchNow()-start;
+    start = benchNow();
+    size_t scanHits = 0;
+    for (int q = 0; q < queries; q++)
+        for (int i = 0; i < solarSystem.numObjects; i++) {
+            float reach = 20.0 + solarSystem.montum[i].viewingRadius();
+            glm::vec3 d = solarSystem.montum[i].currentAbsLocation - points[q];
+            if (glm::dot(d, d) <= reach*reach) scanHits++;
+        }
+    std::cout << "  sphere overlap: " << 1000.0*bvhTime/queries << " ms (scan " << 1000.0*(benchNow()-start)/queries
+    << " ms), " << hits << "/" << scanHits << " hits" << std::endl;
+
+    start = benchNow();
+    for (int q = 0; q < queries; q++) { found.clear(); bodyBVH.kNearest(points[q], 8, found); }
+    std::cout << "  8 nearest: " << 1000.0*(benchNow()-start)/queries << " ms" << std::endl;
+
+    glm::vec3 eye = glm::vec3(0.0, 3000.0, 0.0);
+    float tHit;
+    int rayHits = 0;
+    start = benchNow();
+    for (int q = 0; q < queries; q++)
+        if (bodyBVH.raycast(eye, glm::normalize(points[q] - eye), tHit) >= 0) rayHits++;
+    bvhTime = benchNow()-start;
+    start = benchNow();
+    for (int q = 0; q < queries; q++) {
+        glm::vec3 dir = glm::normalize(points[q] - eye);
+        float best = 1.0e30;
+        for (int i = 0; i < solarSystem.numObjects; i++) {
+            float t = raySphere(eye, dir, solarSystem.montum[i].currentAbsLocation, solarSystem.montum[i].viewingRadius());
+            if (t >= 0.0 && t < best) best = t;
+        }
+    }
+    std::cout << "  ray: " << 1000.0*bvhTime/queries << " ms (scan " << 1000.0*(benchNow()-start)/queries
+    << " ms), " << rayHits << " hits" << std::endl;
+
+    matr4 viewProj = glm::perspective(frFOV,frAspect,frNear,frFar) *
+                     glm::lookAt(euclidSpherical(camEyeR,camEyeθ,camEyeφ),camAt,camUp);
+    start = benchNow();
+    for (int q = 0; q < 10; q++) { found.clear(); bodyBVH.queryFrustum(viewProj, found); }
+    std::cout << "  frustum: " << 100.0*(benchNow()-start) << " ms, " << found.size() << " visible" << std::endl;
+}
+void benchmarkBVH(int numBodies)
+{
+    if (numBodies > 0) { benchmarkBVHAt(numBodies); return; }
+    benchmarkBVHAt(10000);
+    benchmarkBVHAt(1000000);
+}
+
+// Picking: cursor-to-object latency through the BVH, against casting the same rays at every object
+void benchmarkPicking(int numBodies)
+{
+    benchGrowSystem(numBodies > 0 ? numBodies : 100000);
+    solarSystem.updateMontum(60.0);
+    bodyBVH.build(solarSystem);
+    computeCameraMatrices();
+
+    const int picks = 10000;
+    std::vector<glm::dvec2> cursor(picks);
+    for (int i = 0; i < picks; i++)
+        cursor[i] = glm::dvec2(double(rand() % mainWinWidth), double(rand() % mainWinHeight));
+    double worst = 0.0, total = 0.0;
+    int hits = 0;
+    for (int i = 0; i < picks; i++) {
+        double start = benchNow();
+        if (pickObject(cursor[i].x, cursor[i].y) >= 0) hits++;
+        double took = benchNow()-start;
+        total += took;
+        worst = std::max(worst, took);
+    }
+    std::cout << "Pick latency: " << 1.0e6*total/picks << " us mean, " << 1.0e6*worst << " us worst, "
+    << hits << "/" << picks << " picks hit an object" << std::endl;
+
+    const int scans = 100;
+    matr4 inverseViewProj = glm::inverse(projMatrix * modelvMatrix);
+    double start = benchNow();
+    for (int i = 0; i < scans; i++) {
+        point4 nearPoint = inverseViewProj * point4(2.0*cursor[i].x/mainWinWidth - 1.0, 1.0 - 2.0*cursor[i].y/mainWinHeight, -1.0, 1.0);
+        point4 farPoint = inverseViewProj * point4(2.0*cursor[i].x/mainWinWidth - 1.0, 1.0 - 2.0*cursor[i].y/mainWinHeight, 1.0, 1.0);
+        point3 rayStart = point3(nearPoint) / nearPoint.w;
+        point3 rayDir = glm::normalize(point3(farPoint) / farPoint.w - rayStart);
+        float best = 1.0e30;
+        for (int k = 0; k < solarSystem.numObjects; k++) {
+            float t = raySphere(rayStart, rayDir, solarSystem.montum[k].currentAbsLocation, solarSystem.montum[k].viewingRadius());
+            if (t >= 0.0 && t < best) best = t;
+        }
+    }
+    std::cout << "Scan of every object: " << 1.0e6*(benchNow()-start)/scans << " us per pick" << std::endl;
+}
+
+// a little arithmetic per task, standing in for a frame's batch on the shared pool
+class BenchBusyJob : public PoolJob
+{
+public:
+    std::vector<double> sums;
+    void run(int task)
+    {
+        double sum = 0.0;
+        for (int i = 1; i < 20000; i++) sum += sqrt(double(i + task));
+        sums[task] = sum;
+    }
+};
+// Event search: a year of eclipses, transits and close approaches, on one thread and on all of them;
+// then in the background, as 'e' runs it, while this thread runs batches of its own on the same pool
+void benchmarkEvents(int numBodies)
+{
+    benchGrowSystem(numBodies > 0 ? numBodies : 100);
+    const double year = 365.25*24.0*60.0;
+    EventFinder single(1);
+    double start = benchNow();
+    std::vector<AstroEvent> events = single.search(solarSystem, year);
+    double singleTime = benchNow()-start;
+    std::cout << "Pairs: " << single.pairsConsidered << " considered, " << single.pairsPruned << " pruned by distance" << std::endl;
+    std::cout << "1 thread: " << 1000.0*singleTime << " ms, " << events.size() << " events" << std::endl;
+
+    start = benchNow();
+    events = eventFinder.search(solarSystem, year);
+    double allTime = benchNow()-start;
+    std::cout << eventFinder.threads() << " threads: " << 1000.0*allTime << " ms, " << events.size()
+    << " events (" << singleTime/allTime << "x)" << std::endl;
+
+    BenchBusyJob busy;
+    busy.sums.resize(64);
+    std::vector<AstroEvent> background;
+    int batches = 0;
+    double longest = 0.0;
+    start = benchNow();
+    eventFinder.startSearch(solarSystem, year);
+    while (!eventFinder.searchFinished(background)) {
+        double batchStart = benchNow();
+        acquirePool(-1)->runAll(busy, int(busy.sums.size()));
+        longest = std::max(longest, benchNow() - batchStart);
+        batches++;
+    }
+    std::cout << "In the background: " << 1000.0*(benchNow()-start) << " ms, " << background.size() << " events ("
+    << (background.size() == events.size() ? "the same" : "DIFFERENT") << "); " << batches
+    << " batches run meanwhile, the longest " << 1000.0*longest << " ms" << std::endl;
+}
+
+// Overview inset: frame time without and with it, and the CPU time spent issuing it
+void benchmarkOverview(int numBodies)
+{
+    benchGrowSystem(numBodies > 0 ? numBodies : 10000);
+    benchStartGL();
+    overviewStale = GL_TRUE;
+    showOverview = GL_FALSE;
+    double withoutMs = benchTimeFrames(50);
+    showOverview = GL_TRUE;
+    double withMs = benchTimeFrames(50);
+    const int calls = 200;
+    glFinish();
+    double start = benchNow();
+    for (int i = 0; i < calls; i++) drawOverview();
+    double issueMs = 1000.0*(benchNow()-start)/calls;
+    glFinish();
+    std::cout << "Frame time without the overview: " << withoutMs << " ms, with it: " << withMs << " ms ("
+    << 100.0*(withMs-withoutMs)/withoutMs << "% more); issuing it takes " << issueMs << " ms of CPU" << std::endl;
+}
+
+// HUD: the CPU time per frame to format the panel and find what changed, with nothing changing
+// and with the clock moving every frame, against building the same text as std::strings (as the
+// window title once was); then the frame time with and without the panel drawn.
+void benchmarkHud(int frames)
+{
+    if (frames <= 0) frames = 100000;
+    int first, count, sent = 0;
+    updateHud();
+    hudText.takeChanged(first, count);
+    double start = benchNow();
+    for (int i = 0; i < frames; i++) {
+        updateHud();
+        if (hudText.takeChanged(first, count)) sent += count;
+    }
+    double steadyUs = 1.0e6*(benchNow()-start)/frames;
+    int steadySent = sent;
+    sent = 0;
+    start = benchNow();
+    for (int i = 0; i < frames; i++) {
+        simulationMinutes += 1.0;
+        updateHud();
+        if (hudText.takeChanged(first, count)) sent += count;
+    }
+    double tickingUs = 1.0e6*(benchNow()-start)/frames;
+    size_t length = 0;
+    start = benchNow();
+    for (int i = 0; i < frames; i++) {
+        std::string text = "DAY " + std::to_string(long(simulationMinutes + i) / (24*60)) + " SPEED "
+        + std::to_string(simulationSpeed/pauseLength) + " SCALE " + std::to_string(solarSystem.currentScaleFactor());
+        length += text.size();
+    }
+    double stringUs = 1.0e6*(benchNow()-start)/frames;
+    std::cout << "Updating the HUD: " << steadyUs << " us per frame unchanged (" << steadySent
+    << " glyphs sent), " << tickingUs << " us with the clock moving (" << double(sent)/frames
+    << " glyphs sent per frame); as std::strings: " << stringUs << " us (" << length/frames << " characters)" << std::endl;
+
+    benchStartGL();
+    showOverview = GL_FALSE;
+    showHud = GL_FALSE;
+    double withoutMs = benchTimeFrames(100);
+    showHud = GL_TRUE;
+    double withMs = benchTimeFrames(100);
+    std::cout << "Frame time without the HUD: " << withoutMs << " ms, with it: " << withMs << " ms (one draw of "
+    << HudText::maxLines*HudText::maxColumns << " glyph cells)" << std::endl;
+}
+
+// Input: the cost of queueing and taking mouse events, then input-to-present latency with the
+// camera latched late (after the model's step, just before drawing) and early (before the step,
+// as it once was). Each frame a scroll arrives halfway through the step, which takes a while with
+// 'numBodies' objects; latched early, it waits for the next frame.
+void benchmarkInput(int numBodies)
+{
+    const int events = 1000000;
+    InputEvent event = {0.0, CURSORMOVED, 0.0, 0.0, 0, 0};
+    double start = benchNow();
+    for (int i = 0; i < events; i++) {
+        event.x = i;
+        inputQueue.push(event);
+        if (inputQueue.waiting() == 8)
+            while (inputQueue.pop(event)) {}
+    }
+    while (inputQueue.pop(event)) {}
+    std::cout << "Queueing and taking an input event: " << 1.0e9*(benchNow()-start)/events << " ns" << std::endl;
+
+    benchGrowSystem(numBodies > 0 ? numBodies : 100000);
+    benchStartGL();
+    for (int late = 0; late < 2; late++) {
+        inputLatency = LatencyTracker();
+        for (int frame = 0; frame < 100; frame++) {
+            glClear(GL_COLOR_BUFFER_BIT| GL_DEPTH_BUFFER_BIT);
+            if (!late) {
+                processInput();
+                updateCamera();
+                latchInputTiming();
+            }
+            double stepStart = glfwGetTime();
+            modelAnimate(60.0 * simulationSpeed);
+            InputEvent scroll = {0.5*(stepStart + glfwGetTime()), SCROLLED, 0.0, (frame % 2) ? 1.0 : -1.0, 0, 0};
+            inputQueue.push(scroll);
+            if (late)
+                latchAndDraw();
+            else {
+                drawScene();
+                submitInputTiming();
+            }
+            glfwSwapBuffers(mainWin);
+            collectInputTiming();
+        }
+        glFinish();
+        collectInputTiming();
+        LatencySample mean = inputLatency.mean(), worst = inputLatency.worst();
+        std::cout << "Camera latched " << (late ? "late " : "early") << ": input to latch / submit / GPU done, mean "
+        << 1000.0*mean.toLatch << " / " << 1000.0*mean.toSubmit << " / " << 1000.0*mean.toPresent << " ms, worst "
+        << 1000.0*worst.toLatch << " / " << 1000.0*worst.toSubmit << " / " << 1000.0*worst.toPresent << " ms ("
+        << inputLatency.count() << " frames)" << std::endl;
+    }
+}
+
+// Pacing: first with no window, a 60 Hz loop whose frames each take 'workMs' of CPU, paced by
+// sleeping alone (spinMargin 0) and by sleeping then spinning, then unpaced: how steady the frames
+// are and how much CPU they take. Then real frames, unpaced, paced to 60, and paused and still
+// (waiting on events): frames drawn and the CPU and GPU they used.
+double benchPacedLoop(FramePacer& pacer, double seconds, double workMs)
+{
+    double end = benchNow() + seconds;
+    pacer.restart();
+    while (benchNow() < end) {
+        double busy = benchNow() + 0.001*workMs;
+        while (benchNow() < busy) {}
+        pacer.waitForNextFrame();
+    }
+    return pacer.report.meanFrame;
+}
+void benchmarkPacing(int workMs)
+{
+    if (workMs <= 0) workMs = 5;
+    const char* names[3] = {"sleep only", "sleep and spin", "unpaced"};
+    for (int way = 0; way < 3; way++) {
+        FramePacer pacer(way == 2 ? 0.0 : 60.0);
+        if (way == 0) pacer.spinMargin = 0.0;
+        benchPacedLoop(pacer, 2.2, workMs);
+        std::cout << names[way] << ": " << pacer.report.frames << " frames per second, " << 1000.0*pacer.report.meanFrame
+        << " ms mean, " << 1000.0*pacer.report.deviation << " ms deviation, " << 1000.0*pacer.report.worstFrame
+        << " ms worst, CPU " << 100.0*pacer.report.cpuUse << "%" << std::endl;
+    }
+
+    benchStartGL();
+    const char* modes[3] = {"unpaced", "paced to 60", "paused and still"};
+    for (int mode = 0; mode < 3; mode++) {
+        framePacer.targetRate = (mode == 0) ? 0.0 : 60.0;
+        simulationPaused = (mode == 2);
+        framePacer.window = 2.0;
+        int drawn = 0;
+        double end = benchNow() + 2.2;
+        framePacer.restart();
+        while (benchNow() < end) {
+            if (sceneIsStill()) {
+                glfwWaitEventsTimeout(idleTimeout);
+                framePacer.restart();
+                continue;
+            }
+            redrawNeeded = GL_FALSE;
+            beginGPUTiming();
+            glClear(GL_COLOR_BUFFER_BIT| GL_DEPTH_BUFFER_BIT);
+            animateIfDue();
+            latchAndDraw();
+            endGPUTiming();
+            glfwSwapBuffers(mainWin);
+            collectGPUTiming();
+            drawn++;
+            framePacer.waitForNextFrame();
+        }
+        std::cout << modes[mode] << ": " << drawn << " frames drawn in 2.2 s; last report: CPU "
+        << 100.0*framePacer.report.cpuUse << "%, GPU " << 100.0*framePacer.report.gpuUse << "%, "
+        << 1000.0*framePacer.report.deviation << " ms deviation" << std::endl;
+        redrawNeeded = GL_TRUE;
+    }
+}
+
+// Systems: 'count' other star systems (300 by default) built, then stepped: on one thread with
+// every system every step, on the pool with every system every step, and on the pool with far and
+// unseen systems at reduced cadence, seen from where the camera starts. The sphere they would all
+// draw is the one AstroGroup::s.
+void benchmarkSystems(int count)
+{
+    if (count <= 0) count = 300;
+    computeCameraMatrices();
+    const char* ways[3] = {"one thread, every system", "pool, every system", "pool, reduced cadence"};
+    for (int way = 0; way < 3; way++) {
+        SceneManager scene(way == 0 ? 0 : -1);
+        double start = benchNow();
+        scene.addSyntheticSystems(count, 3000.0, 9000.0, solarSystem.currentScaleFactor(), 1);
+        double buildMs = 1000.0*(benchNow()-start);
+        scene.reducedCadence = (way == 2) ? GL_TRUE : GL_FALSE;
+        scene.step(60.0, camEye, projMatrix * modelvMatrix);
+        const int steps = 64;
+        long objectsStepped = 0;
+        start = benchNow();
+        for (int i = 0; i < steps; i++) {
+            scene.step(60.0, camEye, projMatrix * modelvMatrix);
+            objectsStepped += scene.lastObjectsStepped;
+        }
+        double stepMs = 1000.0*(benchNow()-start)/steps;
+        if (way == 0)
+            std::cout << count << " systems, " << scene.totalObjects() << " objects, built in " << buildMs
+            << " ms; " << scene.transforms.size() << " objects in view; one shared sphere of "
+            << AstroGroup::s.stripVertices() << " vertices" << std::endl;
+        std::cout << ways[way] << " (" << scene.threads() << " threads): " << stepMs << " ms per step, "
+        << objectsStepped/steps << " objects stepped per step, " << scene.stolen() << " tasks stolen" << std::endl;
+    }
+}
+
+// Bodies added and removed at run time: the cost of each, of stepping afterwards, and of rebuilding
+// a packed vector (as before BodyPool) for each change instead. Then checks that nothing moved, that
+// removed objects' handles went stale, and that the tree still holds exactly the live objects.
+bool benchmarkBodies(int numBodies)
+{
+    benchGrowSystem(numBodies > 0 ? numBodies : 100000);
+    const int steps = 20, changes = 2000;
+    double start = benchNow();
+    for (int step = 0; step < steps; step++) solarSystem.updateMontum(1.0);
+    double stepBeforeMs = 1000.0*(benchNow()-start)/steps;
+
+    srand(44);
+    std::vector<BodyHandle> kept, removed;
+    std::vector<AstroObject*> keptAt;
+    for (int k = 0; k < 1000; k++) {
+        int slot = rand() % solarSystem.numObjects;
+        kept.push_back(solarSystem.montum.handle(slot));
+        keptAt.push_back(&solarSystem.montum[slot]);
+    }
+    int slotsBefore = solarSystem.numObjects;
+    double removeSeconds = 0.0, addSeconds = 0.0;
+    long removedObjects = 0;
+    for (int c = 0; c < changes; c++) {
+        int slot = 1 + rand() % (solarSystem.numObjects - 1);
+        if (solarSystem.alive(slot)) {
+            removed.push_back(solarSystem.montum.handle(slot));
+            double t = benchNow();
+            removedObjects += solarSystem.removeObject(slot);
+            removeSeconds += benchNow() - t;
+        }
+        int parent = rand() % solarSystem.numObjects;
+        if (!solarSystem.alive(parent)) parent = 0;
+        AstroObject craft("C" + std::to_string(c), 50.0, 0.0, 9999.0, 1.0e6, 0.01, solarSystem.currentScaleFactor());
+        double t = benchNow();
+        solarSystem.addObject(craft, parent);
+        addSeconds += benchNow() - t;
+    }
+    size_t changedSlots = solarSystem.changedSlots.size();
+    solarSystem.changedSlots.clear();
+
+    start = benchNow();
+    for (int step = 0; step < steps; step++) solarSystem.updateMontum(1.0);
+    double stepAfterMs = 1000.0*(benchNow()-start)/steps;
+
+    // what one change cost before: copy the live objects into a packed vector and link it again
+    start = benchNow();
+    std::vector<AstroObject> packed;
+    packed.reserve(solarSystem.montum.count());
+    std::vector<int> packedIndex(solarSystem.numObjects, -1);
+    for (size_t k = 0; k < solarSystem.order.size(); k++) {
+        if (!solarSystem.montum.valid(solarSystem.order[k])) continue;
+        packedIndex[solarSystem.order[k].slot] = int(packed.size());
+        packed.push_back(solarSystem.montum[solarSystem.order[k].slot]);
+    }
+    std::vector<int> lastChild(packed.size(), -1);
+    for (size_t i = 0; i < packed.size(); i++) {
+        packed[i].leftmostChild = packed[i].rightSibling = NULL;
+        int p = solarSystem.parentOf[packed[i].index];
+        if (p < 0) continue;
+        int pi = packedIndex[p];
+        if (lastChild[pi] < 0) packed[pi].leftmostChild = &packed[i];
+        else packed[lastChild[pi]].rightSibling = &packed[i];
+        lastChild[pi] = int(i);
+    }
+    double rebuildMs = 1000.0*(benchNow()-start);
+
+    int moved = 0, stale = 0, reachable = 0, misplaced = 0;
+    for (size_t k = 0; k < kept.size(); k++)
+        if (solarSystem.montum.valid(kept[k]) && solarSystem.montum.find(kept[k]) != keptAt[k]) moved++;
+    for (size_t k = 0; k < removed.size(); k++)
+        if (solarSystem.montum.find(removed[k]) == NULL) stale++;
+    std::vector<AstroObject*> pending(1, &solarSystem.montum[0]);
+    while (!pending.empty()) {
+        AstroObject* node = pending.back();
+        pending.pop_back();
+        reachable++;
+        int p = solarSystem.parentOf[node->index];
+        if (p >= 0 && glm::length(node->absLocation.translation -
+                                  (solarSystem.montum[p].absLocation * node->relLocation).translation) > 1.0e-3)
+            misplaced++;
+        for (AstroObject* child = node->leftmostChild; child != NULL; child = child->rightSibling)
+            pending.push_back(child);
+    }
+    size_t slotBytes = sizeof(glm::vec2) + 2*sizeof(glm::vec4);     // orbit and body parameters
+    std::cout << changes << " adds and " << removed.size() << " removals (" << removedObjects << " objects with what orbited them): "
+    << 1.0e6*addSeconds/changes << " us per add, " << 1.0e6*removeSeconds/std::max<size_t>(1, removed.size()) << " us per removal" << std::endl;
+    std::cout << "Slots: " << slotsBefore << " before, " << solarSystem.numObjects << " after, " << solarSystem.montum.count()
+    << " objects live in " << solarSystem.montum.chunkCount() << " chunks of " << BodyPool<AstroObject>::chunkSize << std::endl;
+    std::cout << "Step: " << stepBeforeMs << " ms before, " << stepAfterMs << " ms after" << std::endl;
+    std::cout << "Packed vector rebuilt and linked again instead: " << rebuildMs << " ms per change" << std::endl;
+    std::cout << "GPU parameters sent per change: " << double(changedSlots*slotBytes)/(changes + removed.size())
+    << " bytes for its slots, against " << double(solarSystem.numObjects)*slotBytes/1024.0 << " KB sent whole" << std::endl;
+    bool passed = moved == 0 && stale == int(removed.size()) && reachable == int(solarSystem.montum.count()) && misplaced == 0;
+    std::cout << "Checks: " << moved << " kept objects moved, " << stale << " of " << removed.size()
+    << " removed handles stale, " << reachable << " objects in the tree of " << solarSystem.montum.count() << " live, "
+    << misplaced << " misplaced: " << (passed ? "passed" : "FAILED") << std::endl;
+    return passed;
+}
+
+// Snapshots: save and restore times at this size, against building the same objects from scratch;
+// then the round trip: the restored group saved again must give the same bytes, hold the same
+// handles, and step to the same places as the one it was saved from.
+bool benchmarkSnapshot(int numBodies)
+{
+    int n = numBodies > 0 ? numBodies : 1000000;
+    double start = benchNow();
+    benchGrowSystem(n);
+    double buildMs = 1000.0*(benchNow()-start);
+    solarSystem.updateMontum(12345.0);
+    srand(45);
+    std::vector<BodyHandle> kept, removed;
+    for (int c = 0; c < 100; c++) {
+        int slot = 1 + rand() % (solarSystem.numObjects - 1);
+        if (solarSystem.alive(slot)) {
+            removed.push_back(solarSystem.montum.handle(slot));
+            solarSystem.removeObject(slot);
+        }
+        kept.push_back(solarSystem.montum.handle(solarSystem.addObject(
+            AstroObject("C" + std::to_string(c), 50.0, 0.0, 9999.0, 1.0e6, 0.01, solarSystem.currentScaleFactor()), 0)));
+    }
+    SnapshotScene scene;
+    memset((void*) &scene, 0, sizeof(scene));
+    scene.simulationMinutes = 12345.0;
+    scene.simulationSpeed = 2.5;
+    scene.camEyeR = camEyeR;
+
+    const char* path = "bench.snap";
+    const char* again = "bench2.snap";
+    start = benchNow();
+    bool saved = Snapshot::save(path, solarSystem, scene);
+    double saveMs = 1000.0*(benchNow()-start);
+    AstroGroup restored(solarSystem.currentScaleFactor());
+    start = benchNow();
+    Snapshot snapshot;
+    bool opened = saved && snapshot.open(path);
+    if (opened) snapshot.restore(restored);
+    double restoreMs = 1000.0*(benchNow()-start);
+    if (!opened) {
+        std::cout << "Snapshot: could not " << (saved ? "open " : "save ") << path << ": FAILED" << std::endl;
+        unlink(path);
+        return false;
+    }
+    double megabytes = Snapshot::fileSize(solarSystem) / 1048576.0;
+    std::cout << "Snapshot of " << solarSystem.montum.count() << " objects (" << solarSystem.numObjects << " slots): "
+    << megabytes << " MB; saved in " << saveMs << " ms, restored in " << restoreMs << " ms; built from scratch in "
+    << buildMs << " ms" << std::endl;
+
+    Snapshot::save(again, restored, snapshot.scene());
+    std::ifstream a(path, std::ios::binary), b(again, std::ios::binary);
+    std::vector<char> first((std::istreambuf_iterator<char>(a)), std::istreambuf_iterator<char>());
+    std::vector<char> second((std::istreambuf_iterator<char>(b)), std::istreambuf_iterator<char>());
+    int handlesKept = 0, handlesStale = 0;
+    for (size_t k = 0; k < kept.size(); k++)
+        if (restored.montum.valid(kept[k]) == solarSystem.montum.valid(kept[k])) handlesKept++;
+    for (size_t k = 0; k < removed.size(); k++)
+        if (!restored.montum.valid(removed[k])) handlesStale++;
+    solarSystem.updateMontum(5000.0);
+    restored.updateMontum(5000.0);
+    float furthest = 0.0;
+    for (int i = 0; i < solarSystem.numObjects; i++)
+        if (solarSystem.alive(i))
+            furthest = std::max(furthest, glm::length(solarSystem.montum[i].currentAbsLocation -
+                                                      restored.montum[i].currentAbsLocation));
+    bool same = first == second && handlesKept == int(kept.size()) && handlesStale == int(removed.size())
+                && furthest == 0.0 && snapshot.scene().simulationSpeed == scene.simulationSpeed;
+    std::cout << "Round trip: saved again " << (first == second ? "byte for byte the same" : "DIFFERENT") << ", "
+    << handlesKept << "/" << kept.size() << " handles kept, " << handlesStale << "/" << removed.size()
+    << " removed ones stale, " << furthest << " apart after stepping: " << (same ? "passed" : "FAILED") << std::endl;
+    snapshot.close();
+    unlink(path);
+    unlink(again);
+    return same;
+}
+
+// The live feed: the cost of writing it each step at this size; then readers in other processes
+// (forked), one, two and four at once, each reading whole frames for a second while the writer writes
+// frames as fast as it can. Every value of a frame the writer writes is the same, so a reader that
+// ever kept a frame with two different values in it would have kept a torn one. Half the readers
+// copy frames out (read), half scan them in place (begin ... stillValid). Last, the writer outgrows
+// its segment and a reader must follow it to the new one.
+struct FeedReaderResult
+{
+    long reads, frames, retries, torn, reopened;
+    double latencySumUs, latencyWorstUs;
+};
+void feedReaderProcess(const char* name, bool inPlace, int64_t until, int out)
+{
+    FeedReaderResult r;
+    memset((void*) &r, 0, sizeof(r));
+    LiveFeedReader reader;
+    LiveFeedFrame frame;
+    uint64_t lastStep = 0;
+    while (!reader.open(name) && liveFeedNow() < until) std::this_thread::yield();
+    while (liveFeedNow() < until) {
+        uint64_t step;
+        bool torn = false;
+        if (inPlace) {
+            uint64_t sequence;
+            if (!reader.begin(sequence)) continue;
+            const LiveFeedHeader& h = reader.frame();
+            step = h.step;
+            uint32_t count = h.count;
+            int64_t published = h.publishedNanoseconds;
+            float first = reader.array(0)[0];
+            for (int a = 0; a < numFeedArrays; a++) {
+                const float* values = reader.array(a);
+                for (uint32_t i = 0; i < count; i++) torn = torn || values[i] != first;
+            }
+            if (!reader.stillValid(sequence)) {
+                reader.retries++;
+                continue;
+            }
+            frame.publishedNanoseconds = published;
+        }
+        else {
+            if (!reader.read(frame)) continue;
+            step = frame.step;
+            for (int a = 0; a < numFeedArrays; a++)
+                for (uint32_t i = 0; i < frame.count; i++) torn = torn || frame.arrays[a][i] != frame.arrays[0][0];
+        }
+        r.reads++;
+        if (torn) r.torn++;
+        if (step != lastStep) {
+            double latency = 1.0e-3*double(liveFeedNow() - frame.publishedNanoseconds);
+            r.frames++;
+            r.latencySumUs += latency;
+            r.latencyWorstUs = std::max(r.latencyWorstUs, latency);
+            lastStep = step;
+        }
+    }
+    r.retries = reader.retries;
+    r.reopened = reader.reopened;
+    if (write(out, &r, sizeof(r)) != ssize_t(sizeof(r))) _exit(1);
+    _exit(0);
+}
+bool benchmarkFeed(int numBodies)
+{
+    benchGrowSystem(numBodies > 0 ? numBodies : 100000);
+    const char* name = "/astronomicalmodel-bench";
+    if (!liveFeed.open(name, uint32_t(solarSystem.numObjects))) {
+        std::cout << "Feed: could not open " << name << ": FAILED" << std::endl;
+        return false;
+    }
+    const int steps = 50;
+    double stepSeconds = 0.0, publishSeconds = 0.0;
+    for (int s = 0; s < steps; s++) {
+        double start = benchNow();
+        solarSystem.updateMontum(60.0);
+        hierarchyEpoch += 60.0;
+        double mid = benchNow();
+        publishFeed();
+        stepSeconds += mid - start;
+        publishSeconds += benchNow() - mid;
+    }
+    std::cout << "Feed of " << solarSystem.numObjects << " objects (" << liveFeedSize(liveFeed.capacity())/1048576.0
+    << " MB): written in " << 1000.0*publishSeconds/steps << " ms per step, against " << 1000.0*stepSeconds/steps
+    << " ms for the step itself" << std::endl;
+
+    uint32_t count = uint32_t(solarSystem.numObjects);
+    long tornFrames = 0, starved = 0;
+    int counts[] = {1, 2, 4};
+    for (int run = 0; run < 6; run++) {
+        int readers = counts[run/2];
+        int64_t interval = run % 2 == 0 ? 1000000000/60 : 0;     // a step each 60th of a second, or flat out
+        int64_t until = liveFeedNow() + 1000000000;
+        std::vector<pid_t> children;
+        std::vector<int> pipes;
+        for (int k = 0; k < readers; k++) {
+            int ends[2];
+            if (pipe(ends) != 0) {
+                std::cout << "Feed: no pipe for reader " << k << ": FAILED" << std::endl;
+                liveFeed.close();
+                return false;
+            }
+            pid_t child = fork();
+            if (child == 0) {
+                ::close(ends[0]);
+                feedReaderProcess(name, k % 2 == 1, until, ends[1]);
+            }
+            ::close(ends[1]);
+            children.push_back(child);
+            pipes.push_back(ends[0]);
+        }
+        long written = 0;
+        int64_t next = liveFeedNow();
+        while (liveFeedNow() < until) {
+            liveFeed.beginFrame(count);
+            float marker = float(written % 1000 + 1);
+            for (int a = 0; a < numFeedArrays; a++) {
+                float* values = liveFeed.array(a);
+                for (uint32_t i = 0; i < count; i++) values[i] = marker;
+            }
+            liveFeed.endFrame(double(written++));
+            next += interval;
+            while (interval > 0 && liveFeedNow() < std::min(next, until))
+                std::this_thread::sleep_for(std::chrono::nanoseconds(std::min(next, until) - liveFeedNow()));
+        }
+        FeedReaderResult total;
+        memset((void*) &total, 0, sizeof(total));
+        for (int k = 0; k < readers; k++) {
+            FeedReaderResult r;
+            memset((void*) &r, 0, sizeof(r));
+            if (read(pipes[k], &r, sizeof(r)) != ssize_t(sizeof(r))) starved++;
+            ::close(pipes[k]);
+            waitpid(children[k], NULL, 0);
+            if (r.frames == 0) starved++;
+            total.reads += r.reads;
+            total.frames += r.frames;
+            total.retries += r.retries;
+            total.torn += r.torn;
+            total.latencySumUs += r.latencySumUs;
+            total.latencyWorstUs = std::max(total.latencyWorstUs, r.latencyWorstUs);
+        }
+        tornFrames += total.torn;
+        std::cout << readers << " reader(s), writer " << (interval > 0 ? "at 60 steps/s" : "flat out") << ": "
+        << written << " frames written; " << total.frames/readers << " new frames seen and " << total.reads/readers
+        << " whole frames read by each (" << double(total.reads)*count*numFeedArrays*sizeof(float)/1048576.0/readers
+        << " MB/s), " << double(total.retries)/std::max(1L, total.reads) << " retries per read; "
+        << "publish to read " << total.latencySumUs/std::max(1L, total.frames) << " us on average, "
+        << total.latencyWorstUs << " us at worst; " << total.torn << " torn" << std::endl;
+    }
+
+    LiveFeedReader follower;
+    LiveFeedFrame frame;
+    bool followed = follower.open(name) && follower.read(frame);
+    uint32_t grown = liveFeed.capacity() + 1;
+    liveFeed.beginFrame(grown);
+    for (int a = 0; a < numFeedArrays; a++) {
+        float* values = liveFeed.array(a);
+        for (uint32_t i = 0; i < grown; i++) values[i] = 7.0f;
+    }
+    liveFeed.endFrame(0.0);
+    followed = followed && follower.read(frame) && frame.count == grown && follower.reopened == 1 && frame.arrays[FEEDQW][grown-1] == 7.0f;
+    std::cout << "Grown to " << liveFeed.capacity() << " objects: the reader " << (followed ? "followed" : "did NOT follow")
+    << " it to the new segment" << std::endl;
+    follower.close();
+    liveFeed.close();
+    bool passed = tornFrames == 0 && starved == 0 && followed;
+    std::cout << "Checks: " << tornFrames << " torn frames kept, " << starved << " readers with no frame: "
+    << (passed ? "passed" : "FAILED") << std::endl;
+    return passed;
+}
+
+// The embeddable model (AstroModelLib.h), through its C interface: every object at 'times' times a
+// day apart, got by stepping a copy of the group from time to time and reading each object, against
+// one batch query on the caller's thread and one on the pool. The batch must match stepping (to float
+// rounding, which stepping gathers) and must give the same numbers on any number of threads.
+bool benchmarkLibrary(int numBodies)
+{
+    int n = numBodies > 0 ? numBodies : 10000;
+    const int times = 100;
+    AstroModel* model = astroCreate(solarSystem.currentScaleFactor());
+    if (n > model->group.numObjects) model->group.addSyntheticObjects(n - model->group.numObjects, 2026);
+    model->group.changedSlots.clear();
+    astroStep(model, 500.0);
+    std::vector<int> bodies;
+    for (int i = 0; i < astroSlots(model); i++) bodies.push_back(i);
+    std::vector<double> minutes(times);
+    for (int t = 0; t < times; t++) minutes[t] = astroMinutes(model) + 1440.0*(t+1);
+    size_t results = bodies.size() * times;
+    std::cout << "Library: " << bodies.size() << " objects at " << times << " times" << std::endl;
+
+    AstroGroup stepped(model->group);
+    std::vector<glm::vec3> steppedPositions(results);
+    double start = benchNow();
+    for (int t = 0; t < times; t++) {
+        stepped.updateMontum(1440.0);
+        for (size_t b = 0; b < bodies.size(); b++)
+            steppedPositions[t*bodies.size() + b] = stepped.montum[bodies[b]].modelTransform.translation;
+    }
+    double stepMs = 1000.0*(benchNow()-start);
+
+    std::vector<double> serial(3*results), parallel(3*results), orientations(4*results);
+    astroSetThreads(model, 0);
+    start = benchNow();
+    astroPositions(model, &bodies.front(), int(bodies.size()), &minutes.front(), times, 0, &serial.front(), NULL);
+    double serialMs = 1000.0*(benchNow()-start);
+    astroSetThreads(model, -1);
+    astroPositions(model, &bodies.front(), 1, &minutes.front(), 1, 0, &parallel.front(), NULL);   // start the pool
+    start = benchNow();
+    astroPositions(model, &bodies.front(), int(bodies.size()), &minutes.front(), times, 0, &parallel.front(), NULL);
+    double parallelMs = 1000.0*(benchNow()-start);
+    start = benchNow();
+    astroPositions(model, &bodies.front(), int(bodies.size()), &minutes.front(), times, 0, &parallel.front(), &orientations.front());
+    double orientedMs = 1000.0*(benchNow()-start);
+    std::cout << "Stepping and reading: " << stepMs << " ms; batch on 1 thread: " << serialMs << " ms; on "
+    << model->pool->threads() << " threads: " << parallelMs << " ms (" << results/(parallelMs*1000.0)
+    << " M results/s), " << orientedMs << " ms with orientations" << std::endl;
+
+    double furthest = 0.0, extent = 0.0;
+    long differ = 0;
+    for (size_t k = 0; k < results; k++) {
+        glm::dvec3 p(serial[3*k], serial[3*k+1], serial[3*k+2]);
+        furthest = std::max(furthest, glm::length(p - glm::dvec3(steppedPositions[k])));
+        extent = std::max(extent, glm::length(p));
+        for (int c = 0; c < 3; c++) differ += serial[3*k+c] != parallel[3*k+c];
+    }
+    int earth = astroFindObject(model, "Earth"), missing = -1;
+    bool guarded = astroPositions(model, &missing, 1, &minutes.front(), 1, 0, &serial.front(), NULL) == ASTRO_NO_OBJECT
+                   && astroAddObject(model, missing, "X", 1.0, 0.0, 1.0, 1.0, 1.0) == ASTRO_NO_OBJECT
+                   && astroRemoveObject(model, 0) == ASTRO_NO_OBJECT && earth > 0;
+    bool passed = furthest <= 1.0e-4 * extent && differ == 0 && guarded;
+    std::cout << "Checks: batch and stepping at most " << furthest << " apart (" << furthest/extent
+    << " of the system's extent), " << differ << " values differing between 1 and " << model->pool->threads()
+    << " threads, bad arguments " << (guarded ? "refused" : "NOT refused") << ": " << (passed ? "passed" : "FAILED") << std::endl;
+    astroDestroy(model);
+    return passed;
+}
+
+// Scale changes: the CPU time of one change, now that the objects take the new factor in their next
+// step, against the per-object pass and parameter uploads it used to cost; the cost of that next step
+// against an ordinary one; and a check that taking the factor late places every object exactly where
+// rescaling each at once would have, and where the orbits in closed form put it at the new scale.
+// Then (with a GL) the app's own changeScale and the step after it, with the object tree on the CPU
+// and on the GPU: on the GPU neither may step the CPU's copy or send it again.
+bool benchmarkScale(int numBodies)
+{
+    benchGrowSystem(numBodies > 0 ? numBodies : 100000);
+    solarSystem.updateMontum(60.0);
+    const int changes = 1000;
+    double start = benchNow();
+    for (int c = 0; c < changes; c++) solarSystem.adjustScale(c % 2 == 0 ? +0.01 : -0.01);
+    double changeUs = 1.0e6*(benchNow()-start)/changes;
+
+    AstroGroup eager(solarSystem);
+    float newScale = solarSystem.currentScaleFactor() + 0.01;
+    start = benchNow();
+    eager.adjustScale(+0.01);
+    for (int i = 0; i < eager.numObjects; i++) eager.montum[i].rescale(newScale);
+    double eagerMs = 1000.0*(benchNow()-start);
+    size_t uploadBytes = sizeof(glm::vec2)*orbitParamSlots + 2*sizeof(glm::vec4)*bodyParamSlots;
+    if (uploadBytes == 0) uploadBytes = (sizeof(glm::vec2) + 2*sizeof(glm::vec4)) * solarSystem.numObjects;
+
+    start = benchNow();
+    solarSystem.updateMontum(60.0);
+    double stepMs = 1000.0*(benchNow()-start);
+    solarSystem.adjustScale(+0.01);
+    start = benchNow();
+    solarSystem.updateMontum(60.0);
+    double rescaledStepMs = 1000.0*(benchNow()-start);
+    eager.updateMontum(60.0);
+    eager.updateMontum(60.0);
+    std::cout << "One scale change: " << changeUs << " us on the CPU, and nothing sent; each object rescaled at once "
+    << "took " << eagerMs << " ms, with " << uploadBytes/1024.0 << " KB of parameters sent again" << std::endl;
+    std::cout << "Step: " << stepMs << " ms, " << rescaledStepMs << " ms the first after a change" << std::endl;
+
+    OrbitModel orbits;
+    orbits.capture(solarSystem, true);
+    float furthest = 0.0, closedForm = 0.0, extent = 0.0;
+    for (int i = 0; i < solarSystem.numObjects; i++) {
+        if (!solarSystem.alive(i)) continue;
+        point3 p = solarSystem.montum[i].modelTransform.translation;
+        furthest = std::max(furthest, glm::length(p - eager.montum[i].modelTransform.translation));
+        furthest = std::max(furthest, std::fabs(solarSystem.montum[i].modelTransform.scale - eager.montum[i].modelTransform.scale));
+        closedForm = std::max(closedForm, float(glm::length(glm::dvec3(p) - orbits.positionAt(i, 0.0))));
+        extent = std::max(extent, glm::length(p));
+    }
+    bool passed = furthest == 0.0 && closedForm <= 1.0e-4 * extent && !solarSystem.rescaled();
+    std::cout << "Checks: rescaled late and at once " << furthest << " apart, " << closedForm/extent
+    << " of the extent from the orbits in closed form: " << (passed ? "passed" : "FAILED") << std::endl;
+
+    if (!glfwInit()) {
+        std::cout << "changeScale and the step after it: not timed, there is no GL here" << std::endl;
+        return passed;
+    }
+    benchStartGL();
+    simulationPaused = GL_FALSE;
+    const char* modes[2] = {"Object tree on the CPU", "Object tree on the GPU"};
+    bool untouched = false;
+    for (int mode = 0; mode < 2; mode++) {
+        if ((mode == 1) != (gpuHierarchy == GL_TRUE)) toggleGPUHierarchy();
+        double epoch = hierarchyEpoch;
+        glFinish();
+        start = benchNow();
+        changeScale(+0.01);
+        double changeMs = 1000.0*(benchNow()-start);
+        start = benchNow();
+        modelAnimate(60.0);
+        glFinish();
+        double afterMs = 1000.0*(benchNow()-start);
+        // the CPU's copy is stepped (and sent) only by a resync, which moves hierarchyEpoch and takes the scale
+        untouched = solarSystem.rescaled() && hierarchyEpoch == epoch;
+        std::cout << modes[mode] << ": changeScale " << changeMs << " ms, the step after it " << afterMs << " ms";
+        if (mode == 1) std::cout << "; the CPU's copy " << (untouched ? "untouched" : "STEPPED and sent again");
+        std::cout << std::endl;
+    }
+    return passed && untouched;
+}
+
+// Terrain: a descent onto Mars, following it, from thirty radii out to just over its highest
+// ground. At each height the loader is let catch up, then: the patches drawn, the height tiles
+// held, and the CPU time per frame to take tiles and choose patches (with no window), then the
+// whole frame time with one. Chunked LOD keeps the patch count, and so the frame, about level.
+void benchmarkTerrain(int stages)
+{
+    if (stages < 2) stages = 12;
+    int body = 0;
+    for (int i = 0; i < solarSystem.numObjects; i++)
+        if (solarSystem.montum[i].name == "Mars") body = i;
+    selectedObject = body;
+    followSelected = GL_TRUE;
+    camEyeφ = 0.5*M_PI;
+    solarSystem.updateMontum(1.0);
+    shadowCasters.update(solarSystem);
+    GLfloat radius = shadowCasters.spheres[body].w;
+    const double highest = 30.0, lowest = 0.6*planetTerrain.heightScale;    // above the ground, in radii
+    std::vector<TerrainTile> tiles;
+    std::vector<float> sample;
+    double start = benchNow();
+    planetTerrain.readTile(TerrainKey(body, 0, 5, 3, 7), sample);
+    std::cout << "Reading one made-up height tile: " << 1000.0*(benchNow()-start) << " ms ("
+    << planetTerrain.tileBytes() << " bytes; " << planetTerrain.layersInBudget() << " fit the "
+    << (planetTerrain.budgetBytes >> 20) << " MB budget)" << std::endl;
+
+    planetTerrain.start(planetTerrain.layersInBudget());
+    for (int stage = 0; stage < stages; stage++) {
+        double above = highest * pow(lowest/highest, double(stage)/(stages-1));
+        camEyeR = radius * (1.0 + above);
+        computeCameraMatrices();
+        GLfloat pixelsPerUnit = projMatrix[1][1] * halfWinHeight;
+        for (int frame = 0; frame < 5000; frame++) {
+            planetTerrain.takeLoaded(tiles, terrainUploadsPerFrame);
+            planetTerrain.beginFrame(projMatrix * modelvMatrix);
+            planetTerrain.select(body, solarSystem.montum[body].modelTransform, camEye, pixelsPerUnit, terrainPixelError);
+            planetTerrain.endFrame();
+            if (planetTerrain.waitingTiles() == 0 && tiles.empty() && frame > 0) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        const int frames = 200;
+        start = benchNow();
+        for (int frame = 0; frame < frames; frame++) {
+            planetTerrain.takeLoaded(tiles, terrainUploadsPerFrame);
+            planetTerrain.beginFrame(projMatrix * modelvMatrix);
+            planetTerrain.select(body, solarSystem.montum[body].modelTransform, camEye, pixelsPerUnit, terrainPixelError);
+            planetTerrain.endFrame();
+        }
+        std::cout << "At " << above << " radii: " << planetTerrain.patches.size() << " patches, "
+        << planetTerrain.residentTiles() << " tiles held, " << 1000.0*(benchNow()-start)/frames
+        << " ms per frame to choose them" << std::endl;
+    }
+
+    benchStartGL();
+    for (int stage = 0; stage < stages; stage++) {
+        double above = highest * pow(lowest/highest, double(stage)/(stages-1));
+        camEyeR = radius * (1.0 + above);
+        updateCamera();
+        for (int frame = 0; frame < 5000; frame++) {
+            glClear(GL_COLOR_BUFFER_BIT| GL_DEPTH_BUFFER_BIT);
+            drawScene();
+            glfwSwapBuffers(mainWin);
+            if (planetTerrain.waitingTiles() == 0 && frame > 10) break;
+        }
+        double frameMs = benchTimeFrames(50);
+        std::cout << "Frame time at " << above << " radii: " << frameMs << " ms, " << planetTerrain.patches.size()
+        << " patches on " << terrainBodies.size() << " objects" << std::endl;
+    }
+}
+
+// Anti-aliasing: the frame time of each mode against drawing straight into the window, and what
+// its targets take of GPU memory; against that, what the window's own buffers took when it was
+// made with 16 samples and always paid for them.
+void benchmarkAntiAliasing(int numBodies)
+{
+    benchGrowSystem(numBodies > 0 ? numBodies : 1000);
+    benchStartGL();
+    const int modes[][2] = {{0, NOPOST}, {1, NOPOST}, {2, NOPOST}, {3, NOPOST}, {4, NOPOST},
+                            {0, FXAAPOST}, {0, TAAPOST}, {2, FXAAPOST}, {2, TAAPOST}};
+    const int numModes = sizeof(modes)/sizeof(modes[0]);
+    double baseMs = 0.0;
+    for (int m = 0; m < numModes; m++) {
+        antiAliasing.sampleChoice = modes[m][0];
+        antiAliasing.postFilter = modes[m][1];
+        sceneTargetsStale = GL_TRUE;        // made (and reported) by the first frame drawn
+        double frameMs = benchTimeFrames(50);
+        if (m == 0) baseMs = frameMs;
+        std::cout << "Frame time: " << frameMs << " ms (" << 100.0*(frameMs-baseMs)/baseMs << "% more than none)" << std::endl;
+    }
+    double pixels = double(antiAliasing.width) * antiAliasing.height;
+    std::cout << "The window at " << antiAliasing.width << "x" << antiAliasing.height << " has "
+    << pixels*8.0/(1024.0*1024.0) << " MB of colour and depth; with 16 samples it had "
+    << pixels*8.0*16.0/(1024.0*1024.0) << " MB whatever the mode" << std::endl;
+}
+
+// orders objects by their worst position error, greatest first
+struct PositionErrorOrder
+{
+    const std::vector<double>& errors;
+    PositionErrorOrder(const std::vector<double>& e) : errors(e) {}
+    bool operator()(int a, int b) const { return errors[a] > errors[b]; }
+};
+// one path's worst errors and throughput, then the objects it placed worst
+void benchReportPath(const PathErrors& path)
+{
+    int pBody, rBody, oBody, sBody;
+    double p = PathErrors::worst(path.position, pBody), r = PathErrors::worst(path.relativePosition, rBody);
+    double o = PathErrors::worst(path.orbitAngle, oBody), s = PathErrors::worst(path.spinAngle, sBody);
+    std::cout << path.name << ": " << path.throughput()/1.0e6 << " M object-steps/s; worst position " << p << " ("
+    << solarSystem.montum[pBody].name << "), " << r << " of its distance (" << solarSystem.montum[rBody].name << "), orbit angle " << o << " rad (" << solarSystem.montum[oBody].name
+    << "), spin angle " << s << " rad (" << solarSystem.montum[sBody].name << "): "
+    << (path.passed() ? "passed" : "FAILED") << std::endl;
+    std::vector<int> bodies;
+    for (int i = 0; i < int(path.position.size()); i++) bodies.push_back(i);
+    const int shown = std::min(5, int(bodies.size()));
+    std::partial_sort(bodies.begin(), bodies.begin() + shown, bodies.end(), PositionErrorOrder(path.position));
+    for (int k = 0; k < shown; k++) {
+        int b = bodies[k];
+        std::cout << "    " << solarSystem.montum[b].name << ": position " << path.position[b] << ", orbit angle "
+        << path.orbitAngle[b] << ", spin angle " << path.spinAngle[b] << std::endl;
+    }
+}
+// Accuracy against speed: each path that places the objects is run over ten years of the app's
+// 60-minute steps beside ReferenceOrbits, and compared with it every 30 days; each one's worst
+// position, orbit angle and spin angle errors (overall and for its worst objects) are reported with
+// the object-steps of the span it covers per second, and checked against its tolerances. The paths are
+// the CPU's float stepping (updateMontum), the same at the cadence of a far system in SceneManager,
+// the orbits in closed form (OrbitModel, as the library answers batch queries), and, if there is a
+// GL to run it on, the object tree on the GPU with its daily catch-up on the CPU. Replies false if
+// any path is out of tolerance.
+bool benchmarkAccuracy(int numBodies)
+{
+    benchGrowSystem(numBodies > 0 ? numBodies : 1000);
+    int n = solarSystem.numObjects;
+    const double stepMinutes = 60.0;
+    const int steps = int(10.0*365.25*24.0), checkEvery = 30*24;
+    const int cadence = 16;                 // SceneManager's slowest, for systems far off or out of view
+    // the float stepping drifts as its angles take rounding at every step (about 0.02 radians in
+    // ten years), so its limits, and those of the paths that stand in for it, allow that much again;
+    // the closed form works in double and has to agree with the reference almost exactly
+    //                                      position  orbit angle  spin angle
+    const AccuracyTolerance steppedLimit =  {0.05,    0.05,        0.05};
+    const AccuracyTolerance cadenceLimit =  {0.05,    0.05,        0.05};
+    const AccuracyTolerance closedLimit =   {1.0e-6,  1.0e-9,      1.0e-9};
+    const AccuracyTolerance gpuLimit =      {0.05,    0.05,        0.05};
+    PathErrors stepped("CPU steps", steppedLimit, n), cadenced("CPU every 16 steps", cadenceLimit, n);
+    PathErrors closed("closed form", closedLimit, n), gpu("GPU object tree", gpuLimit, n);
+
+    ReferenceOrbits reference;
+    reference.capture(solarSystem);
+    AstroGroup steppedGroup(solarSystem), cadencedGroup(solarSystem);
+    OrbitModel orbits;
+    orbits.capture(solarSystem, true);
+    std::vector<glm::dvec3> where(n), placed(n);
+    std::vector<glm::dquat> facing(n), turned(n);
+    double referenceSeconds = 0.0;
+    for (int s = 1; s <= steps; s++) {
+        double start = benchNow();
+        reference.step(stepMinutes);
+        referenceSeconds += benchNow() - start;
+        start = benchNow();
+        steppedGroup.updateMontum(stepMinutes);
+        stepped.seconds += benchNow() - start;
+        if (s % cadence == 0) {
+            start = benchNow();
+            cadencedGroup.updateMontum(stepMinutes * cadence);
+            cadenced.seconds += benchNow() - start;
+        }
+        start = benchNow();                 // every step, as a path drawn each frame would be
+        for (int i = 0; i < n; i++) {
+            if (!orbits.held[i]) continue;
+            placed[i] = orbits.positionAt(i, s * stepMinutes);
+            turned[i] = orbits.orientationAt(i, s * stepMinutes);
+        }
+        closed.seconds += benchNow() - start;
+        if (s % checkEvery != 0) continue;
+        for (int g = 0; g < 2; g++) {
+            AstroGroup& group = g == 0 ? steppedGroup : cadencedGroup;
+            for (int i = 0; i < n; i++) {
+                where[i] = glm::dvec3(group.montum[i].currentAbsLocation);
+                facing[i] = doubleRotation(group.montum[i].modelTransform.rotation);
+            }
+            (g == 0 ? stepped : cadenced).compare(reference, where, facing);
+        }
+        closed.compare(reference, placed, turned);
+    }
+    int held = solarSystem.montum.count();
+    stepped.evaluations = double(held) * steps;
+    cadenced.evaluations = double(held) * steps;        // the same span, in a sixteenth of the steps
+    closed.evaluations = double(held) * steps;
+    std::cout << "Reference (double): " << held * (steps / referenceSeconds) / 1.0e6 << " M object-steps/s, "
+    << steps << " steps of " << stepMinutes << " minutes" << std::endl;
+    benchReportPath(stepped);
+    benchReportPath(cadenced);
+    benchReportPath(closed);
+    bool passed = stepped.passed() && cadenced.passed() && closed.passed();
+
+    if (!glfwInit()) {
+        std::cout << "GPU object tree: not checked, there is no GL here" << std::endl;
+        return passed;
+    }
+    benchStartGL();
+    reference.capture(solarSystem);         // the app's own group, not stepped until now
+    toggleGPUHierarchy();
+    std::vector<CompactTransform> transforms(n);
+    for (int s = 1; s <= steps; s++) {
+        double start = benchNow();
+        modelAnimate(stepMinutes);
+        if (s % checkEvery != 0) {
+            gpu.seconds += benchNow() - start;
+            reference.step(stepMinutes);
+            continue;
+        }
+        glFinish();
+        gpu.seconds += benchNow() - start;
+        reference.step(stepMinutes);
+        glBindBuffer(GL_TEXTURE_BUFFER, shaderBuffer[4]);
+        glGetBufferSubData(GL_TEXTURE_BUFFER, 0, n * sizeof(CompactTransform), &transforms.front());
+        for (int i = 0; i < n; i++) {
+            where[i] = glm::dvec3(transforms[i].translation);
+            facing[i] = doubleRotation(transforms[i].rotation);
+        }
+        gpu.compare(reference, where, facing);
+    }
+    gpu.evaluations = double(held) * steps;
+    benchReportPath(gpu);
+    return passed && gpu.passed();
+}
+
+int runBenchmark(const char* name, int size)
+{
+    bool failed = false;
+    if (strcmp(name, "shadows") == 0) benchmarkShadows(size);
+    else if (strcmp(name, "bvh") == 0) benchmarkBVH(size);
+    else if (strcmp(name, "picking") == 0) benchmarkPicking(size);
+    else if (strcmp(name, "events") == 0) benchmarkEvents(size);
+    else if (strcmp(name, "orbits") == 0) benchmarkOrbits(size);
+    else if (strcmp(name, "stars") == 0) benchmarkStars(size);
+    else if (strcmp(name, "particles") == 0) benchmarkParticles(size);
+    else if (strcmp(name, "hierarchy") == 0) benchmarkHierarchy(size);
+    else if (strcmp(name, "transforms") == 0) benchmarkTransforms(size);
+    else if (strcmp(name, "impostors") == 0) benchmarkImpostors(size);
+    else if (strcmp(name, "sphere") == 0) benchmarkSphere(size);
+    else if (strcmp(name, "meshes") == 0) benchmarkSphereModels(size);
+    else if (strcmp(name, "terrain") == 0) benchmarkTerrain(size);
+    else if (strcmp(name, "overview") == 0) benchmarkOverview(size);
+    else if (strcmp(name, "hud") == 0) benchmarkHud(size);
+    else if (strcmp(name, "input") == 0) benchmarkInput(size);
+    else if (strcmp(name, "pacing") == 0) benchmarkPacing(size);
+    else if (strcmp(name, "systems") == 0) benchmarkSystems(size);
+    else if (strcmp(name, "bodies") == 0) failed = !benchmarkBodies(size);
+    else if (strcmp(name, "snapshot") == 0) failed = !benchmarkSnapshot(size);
+    else if (strcmp(name, "feed") == 0) failed = !benchmarkFeed(size);
+    else if (strcmp(name, "library") == 0) failed = !benchmarkLibrary(size);
+    else if (strcmp(name, "scale") == 0) failed = !benchmarkScale(size);
+    else if (strcmp(name, "aa") == 0) benchmarkAntiAliasing(size);
+    else if (strcmp(name, "accuracy") == 0) failed = !benchmarkAccuracy(size);
+    else {
+        std::cerr << "Unknown benchmark: " << name << std::endl;
+        return 1;
+    }
+    glfwTerminate();
+    return failed ? 1 : 0;
+}
+/*@@##====--- Benchmarks (END) ---====##@@*/
+
+#endif
@@ -43,6 +43,10 @@ public:
         void changeSpec(int, int);
     int getBands(void);
     int getFans(void);
+    void generate(void);            // fill theSphere's vectors (only the buffered draw path needs them)
+    void release(void);             // free them again, once they are in GPU buffers
+    bool generated(void);
+    GLsizei stripVertices(void);    // vertices in the single strip drawn from gl_VertexID (AstronObjectGLSL.vert)
 };
 void BetterSphere::generateVertices(void)
 {
@@ -83,20 +87,52 @@ BetterSphere::BetterSphere(int inputFans, int inputBands, float inputRadius)
     theSphere.bands = inputBands;
     theSphere.numIndices=2*(fans*bands-fans+bands);
     theSphere.numVertices= fans*(bands-1)+2;
+    thetaIncrem = 2.0*M_PI/fans;     // how much to increment Theta when traversing
+    phiIncrem = M_PI/bands;          // how much to increment Phi when traversing
+    
+    checkParams(fans, bands);
+    // the vertex, index, norm and st arrays wait for generate(): the sphere can be
+    // drawn from its fans and bands alone, with no arrays at all
+};
+void BetterSphere::generate(void)
+{
+    if (generated()) return;
     theSphere.vertices.reserve(theSphere.numVertices);
     theSphere.indices.reserve(theSphere.numIndices);
     theSphere.norms.reserve(theSphere.numVertices);
     theSphere.verticesCombinedForNorms.reserve(theSphere.numVertices);
     theSphere.stMap.reserve(theSphere.numVertices);
-    thetaIncrem = 2.0*M_PI/fans;     // how much to increment Theta when traversing
-    phiIncrem = M_PI/bands;          // how much to increment Phi when traversing
-    
-    checkParams(fans, bands);
     generateVertices();
     generateTextureMapsCoords();
     generateIndices();
     generateNorms();
-};
+}
+void BetterSphere::release(void)
+{
+    std::vector<point3>().swap(theSphere.vertices);
+    std::vector<unsigned int>().swap(theSphere.indices);
+    std::vector<point3>().swap(theSphere.norms);
+    std::vector<int>().swap(theSphere.verticesCombinedForNorms);
+    std::vector<point2>().swap(theSphere.stMap);
+}
+bool BetterSphere::generated(void)
+{
+    return !theSphere.vertices.empty();
+}
+// each band is a strip of 2*(fans+1) vertices (the first column is repeated at the end, with s = 1),
+// plus one repeated vertex at either end to join it to its neighbours with degenerate triangles
+GLsizei BetterSphere::stripVertices(void)
+{
+    return bands*(2*fans+4);
+}
+int BetterSphere::getBands(void)
+{
+    return bands;
+}
+int BetterSphere::getFans(void)
+{
+    return fans;
+}
 void BetterSphere::checkParams(int fans, int bands)
 {
     if (bands <3 || fans < 4)
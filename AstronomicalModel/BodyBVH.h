@@ -0,0 +1,344 @@
+//
+//  BodyBVH.h
+//  AstronomicalModel
+//
+//  Created by Matthew McGuire on 10/19/26.
+//  Copyright (c) 2026 Matthew McGuire. All rights reserved.
+//
+
+#ifndef AstronomicalModel_BodyBVH_h
+#define AstronomicalModel_BodyBVH_h
+
+#include <vector>
+#include <queue>
+#include <algorithm>
+
+/*---  (BEGIN) BodyBVH Class ---*/
+// A bounding volume hierarchy of spheres over every object in an AstroGroup.
+// It follows the object tree: each object is a node whose sphere holds the object
+// and all of its descendants, so a planet and its moons form one subtree. When an
+// object has many children (the Sun, in a large catalog) they are gathered under
+// binary 'grouping' nodes split by position.
+//
+// refit() recomputes every sphere bottom-up each step without changing the tree.
+// Because orbiting bodies drift apart, the grouping nodes are rebuilt only when
+// their total radius has grown past rebuildRatio times what it was when built.
+class BodyBVH
+{
+private:
+    struct BVHNode {
+        glm::vec3 centre;
+        float radius;           // sphere around the node's whole subtree
+        float objectRadius;     // the object's own radius (the object sits at 'centre')
+        int object;             // index in montum, or -1 for a grouping node
+        int firstChild;         // children are childNodes[firstChild .. firstChild+numChildren-1]
+        int numChildren;
+    };
+    std::vector<BVHNode> nodes;         // node 0 is the root object
+    std::vector<int> childNodes;
+    std::vector<int> refitOrder;        // every node after all of its children
+    float groupingRadiusBuilt;          // sum of grouping node radii at the last build
+    int addNode(int);
+    void buildObjectNode(AstroGroup&, int, int);
+    void buildGrouping(int, int*, int*);
+    void mergeSphere(BVHNode&, glm::vec3, float);
+    void enclose(BVHNode&);
+    float groupingRadius(void);
+    void addSubtree(int, std::vector<int>&);
+    struct AlongAxis {
+        std::vector<BVHNode>& nodes;
+        int axis;
+        AlongAxis(std::vector<BVHNode>& n, int a) : nodes(n), axis(a) {}
+        bool operator()(int a, int b) const { return nodes[a].centre[axis] < nodes[b].centre[axis]; }
+    };
+    struct QueueEntry {             // k-nearest search: a node, or an object when 'isObject'
+        float dist;
+        int node;
+        bool isObject;
+        bool operator<(const QueueEntry& other) const { return dist > other.dist; }   // nearest on top
+    };
+public:
+    static const int leafFanout = 8;    // objects with more children than this get grouping nodes
+    float rebuildRatio = 2.0;
+    int rebuilds = 0;                   // number of times the tree was rebuilt after a refit
+    void build(AstroGroup&);            // build the tree for the group's current positions
+    void refit(AstroGroup&);            // update every sphere for the current positions
+    int numNodes(void);
+
+    // queries append object indices (into montum) to 'found'
+    void queryFrustum(const glm::mat4&, std::vector<int>&);                 // everything inside a view-projection
+    void querySphere(glm::vec3, float, std::vector<int>&);                   // everything overlapping a sphere
+    void kNearest(glm::vec3, int, std::vector<int>&);                        // k nearest objects, nearest first
+    int raycast(glm::vec3, glm::vec3, float&);                               // nearest object hit, or -1
+};
+
+int BodyBVH::addNode(int object)
+{
+    BVHNode node;
+    node.centre = glm::vec3(0.0);
+    node.radius = 0.0;
+    node.objectRadius = 0.0;
+    node.object = object;
+    node.firstChild = 0;
+    node.numChildren = 0;
+    nodes.push_back(node);
+    return int(nodes.size())-1;
+}
+
+// Grow a node's sphere just enough to hold another sphere
+void BodyBVH::mergeSphere(BVHNode& node, glm::vec3 c, float r)
+{
+    if (node.radius < 0.0) { node.centre = c; node.radius = r; return; }
+    glm::vec3 d = c - node.centre;
+    float dist = glm::length(d);
+    if (dist + r <= node.radius) return;            // already inside
+    if (dist + node.radius <= r) { node.centre = c; node.radius = r; return; }
+    float newRadius = 0.5f*(dist + node.radius + r);
+    node.centre += d * ((newRadius - node.radius)/dist);
+    node.radius = newRadius;
+}
+
+// Recompute a node's sphere from its children (children must already be up to date)
+void BodyBVH::enclose(BVHNode& node)
+{
+    int first = node.firstChild;
+    int last = node.firstChild + node.numChildren;
+    if (node.object >= 0) {
+        // an object's node stays centred on the object; it only grows to hold its descendants
+        for (int c = first; c < last; c++) {
+            BVHNode& child = nodes[childNodes[c]];
+            float reach = glm::length(child.centre - node.centre) + child.radius;
+            if (reach > node.radius) node.radius = reach;
+        }
+        return;
+    }
+    node.radius = -1.0;
+    for (int c = first; c < last; c++)
+        mergeSphere(node, nodes[childNodes[c]].centre, nodes[childNodes[c]].radius);
+}
+
+// Split the child nodes in [begin,end) along their widest axis until each group is small
+void BodyBVH::buildGrouping(int parent, int* begin, int* end)
+{
+    glm::vec3 lo = nodes[*begin].centre, hi = lo;
+    for (int* c = begin; c < end; c++) {
+        lo = glm::min(lo, nodes[*c].centre);
+        hi = glm::max(hi, nodes[*c].centre);
+    }
+    glm::vec3 extent = hi - lo;
+    int axis = (extent.x > extent.y && extent.x > extent.z) ? 0 : (extent.y > extent.z ? 1 : 2);
+    int* mid = begin + (end - begin)/2;
+    std::nth_element(begin, mid, end, AlongAxis(nodes, axis));
+
+    int halves[2];
+    int* ranges[3] = {begin, mid, end};
+    for (int h = 0; h < 2; h++) {
+        if (ranges[h+1] - ranges[h] == 1) { halves[h] = *ranges[h]; continue; }
+        halves[h] = addNode(-1);
+        if (ranges[h+1] - ranges[h] <= leafFanout) {
+            nodes[halves[h]].firstChild = int(childNodes.size());
+            nodes[halves[h]].numChildren = int(ranges[h+1] - ranges[h]);
+            childNodes.insert(childNodes.end(), ranges[h], ranges[h+1]);
+        }
+        else buildGrouping(halves[h], ranges[h], ranges[h+1]);
+        enclose(nodes[halves[h]]);
+        refitOrder.push_back(halves[h]);
+    }
+    nodes[parent].firstChild = int(childNodes.size());
+    nodes[parent].numChildren = 2;
+    childNodes.push_back(halves[0]);
+    childNodes.push_back(halves[1]);
+}
+
+// Build the node for one object after the nodes of all of its children exist
+void BodyBVH::buildObjectNode(AstroGroup& group, int object, int node)
+{
+    std::vector<int> children;
+    for (AstroObject* child = group.montum[object].leftmostChild; child != NULL; child = child->rightSibling) {
+        int c = child->index;
+        int childNode = addNode(c);
+        buildObjectNode(group, c, childNode);
+        children.push_back(childNode);
+    }
+    nodes[node].centre = group.montum[object].currentAbsLocation;
+    nodes[node].objectRadius = group.montum[object].viewingRadius();
+    nodes[node].radius = nodes[node].objectRadius;
+    if (int(children.size()) <= leafFanout) {
+        nodes[node].firstChild = int(childNodes.size());
+        nodes[node].numChildren = int(children.size());
+        childNodes.insert(childNodes.end(), children.begin(), children.end());
+    }
+    else buildGrouping(node, &children.front(), &children.front() + children.size());
+    enclose(nodes[node]);
+    refitOrder.push_back(node);
+}
+
+float BodyBVH::groupingRadius(void)
+{
+    float total = 0.0;
+    for (size_t i = 0; i < nodes.size(); i++)
+        if (nodes[i].object < 0) total += nodes[i].radius;
+    return total;
+}
+
+void BodyBVH::build(AstroGroup& group)
+{
+    nodes.clear();
+    childNodes.clear();
+    refitOrder.clear();
+    nodes.reserve(2*group.numObjects);
+    childNodes.reserve(2*group.numObjects);
+    buildObjectNode(group, 0, addNode(0));
+    groupingRadiusBuilt = groupingRadius();
+}
+
+// refitOrder puts children before parents, so one pass refits the whole tree
+void BodyBVH::refit(AstroGroup& group)
+{
+    if (nodes.empty()) { build(group); return; }
+    float grouped = 0.0;
+    for (size_t i = 0; i < refitOrder.size(); i++) {
+        BVHNode& node = nodes[refitOrder[i]];
+        if (node.object >= 0) {
+            node.centre = group.montum[node.object].currentAbsLocation;
+            node.objectRadius = group.montum[node.object].viewingRadius();
+            node.radius = node.objectRadius;
+        }
+        enclose(node);
+        if (node.object < 0) grouped += node.radius;
+    }
+    if (grouped > rebuildRatio * groupingRadiusBuilt) {
+        build(group);
+        rebuilds++;
+    }
+}
+
+int BodyBVH::numNodes(void)
+{
+    return int(nodes.size());
+}
+
+// Every object in a node's subtree, without further tests
+void BodyBVH::addSubtree(int n, std::vector<int>& found)
+{
+    if (nodes[n].object >= 0) found.push_back(nodes[n].object);
+    for (int c = 0; c < nodes[n].numChildren; c++)
+        addSubtree(childNodes[nodes[n].firstChild + c], found);
+}
+
+void BodyBVH::queryFrustum(const glm::mat4& viewProj, std::vector<int>& found)
+{
+    // the six clip planes (left, right, bottom, top, near, far) from the rows of viewProj
+    glm::vec4 row[4];
+    for (int r = 0; r < 4; r++)
+        row[r] = glm::vec4(viewProj[0][r], viewProj[1][r], viewProj[2][r], viewProj[3][r]);
+    glm::vec4 planes[6] = {row[3]+row[0], row[3]-row[0], row[3]+row[1], row[3]-row[1], row[3]+row[2], row[3]-row[2]};
+    for (int p = 0; p < 6; p++)
+        planes[p] /= glm::length(glm::vec3(planes[p]));
+
+    std::vector<int> stack(1, 0);
+    while (!stack.empty()) {
+        int n = stack.back();
+        stack.pop_back();
+        bool inside = true;
+        bool outside = false;
+        for (int p = 0; p < 6 && !outside; p++) {
+            float dist = glm::dot(glm::vec3(planes[p]), nodes[n].centre) + planes[p].w;
+            if (dist < -nodes[n].radius) outside = true;
+            else if (dist < nodes[n].radius) inside = false;
+        }
+        if (outside) continue;
+        if (inside) { addSubtree(n, found); continue; }
+        if (nodes[n].object >= 0) {     // the subtree straddles a plane; test the object's own sphere
+            bool objectOutside = false;
+            for (int p = 0; p < 6 && !objectOutside; p++)
+                objectOutside = glm::dot(glm::vec3(planes[p]), nodes[n].centre) + planes[p].w < -nodes[n].objectRadius;
+            if (!objectOutside) found.push_back(nodes[n].object);
+        }
+        for (int c = 0; c < nodes[n].numChildren; c++)
+            stack.push_back(childNodes[nodes[n].firstChild + c]);
+    }
+}
+
+void BodyBVH::querySphere(glm::vec3 centre, float radius, std::vector<int>& found)
+{
+    std::vector<int> stack(1, 0);
+    while (!stack.empty()) {
+        int n = stack.back();
+        stack.pop_back();
+        glm::vec3 d = nodes[n].centre - centre;
+        float reach = nodes[n].radius + radius;
+        if (glm::dot(d, d) > reach*reach) continue;
+        reach = nodes[n].objectRadius + radius;
+        if (nodes[n].object >= 0 && glm::dot(d, d) <= reach*reach) found.push_back(nodes[n].object);
+        for (int c = 0; c < nodes[n].numChildren; c++)
+            stack.push_back(childNodes[nodes[n].firstChild + c]);
+    }
+}
+
+// Best-first search: the queue mixes nodes (keyed by the nearest their sphere could be)
+// and objects (keyed by their centre distance), so objects come out in order.
+void BodyBVH::kNearest(glm::vec3 point, int k, std::vector<int>& found)
+{
+    std::priority_queue<QueueEntry> queue;
+    QueueEntry root = {0.0f, 0, false};
+    queue.push(root);
+    int wanted = int(found.size()) + k;
+    while (!queue.empty() && int(found.size()) < wanted) {
+        QueueEntry top = queue.top();
+        queue.pop();
+        if (top.isObject) {
+            found.push_back(nodes[top.node].object);
+            continue;
+        }
+        const BVHNode& node = nodes[top.node];
+        if (node.object >= 0) {
+            QueueEntry obj = {glm::length(node.centre - point), top.node, true};
+            queue.push(obj);
+        }
+        for (int c = 0; c < node.numChildren; c++) {
+            int child = childNodes[node.firstChild + c];
+            QueueEntry entry = {std::max(0.0f, glm::length(nodes[child].centre - point) - nodes[child].radius), child, false};
+            queue.push(entry);
+        }
+    }
+}
+
+// Distance along a ray (unit direction) to where it enters a sphere, or -1 if it misses
+inline float raySphere(glm::vec3 origin, glm::vec3 dir, glm::vec3 centre, float radius)
+{
+    glm::vec3 oc = origin - centre;
+    float b = glm::dot(oc, dir);
+    float c = glm::dot(oc, oc) - radius*radius;
+    float disc = b*b - c;
+    if (disc < 0.0) return -1.0;
+    float t = -b - sqrt(disc);
+    if (t < 0.0) t = -b + sqrt(disc);       // the ray starts inside the sphere
+    return t;
+}
+
+// Nearest object whose sphere the ray (origin, unit direction) hits; its distance goes in tHit
+int BodyBVH::raycast(glm::vec3 origin, glm::vec3 dir, float& tHit)
+{
+    int hit = -1;
+    tHit = 1.0e30;
+    std::vector<int> stack(1, 0);
+    while (!stack.empty()) {
+        int n = stack.back();
+        stack.pop_back();
+        glm::vec3 fromCentre = origin - nodes[n].centre;
+        float tNode = 0.0;      // zero when the ray starts inside the node's sphere
+        if (glm::dot(fromCentre, fromCentre) > nodes[n].radius*nodes[n].radius)
+            tNode = raySphere(origin, dir, nodes[n].centre, nodes[n].radius);
+        if (tNode < 0.0 || tNode > tHit) continue;
+        if (nodes[n].object >= 0) {
+            float t = raySphere(origin, dir, nodes[n].centre, nodes[n].objectRadius);
+            if (t >= 0.0 && t < tHit) { tHit = t; hit = nodes[n].object; }
+        }
+        for (int c = 0; c < nodes[n].numChildren; c++)
+            stack.push_back(childNodes[nodes[n].firstChild + c]);
+    }
+    return hit;
+}
+/*---  (END) BodyBVH Class ---*/
+#endif
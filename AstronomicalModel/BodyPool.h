@@ -0,0 +1,122 @@
+//
+//  BodyPool.h
+//  AstronomicalModel
+//
+//  Created by Matthew McGuire on 10/19/26.
+//  Copyright (c) 2026 Matthew McGuire. All rights reserved.
+//
+
+#ifndef AstronomicalModel_BodyPool_h
+#define AstronomicalModel_BodyPool_h
+
+#include <vector>
+#include <deque>
+#include <queue>
+#include <functional>
+
+/*---  (BEGIN) BodyPool Class ---*/
+// Storage for the objects of a group whose addresses never change: the objects live in chunks of
+// chunkSize, each reserved at its full size when it is made, and a chunk is never moved or freed
+// while the pool lasts. So the tree pointers between objects (leftmostChild, rightSibling) stay
+// good however many are added later.
+//
+// An object is known by its slot (its index, which is also its instance on the GPU) or by a
+// BodyHandle, the slot and the generation it was added in. Removing an object only marks its slot
+// free and moves its generation on, so every handle to it goes stale rather than dangling; the
+// next object added takes the lowest free slot, which keeps the slots in use packed at the front.
+// Nothing is compacted, and the object in a free slot is left as it was until the slot is reused.
+struct BodyHandle
+{
+    int slot;
+    unsigned int generation;        // 0 for no object
+};
+template <class T>
+class BodyPool
+{
+public:
+    static const int chunkSize = 256;
+    BodyPool() : used(0), live(0) {}
+    BodyPool(const BodyPool&);                      // the copy's chunks are reserved in full too
+    BodyHandle add(const T&);
+    bool remove(int);                               // replies whether the slot held an object
+    T& operator[](int slot) { return chunks[slot / chunkSize][slot % chunkSize]; }
+    const T& operator[](int slot) const { return chunks[slot / chunkSize][slot % chunkSize]; }
+    T* find(BodyHandle h) { return valid(h) ? &(*this)[h.slot] : NULL; }
+    bool valid(BodyHandle h) const
+        { return h.slot >= 0 && h.slot < used && h.generation != 0 && generations[h.slot] == h.generation; }
+    bool alive(int slot) const { return (generations[slot] & 1) != 0; }   // odd while it holds an object
+    BodyHandle handle(int slot) const { BodyHandle h = {slot, alive(slot) ? generations[slot] : 0u}; return h; }
+    int size(void) const { return used; }           // slots ever used: the live objects all lie below
+    int count(void) const { return live; }
+    int chunkCount(void) const { return int(chunks.size()); }
+    void reserve(int slots) { while (int(chunks.size()) * chunkSize < slots) newChunk(); }
+    T* address(int slot) { return chunks[slot / chunkSize].data() + slot % chunkSize; }  // a reserved slot's, filled or not
+    void clear(void);                               // every object and slot gone: pointers into the pool die
+    BodyHandle restore(const T&, unsigned int);     // the next slot, with the generation it was saved with
+private:
+    std::deque<std::vector<T> > chunks;             // a deque, so adding a chunk never moves the others
+    std::vector<unsigned int> generations;          // per slot
+    std::priority_queue<int, std::vector<int>, std::greater<int> > freeSlots;
+    int used, live;
+    void newChunk(void) { chunks.push_back(std::vector<T>()); chunks.back().reserve(chunkSize); }
+    BodyPool& operator=(const BodyPool&);           // not assigned
+};
+template <class T>
+BodyPool<T>::BodyPool(const BodyPool& other)
+: generations(other.generations), freeSlots(other.freeSlots), used(other.used), live(other.live)
+{
+    for (size_t c = 0; c < other.chunks.size(); c++) {
+        newChunk();
+        chunks.back().insert(chunks.back().end(), other.chunks[c].begin(), other.chunks[c].end());
+    }
+}
+template <class T>
+BodyHandle BodyPool<T>::add(const T& object)
+{
+    int slot;
+    if (!freeSlots.empty()) {
+        slot = freeSlots.top();
+        freeSlots.pop();
+        (*this)[slot] = object;
+    }
+    else {
+        slot = used++;
+        if (slot >= int(chunks.size()) * chunkSize) newChunk();
+        chunks[slot / chunkSize].push_back(object);     // within its reserve, so nothing moves
+        generations.push_back(0);
+    }
+    generations[slot]++;
+    live++;
+    return handle(slot);
+}
+template <class T>
+void BodyPool<T>::clear(void)
+{
+    chunks.clear();
+    generations.clear();
+    freeSlots = std::priority_queue<int, std::vector<int>, std::greater<int> >();
+    used = live = 0;
+}
+// Slots are put back in order, the object and all; an even generation puts back a free slot
+template <class T>
+BodyHandle BodyPool<T>::restore(const T& object, unsigned int generation)
+{
+    int slot = used++;
+    if (slot >= int(chunks.size()) * chunkSize) newChunk();
+    chunks[slot / chunkSize].push_back(object);
+    generations.push_back(generation);
+    if (alive(slot)) live++;
+    else freeSlots.push(slot);
+    return handle(slot);
+}
+template <class T>
+bool BodyPool<T>::remove(int slot)
+{
+    if (slot < 0 || slot >= used || !alive(slot)) return false;
+    generations[slot]++;
+    freeSlots.push(slot);
+    live--;
+    return true;
+}
+/*---  (END) BodyPool Class ---*/
+#endif
@@ -0,0 +1,45 @@
+//
+//  CompactTransform.h
+//  AstronomicalModel
+//
+//  Created by Matthew McGuire on 10/19/26.
+//  Copyright (c) 2026 Matthew McGuire. All rights reserved.
+//
+
+#ifndef AstronomicalModel_CompactTransform_h
+#define AstronomicalModel_CompactTransform_h
+
+/*---  (BEGIN) CompactTransform Class ---*/
+// A rotation, a uniform scale and a translation: everything an object's transform ever
+// holds, in 32 bytes instead of a 64-byte mat4. Applied to a point p it gives
+//     translation + scale * (rotation * p)
+// The layout is also the GPU layout: two RGBA32F texels, (rotation.xyzw) and
+// (translation.xyz, scale). Shaders expand it to a matrix (see fetchTransform).
+struct CompactTransform
+{
+    glm::quat rotation;
+    glm::vec3 translation;
+    float scale;
+    CompactTransform() : rotation(1.0, 0.0, 0.0, 0.0), translation(0.0), scale(1.0) {}
+    CompactTransform(glm::quat r, glm::vec3 t, float s) : rotation(r), translation(t), scale(s) {}
+    // a rotation of 'radians' about a unit axis (built here so it never depends on whether
+    // the GLM in use takes degrees or radians)
+    static glm::quat axisRotation(float radians, glm::vec3 axis) {
+        float s = sin(0.5f*radians);
+        return glm::quat(cos(0.5f*radians), axis.x*s, axis.y*s, axis.z*s);
+    }
+    // (a*b) applied to p is a applied to (b applied to p), as for matrices
+    CompactTransform operator*(const CompactTransform& b) const {
+        return CompactTransform(rotation * b.rotation, translation + scale * (rotation * b.translation), scale * b.scale);
+    }
+    glm::vec3 apply(glm::vec3 p) const {
+        return translation + scale * (rotation * p);
+    }
+    glm::mat4 toMatrix(void) const {
+        glm::mat3 r = glm::mat3_cast(rotation);
+        return glm::mat4(glm::vec4(scale*r[0], 0.0), glm::vec4(scale*r[1], 0.0),
+                         glm::vec4(scale*r[2], 0.0), glm::vec4(translation, 1.0));
+    }
+};
+/*---  (END) CompactTransform Class ---*/
+#endif
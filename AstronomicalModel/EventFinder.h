@@ -0,0 +1,407 @@
+//
+//  EventFinder.h
+//  AstronomicalModel
+//
+//  Created by Matthew McGuire on 10/19/26.
+//  Copyright (c) 2026 Matthew McGuire. All rights reserved.
+//
+
+#ifndef AstronomicalModel_EventFinder_h
+#define AstronomicalModel_EventFinder_h
+
+#include <vector>
+#include <algorithm>
+#include "WorkPool.h"
+#include "OrbitModel.h"
+
+/*---  (BEGIN) EventFinder Class ---*/
+struct AstroEvent
+{
+    enum Kind {ECLIPSE, TRANSIT, APPROACH, CONJUNCTION};
+    Kind kind;
+    int a, b;               // ECLIPSE/TRANSIT: b crosses the Sun as seen from a. APPROACH: a and b.
+                            // CONJUNCTION: a and b as seen from 'observer'.
+    int observer;
+    double begin, peak, end;    // minutes from the start of the search
+    double value;               // at the peak: eclipse depth (fraction of Sun's width), km, or degrees
+};
+
+// Searches a span of time for events between pairs of objects. Each pair has a
+// function f(t) that is negative exactly while the event is in progress:
+//   eclipse/transit: angle between Sun and occluder minus the sum of their angular radii
+//   close approach:  distance minus closeApproachKm
+//   conjunction:     angle between the two (seen from 'observer') minus conjunctionDegrees
+// f is sampled coarsely (samplesPerPeriod per fastest orbit involved); sign changes
+// are refined by bisection, and local minima by golden-section search, so events
+// shorter than a sample step are still found at their deepest point.
+// Pairs that can never come close, judged from the range of distances each object
+// keeps from the Sun, are dropped before any sampling. The remaining work is split
+// into (pair, time window) tasks and run on a WorkPool.
+class EventFinder
+{
+private:
+    struct PairSearch {
+        AstroEvent::Kind kind;
+        int a, b;
+        double step;            // sample spacing (minutes)
+        int windows;            // how many time windows the span is split into
+        int firstTask;
+    };
+    struct Feature {            // something found inside one window
+        double t;
+        double value;
+        int type;               // +1 f goes negative, -1 f goes positive, 0 local minimum
+        bool operator<(const Feature& other) const { return t < other.t; }
+    };
+    class WindowJob : public PoolJob    // one (pair, window) search per task
+    {
+    public:
+        EventFinder* finder;
+        void run(int task)
+        {
+            const PairSearch& p = finder->pairs[finder->taskPair[task]];
+            finder->searchWindow(p, task - p.firstTask, finder->taskFeatures[task]);
+        }
+    };
+    struct EarlierPeak {
+        bool operator()(const AstroEvent& x, const AstroEvent& y) const { return x.peak < y.peak; }
+    };
+    const OrbitModel* orbits;
+    double span;
+    std::vector<PairSearch> pairs;
+    std::vector<int> taskPair;
+    std::vector<std::vector<Feature> > taskFeatures;
+    int workers;                        // the pool's threads besides the caller's (-1: one per core)
+    WorkPool* pool;                     // taken at the first search (the shared one, for -1)
+    std::vector<double> nearestToSun, furthestFromSun;
+    double pairFunction(const PairSearch&, double) const;
+    double fastestPeriod(int, int) const;
+    void addPair(AstroEvent::Kind, int, int);
+    void searchWindow(const PairSearch&, int, std::vector<Feature>&) const;
+    double refineRoot(const PairSearch&, double, double, double) const;
+    double refineMinimum(const PairSearch&, double, double, double&) const;
+    void assembleEvents(const PairSearch&, std::vector<AstroEvent>&);
+    std::vector<AstroEvent> searchOrbits(const OrbitModel&, double);
+    class SearchJob : public PoolJob    // a whole search, in the background
+    {
+    public:
+        EventFinder* finder;
+        double minutes;
+        void run(int) { finder->found = finder->searchOrbits(finder->captured, minutes); }
+    };
+    OrbitModel captured;                // the group as it was when the background search started
+    std::vector<AstroEvent> found;
+    SearchJob searchJob;
+    PoolBatch searchBatch;
+    bool searchStarted;
+public:
+    EventFinder(int);                   // number of threads, 0 = one per hardware thread
+    ~EventFinder() { if (pool != NULL) releasePool(pool); }
+    int threads(void);
+    bool useViewingScale = false;       // search the model as drawn, rather than at true sizes (km)
+    int observer = -1;                  // object to look for conjunctions from, -1 for none
+    double closeApproachKm = 1.0e6;
+    double conjunctionDegrees = 1.0;
+    double minOccluderRatio = 1.0e-3;   // ignore occluders that never reach this fraction of the Sun's width
+    int samplesPerPeriod = 32;
+    double refineTolerance = 0.5;       // minutes
+    int pairsConsidered = 0, pairsPruned = 0;
+    std::vector<AstroEvent> search(AstroGroup&, double);    // events in the next 'minutes' of the group
+    void startSearch(AstroGroup&, double);                  // the same, in the background on the pool
+    bool searching(void) const { return searchStarted; }
+    bool searchFinished(std::vector<AstroEvent>&);          // once, when a background search is done: its events
+    void report(AstroGroup&, const std::vector<AstroEvent>&);
+};
+
+EventFinder::EventFinder(int threads) : workers(threads > 0 ? threads-1 : -1), pool(NULL), searchStarted(false)
+{
+}
+int EventFinder::threads(void)
+{
+    if (pool == NULL) pool = acquirePool(workers);
+    return pool->threads();
+}
+
+double EventFinder::pairFunction(const PairSearch& p, double t) const
+{
+    glm::dvec3 posA = orbits->positionAt(p.a, t);
+    glm::dvec3 posB = orbits->positionAt(p.b, t);
+    switch (p.kind) {
+        case AstroEvent::APPROACH:
+            return glm::length(posB - posA) - closeApproachKm;
+        case AstroEvent::CONJUNCTION: {
+            glm::dvec3 from = orbits->positionAt(observer, t);
+            double c = glm::dot(glm::normalize(posA - from), glm::normalize(posB - from));
+            return acos(glm::clamp(c, -1.0, 1.0))/DegreesToRadians - conjunctionDegrees;
+        }
+        default: {              // ECLIPSE and TRANSIT: b in front of the Sun, seen from a
+            glm::dvec3 sun = orbits->positionAt(0, t);
+            glm::dvec3 toSun = sun - posA;
+            glm::dvec3 toB = posB - posA;
+            double sunDist = glm::length(toSun);
+            double bDist = glm::length(toB);
+            if (bDist >= sunDist) return M_PI;      // behind the Sun, or level with it
+            double sunAngle = asin(std::min(1.0, orbits->radius[0]/sunDist));
+            double bAngle = asin(std::min(1.0, orbits->radius[p.b]/bDist));
+            double apart = acos(glm::clamp(glm::dot(toSun, toB)/(sunDist*bDist), -1.0, 1.0));
+            return apart - (sunAngle + bAngle);
+        }
+    }
+}
+
+// The shortest orbital period among both objects and everything they orbit
+double EventFinder::fastestPeriod(int a, int b) const
+{
+    double fastest = 0.0;
+    int chain[2] = {a, b};
+    for (int c = 0; c < 2; c++)
+        for (int i = chain[c]; i > 0; i = orbits->parent[i])
+            fastest = std::max(fastest, fabs(orbits->rate[i]));
+    if (observer > 0)
+        for (int i = observer; i > 0; i = orbits->parent[i])
+            fastest = std::max(fastest, fabs(orbits->rate[i]));
+    return (fastest > 0.0) ? twoPi/fastest : span;
+}
+
+void EventFinder::addPair(AstroEvent::Kind kind, int a, int b)
+{
+    PairSearch p;
+    p.kind = kind;
+    p.a = a;
+    p.b = b;
+    p.step = std::min(fastestPeriod(a, b)/samplesPerPeriod, span);
+    p.windows = 1;
+    p.firstTask = 0;
+    pairs.push_back(p);
+}
+
+// Bisection on [lo,hi], where f(lo) and f(hi) have opposite signs
+double EventFinder::refineRoot(const PairSearch& p, double lo, double hi, double fLo) const
+{
+    while (hi - lo > refineTolerance) {
+        double mid = 0.5*(lo + hi);
+        double fMid = pairFunction(p, mid);
+        if ((fMid < 0.0) == (fLo < 0.0)) { lo = mid; fLo = fMid; }
+        else hi = mid;
+    }
+    return 0.5*(lo + hi);
+}
+
+// Golden-section search for the minimum of f inside [lo,hi]
+double EventFinder::refineMinimum(const PairSearch& p, double lo, double hi, double& fMin) const
+{
+    const double g = 0.6180339887498949;
+    double x1 = hi - g*(hi - lo), x2 = lo + g*(hi - lo);
+    double f1 = pairFunction(p, x1), f2 = pairFunction(p, x2);
+    while (hi - lo > refineTolerance) {
+        if (f1 < f2) { hi = x2; x2 = x1; f2 = f1; x1 = hi - g*(hi - lo); f1 = pairFunction(p, x1); }
+        else         { lo = x1; x1 = x2; f1 = f2; x2 = lo + g*(hi - lo); f2 = pairFunction(p, x2); }
+    }
+    fMin = std::min(f1, f2);
+    return (f1 < f2) ? x1 : x2;
+}
+
+// Sample one window of one pair. Samples just outside the window are taken too, so a
+// feature on a window edge is seen, but only features starting inside it are kept.
+void EventFinder::searchWindow(const PairSearch& p, int window, std::vector<Feature>& found) const
+{
+    long totalSteps = long(ceil(span / p.step));
+    long stepsPerWindow = (totalSteps + p.windows - 1) / p.windows;
+    long first = window * stepsPerWindow;
+    long last = std::min(totalSteps, first + stepsPerWindow);
+    double before = pairFunction(p, (first-1)*p.step);
+    double now = pairFunction(p, first*p.step);
+    for (long k = first; k < last; k++) {
+        double tNow = k*p.step;
+        double after = pairFunction(p, (k+1)*p.step);
+        if ((now < 0.0) != (after < 0.0)) {
+            Feature crossing = {refineRoot(p, tNow, tNow + p.step, now), 0.0, (after < 0.0) ? +1 : -1};
+            found.push_back(crossing);
+        }
+        if (now <= before && now < after) {
+            Feature minimum;
+            minimum.type = 0;
+            minimum.t = refineMinimum(p, tNow - p.step, tNow + p.step, minimum.value);
+            if (minimum.value < 0.0) {
+                found.push_back(minimum);
+                if (before >= 0.0 && now >= 0.0 && after >= 0.0) {
+                    // the whole event fits between two samples
+                    Feature in = {refineRoot(p, tNow - p.step, minimum.t, before), 0.0, +1};
+                    Feature out = {refineRoot(p, minimum.t, tNow + p.step, minimum.value), 0.0, -1};
+                    found.push_back(in);
+                    found.push_back(out);
+                }
+            }
+        }
+        before = now;
+        now = after;
+    }
+}
+
+// Join the crossings and minima of every window of one pair into events
+void EventFinder::assembleEvents(const PairSearch& p, std::vector<AstroEvent>& events)
+{
+    std::vector<Feature> features;
+    for (int w = 0; w < p.windows; w++)
+        features.insert(features.end(), taskFeatures[p.firstTask + w].begin(), taskFeatures[p.firstTask + w].end());
+    std::sort(features.begin(), features.end());
+
+    AstroEvent e;
+    e.kind = p.kind;
+    e.a = p.a;
+    e.b = p.b;
+    e.observer = (p.kind == AstroEvent::CONJUNCTION) ? observer : -1;
+    bool inside = pairFunction(p, 0.0) < 0.0;
+    e.begin = 0.0;
+    e.peak = -1.0;
+    e.value = 0.0;
+    for (size_t i = 0; i < features.size(); i++) {
+        const Feature& f = features[i];
+        if (f.type == +1) { inside = true; e.begin = f.t; e.peak = -1.0; }
+        else if (f.type == 0 && inside && (e.peak < 0.0 || f.value < e.value)) { e.peak = f.t; e.value = f.value; }
+        else if (f.type == -1 && inside) {
+            inside = false;
+            e.end = f.t;
+            if (e.peak < 0.0) { e.peak = 0.5*(e.begin + e.end); e.value = pairFunction(p, e.peak); }
+            events.push_back(e);
+        }
+    }
+    if (inside) {               // still going when the span ends
+        e.end = span;
+        if (e.peak < 0.0) { e.peak = 0.5*(e.begin + e.end); e.value = pairFunction(p, e.peak); }
+        events.push_back(e);
+    }
+}
+
+std::vector<AstroEvent> EventFinder::search(AstroGroup& group, double minutes)
+{
+    OrbitModel model;
+    model.capture(group, useViewingScale);
+    return searchOrbits(model, minutes);
+}
+// The group is captured now, on the caller's thread; the search itself is one task on the pool,
+// which shares its windows out over the workers in turn
+void EventFinder::startSearch(AstroGroup& group, double minutes)
+{
+    captured.capture(group, useViewingScale);
+    searchJob.finder = this;
+    searchJob.minutes = minutes;
+    if (pool == NULL) pool = acquirePool(workers);
+    searchStarted = true;
+    pool->start(searchJob, 1, searchBatch);
+}
+bool EventFinder::searchFinished(std::vector<AstroEvent>& events)
+{
+    if (!searchStarted || !searchBatch.done()) return false;
+    searchStarted = false;
+    events.swap(found);
+    found.clear();
+    return true;
+}
+
+std::vector<AstroEvent> EventFinder::searchOrbits(const OrbitModel& model, double minutes)
+{
+    orbits = &model;
+    span = minutes;
+    int n = model.size();
+
+    // the nearest and furthest each object can ever be from the Sun, following the tree
+    nearestToSun.assign(n, 0.0);
+    furthestFromSun.assign(n, 0.0);
+    for (size_t k = 0; k < model.order.size(); k++) {
+        int i = model.order[k], p = model.parent[i];
+        if (p < 0) continue;
+        double r = model.orbitRadius[i];
+        nearestToSun[i] = (r <= nearestToSun[p]) ? nearestToSun[p] - r :
+                          (r >= furthestFromSun[p] ? r - furthestFromSun[p] : 0.0);
+        furthestFromSun[i] = furthestFromSun[p] + r;
+    }
+
+    pairs.clear();
+    pairsConsidered = pairsPruned = 0;
+    for (int a = 1; a < n; a++)
+        for (int b = 1; b < n; b++) {
+            if (a == b || !model.held[a] || !model.held[b]) continue;
+            // the closest a and b could be, from their distance ranges alone
+            double gap = std::max(0.0, std::max(nearestToSun[a] - furthestFromSun[b], nearestToSun[b] - furthestFromSun[a]));
+            double sunAngle = asin(std::min(1.0, model.radius[0]/std::max(furthestFromSun[a], model.radius[0])));
+            pairsConsidered++;
+            bool canOcclude = nearestToSun[b] < furthestFromSun[a] &&
+                              (gap <= model.radius[b] || asin(model.radius[b]/gap) >= minOccluderRatio*sunAngle);
+            if (canOcclude) addPair(AstroEvent::ECLIPSE, a, b);
+            else pairsPruned++;
+            if (b < a) continue;            // the remaining kinds are symmetric
+            pairsConsidered++;
+            if (gap < closeApproachKm && model.parent[a] != b && model.parent[b] != a)
+                addPair(AstroEvent::APPROACH, a, b);
+            else pairsPruned++;
+            if (observer > 0 && a != observer && b != observer && model.parent[a] == 0 && model.parent[b] == 0) {
+                pairsConsidered++;
+                addPair(AstroEvent::CONJUNCTION, a, b);
+            }
+        }
+
+    // split each pair's span into enough windows to keep every thread busy
+    int wanted = 8 * threads();
+    int numTasks = 0;
+    for (size_t i = 0; i < pairs.size(); i++) {
+        long totalSteps = long(ceil(span / pairs[i].step));
+        pairs[i].windows = int(std::max(1L, std::min(long(wanted / std::max<size_t>(1, pairs.size())) + 1, totalSteps / 256)));
+        pairs[i].firstTask = numTasks;
+        numTasks += pairs[i].windows;
+    }
+    taskPair.assign(numTasks, 0);
+    for (size_t i = 0; i < pairs.size(); i++)
+        for (int w = 0; w < pairs[i].windows; w++) taskPair[pairs[i].firstTask + w] = int(i);
+    taskFeatures.assign(numTasks, std::vector<Feature>());
+    WindowJob job;
+    job.finder = this;
+    pool->runAll(job, numTasks);
+
+    std::vector<AstroEvent> events;
+    for (size_t i = 0; i < pairs.size(); i++)
+        assembleEvents(pairs[i], events);
+    for (size_t i = 0; i < events.size(); i++) {
+        AstroEvent& e = events[i];
+        if (e.kind == AstroEvent::ECLIPSE) {
+            // how deep: the occluder's angular width compared with the Sun's, at the peak
+            glm::dvec3 posA = model.positionAt(e.a, e.peak);
+            double sunAngle = asin(std::min(1.0, model.radius[0]/glm::length(model.positionAt(0, e.peak) - posA)));
+            double bAngle = asin(std::min(1.0, model.radius[e.b]/glm::length(model.positionAt(e.b, e.peak) - posA)));
+            if (bAngle < sunAngle) e.kind = AstroEvent::TRANSIT;
+            e.value = bAngle/sunAngle;
+        }
+        else if (e.kind == AstroEvent::APPROACH) e.value += closeApproachKm;
+        else e.value += conjunctionDegrees;
+    }
+    std::sort(events.begin(), events.end(), EarlierPeak());
+    orbits = NULL;
+    return events;
+}
+
+void EventFinder::report(AstroGroup& group, const std::vector<AstroEvent>& events)
+{
+    const char* kindNames[] = {"Eclipse", "Transit", "Close approach", "Conjunction"};
+    const double minutesPerDay = 24.0*60.0;
+    for (size_t i = 0; i < events.size(); i++) {
+        const AstroEvent& e = events[i];
+        std::cout << "day " << e.peak/minutesPerDay << ": " << kindNames[e.kind] << " ";
+        switch (e.kind) {
+            case AstroEvent::ECLIPSE:
+            case AstroEvent::TRANSIT:
+                std::cout << group.montum[e.b].name << " across the Sun from " << group.montum[e.a].name
+                << " (size ratio " << e.value << ")";
+                break;
+            case AstroEvent::APPROACH:
+                std::cout << group.montum[e.a].name << " - " << group.montum[e.b].name << " (" << e.value << ")";
+                break;
+            case AstroEvent::CONJUNCTION:
+                std::cout << group.montum[e.a].name << " - " << group.montum[e.b].name << " from "
+                << group.montum[e.observer].name << " (" << e.value << " deg)";
+                break;
+        }
+        std::cout << ", lasting " << (e.end - e.begin)/60.0 << " hours" << std::endl;
+    }
+}
+/*---  (END) EventFinder Class ---*/
+#endif
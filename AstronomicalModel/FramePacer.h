@@ -0,0 +1,100 @@
+//
+//  FramePacer.h
+//  AstronomicalModel
+//
+//  Created by Matthew McGuire on 10/19/26.
+//  Copyright (c) 2026 Matthew McGuire. All rights reserved.
+//
+
+#ifndef AstronomicalModel_FramePacer_h
+#define AstronomicalModel_FramePacer_h
+
+#include <chrono>
+#include <thread>
+#include <ctime>
+#include <cmath>
+#include <algorithm>
+
+/*---  (BEGIN) FramePacer Class ---*/
+// Holds the frames to a target rate, and measures how well it does and what it costs. Each frame
+// ends in waitForNextFrame: the thread sleeps until spinMargin before the deadline (sleeping is
+// coarse, a millisecond or so late) and spins the rest, then the deadline moves on by one interval.
+// A frame that overran starts the count again from now, rather than rushing to catch up.
+//
+// Over each 'window' seconds it keeps the mean and spread of the frame times, the process's CPU
+// time and the GPU time it is told of (addGPUTime), each as a fraction of the wall time. The
+// last whole window's figures are in 'report'.
+struct PacingReport
+{
+    int frames;
+    double meanFrame, deviation, worstFrame;     // seconds
+    double cpuUse, gpuUse;                       // fractions of the wall time (cpu may pass 1 with threads)
+};
+class FramePacer
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+    double targetRate;              // frames per second, or 0 for as fast as possible
+    double spinMargin;              // seconds before the deadline to stop sleeping and spin
+    double window;                  // seconds over which each report is gathered
+    PacingReport report;
+    FramePacer(double rate) : targetRate(rate), spinMargin(0.001), window(1.0)
+    {
+        PacingReport none = {0, 0.0, 0.0, 0.0, 0.0, 0.0};
+        report = none;
+        deadline = lastFrame = windowStart = Clock::now();
+        windowCPU = std::clock();
+        resetWindow();
+    }
+    static double seconds(Clock::duration d) { return std::chrono::duration<double>(d).count(); }
+    void waitForNextFrame(void);
+    void frameDone(void);           // count a frame drawn without waiting (or after an idle wait)
+    void addGPUTime(double s) { gpuSeconds += s; }
+    void restart(void) { deadline = lastFrame = Clock::now(); }
+private:
+    Clock::time_point deadline, lastFrame, windowStart;
+    std::clock_t windowCPU;
+    int frames;
+    double mean, squares, worst, gpuSeconds;    // squares: Welford's running sum of squared differences
+    void resetWindow(void) { frames = 0; mean = squares = worst = gpuSeconds = 0.0; }
+};
+void FramePacer::waitForNextFrame(void)
+{
+    if (targetRate > 0.0) {
+        Clock::duration interval = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0/targetRate));
+        deadline += interval;
+        Clock::time_point now = Clock::now();
+        if (deadline < now)
+            deadline = now;                                 // overran: no catching up
+        Clock::time_point wake = deadline - std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(spinMargin));
+        if (wake > now) std::this_thread::sleep_until(wake);
+        while (Clock::now() < deadline) {}
+    }
+    frameDone();
+}
+void FramePacer::frameDone(void)
+{
+    Clock::time_point now = Clock::now();
+    double frame = seconds(now - lastFrame);
+    lastFrame = now;
+    frames++;
+    double difference = frame - mean;
+    mean += difference / frames;
+    squares += difference * (frame - mean);
+    worst = std::max(worst, frame);
+    double wall = seconds(now - windowStart);
+    if (wall >= window) {
+        std::clock_t cpu = std::clock();
+        report.frames = frames;
+        report.meanFrame = mean;
+        report.deviation = frames > 1 ? sqrt(squares / (frames - 1)) : 0.0;
+        report.worstFrame = worst;
+        report.cpuUse = double(cpu - windowCPU) / CLOCKS_PER_SEC / wall;
+        report.gpuUse = gpuSeconds / wall;
+        windowStart = now;
+        windowCPU = cpu;
+        resetWindow();
+    }
+}
+/*---  (END) FramePacer Class ---*/
+#endif
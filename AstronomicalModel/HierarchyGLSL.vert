@@ -0,0 +1,45 @@
+#version 330
+// Evaluates the whole object tree from fixed parameters and the time since the last
+// resync: one vertex per object, nothing rasterised. Transform feedback captures either
+// the object's model transform (a CompactTransform, the layout of 'objectTransforms') or its
+// bounding sphere (the layout of 'bodySpheres'), depending on which program is linked.
+// The motion is that of AstroObject::incremObject and updateAbsLocationModelOrientation.
+uniform samplerBuffer bodyParams;       // two texels per object, see uploadBodyParams in main.h:
+                                        //   parent, orbit radius, orbit rate, orbit angle at time zero
+                                        //   spin rate, spin angle at time zero, tilt, radius
+                                        // (both radii as specified, in km: the viewing scale is applied here)
+uniform float hierarchyMinutes;         // time since the angles were captured
+uniform float scaleFactor;              // viewing scale exponent, as in AstroObject::viewingScale
+out vec4 transformRotation;             // quaternion (x, y, z, w)
+out vec4 transformTranslationScale;
+out vec4 sphere;
+
+const int maxDepth = 16;                // deeper trees than this are not followed further
+
+float viewingScale(float value) {
+    return value > 0.0 ? pow(value, scaleFactor) : 0.0;
+}
+
+void main() {
+    int body = gl_VertexID;
+    vec4 spin = texelFetch(bodyParams, 2*body+1);
+
+    // absolute position: every orbit in the chain is a circle in the x-z plane about its parent
+    vec3 position = vec3(0.0);
+    int i = body;
+    for (int depth = 0; depth < maxDepth && i >= 0; depth++) {
+        vec4 orbit = texelFetch(bodyParams, 2*i);
+        float angle = orbit.w + orbit.z * hierarchyMinutes;
+        position += viewingScale(orbit.y) * vec3(cos(angle), 0.0, -sin(angle));
+        i = int(orbit.x);
+    }
+
+    // tilt (about z) after spin (about y): the product of the two quaternions
+    float halfSpin = 0.5 * (spin.y + spin.x * hierarchyMinutes);
+    float halfTilt = 0.5 * spin.z;
+    transformRotation = vec4(-sin(halfTilt)*sin(halfSpin), cos(halfTilt)*sin(halfSpin),
+                              sin(halfTilt)*cos(halfSpin), cos(halfTilt)*cos(halfSpin));
+    float radius = viewingScale(spin.w);
+    transformTranslationScale = vec4(position, radius);
+    sphere = vec4(position, radius);
+}
@@ -0,0 +1,12 @@
+#version 330
+in vec2 atlasTexel;
+flat in int glyph;
+uniform sampler2D glyphAtlas;           // every glyph side by side, one 6x8 cell each
+uniform vec4 hudColour;
+out vec4 fColor;
+
+void main() {
+    ivec2 texel = ivec2(glyph*6 + min(int(atlasTexel.x), 5), min(int(atlasTexel.y), 7));
+    if (texelFetch(glyphAtlas, texel, 0).r < 0.5) discard;
+    fColor = hudColour;
+}
@@ -0,0 +1,20 @@
+#version 330
+// One character of the HUD per instance (see HudText.h): a glyph cell scaled by hudScale, at its
+// column and line from the window's top left corner, drawn as a 4-vertex strip with no vertex buffer.
+// Blank cells have no glyph and are folded to a point, so nothing of them is drawn.
+in ivec3 hudGlyph;                      // column, line, glyph (or -1)
+uniform vec2 viewportSize;              // in pixels
+uniform float hudScale;                 // screen pixels per atlas texel
+out vec2 atlasTexel;
+flat out int glyph;
+
+const vec2 cellSize = vec2(6.0, 8.0);   // glyphWidth, glyphHeight
+const vec2 margin = vec2(1.0, 1.0);     // in cells
+
+void main() {
+    vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);
+    vec2 pixel = (margin + vec2(hudGlyph.xy) + (hudGlyph.z < 0 ? vec2(0.0) : corner)) * cellSize * hudScale;
+    gl_Position = vec4(2.0*pixel.x/viewportSize.x - 1.0, 1.0 - 2.0*pixel.y/viewportSize.y, 0.0, 1.0);
+    atlasTexel = corner * cellSize;
+    glyph = hudGlyph.z;
+}
@@ -0,0 +1,160 @@
+//
+//  HudText.h
+//  AstronomicalModel
+//
+//  Created by Matthew McGuire on 10/19/26.
+//  Copyright (c) 2026 Matthew McGuire. All rights reserved.
+//
+
+#ifndef AstronomicalModel_HudText_h
+#define AstronomicalModel_HudText_h
+
+#include <cstring>
+#include <cctype>
+#include <algorithm>
+
+/*---  (BEGIN) HudText Class ---*/
+// The on-screen panel: a fixed grid of maxLines lines of maxColumns characters, each character one
+// instance (a HudGlyph) for HudGLSL.vert, which draws it as a square cut from the glyph atlas.
+// Every cell of the grid always has its instance, so the instance buffer is made once at its full
+// size and the whole panel is one draw; blank cells have no glyph and fold away in the shader.
+// setLine only rewrites a line whose text has changed, and keeps the range of instances that
+// need sending again. Nothing here allocates after construction.
+struct HudGlyph
+{
+    GLint column, line;
+    GLint glyph;                    // cell in the atlas, or -1 for a blank
+};
+
+// The atlas: 5x7 glyphs, each in a 6x8 cell (a column and a row of space), side by side in one
+// row. Lower case is drawn as upper case; anything not listed is a blank.
+const int glyphWidth = 6, glyphHeight = 8;
+struct GlyphBitmap
+{
+    char character;
+    const char* rows;               // 7 rows of 5, '#' where lit
+};
+const GlyphBitmap hudFont[] = {
+    {'0', ".###." "#...#" "#..##" "#.#.#" "##..#" "#...#" ".###."},
+    {'1', "..#.." ".##.." "..#.." "..#.." "..#.." "..#.." ".###."},
+    {'2', ".###." "#...#" "....#" "...#." "..#.." ".#..." "#####"},
+    {'3', "#####" "...#." "..#.." "...#." "....#" "#...#" ".###."},
+    {'4', "...#." "..##." ".#.#." "#..#." "#####" "...#." "...#."},
+    {'5', "#####" "#...." "####." "....#" "....#" "#...#" ".###."},
+    {'6', "..##." ".#..." "#...." "####." "#...#" "#...#" ".###."},
+    {'7', "#####" "....#" "...#." "..#.." ".#..." ".#..." ".#..."},
+    {'8', ".###." "#...#" "#...#" ".###." "#...#" "#...#" ".###."},
+    {'9', ".###." "#...#" "#...#" ".####" "....#" "...#." ".##.."},
+    {'A', ".###." "#...#" "#...#" "#####" "#...#" "#...#" "#...#"},
+    {'B', "####." "#...#" "#...#" "####." "#...#" "#...#" "####."},
+    {'C', ".###." "#...#" "#...." "#...." "#...." "#...#" ".###."},
+    {'D', "###.." "#..#." "#...#" "#...#" "#...#" "#..#." "###.."},
+    {'E', "#####" "#...." "#...." "####." "#...." "#...." "#####"},
+    {'F', "#####" "#...." "#...." "####." "#...." "#...." "#...."},
+    {'G', ".###." "#...#" "#...." "#.###" "#...#" "#...#" ".####"},
+    {'H', "#...#" "#...#" "#...#" "#####" "#...#" "#...#" "#...#"},
+    {'I', ".###." "..#.." "..#.." "..#.." "..#.." "..#.." ".###."},
+    {'J', "..###" "...#." "...#." "...#." "...#." "#..#." ".##.."},
+    {'K', "#...#" "#..#." "#.#.." "##..." "#.#.." "#..#." "#...#"},
+    {'L', "#...." "#...." "#...." "#...." "#...." "#...." "#####"},
+    {'M', "#...#" "##.##" "#.#.#" "#.#.#" "#...#" "#...#" "#...#"},
+    {'N', "#...#" "#...#" "##..#" "#.#.#" "#..##" "#...#" "#...#"},
+    {'O', ".###." "#...#" "#...#" "#...#" "#...#" "#...#" ".###."},
+    {'P', "####." "#...#" "#...#" "####." "#...." "#...." "#...."},
+    {'Q', ".###." "#...#" "#...#" "#...#" "#.#.#" "#..#." ".##.#"},
+    {'R', "####." "#...#" "#...#" "####." "#.#.." "#..#." "#...#"},
+    {'S', ".####" "#...." "#...." ".###." "....#" "....#" "####."},
+    {'T', "#####" "..#.." "..#.." "..#.." "..#.." "..#.." "..#.."},
+    {'U', "#...#" "#...#" "#...#" "#...#" "#...#" "#...#" ".###."},
+    {'V', "#...#" "#...#" "#...#" "#...#" "#...#" ".#.#." "..#.."},
+    {'W', "#...#" "#...#" "#...#" "#.#.#" "#.#.#" "#.#.#" ".#.#."},
+    {'X', "#...#" "#...#" ".#.#." "..#.." ".#.#." "#...#" "#...#"},
+    {'Y', "#...#" "#...#" ".#.#." "..#.." "..#.." "..#.." "..#.."},
+    {'Z', "#####" "....#" "...#." "..#.." ".#..." "#...." "#####"},
+    {'.', "....." "....." "....." "....." "....." ".##.." ".##.."},
+    {',', "....." "....." "....." "....." ".##.." "..#.." ".#..."},
+    {':', "....." ".##.." ".##.." "....." ".##.." ".##.." "....."},
+    {'-', "....." "....." "....." "#####" "....." "....." "....."},
+    {'+', "....." "..#.." "..#.." "#####" "..#.." "..#.." "....."},
+    {'=', "....." "....." "#####" "....." "#####" "....." "....."},
+    {'/', "....." "....#" "...#." "..#.." ".#..." "#...." "....."},
+    {'%', "##..." "##..#" "...#." "..#.." ".#..." "#..##" "...##"},
+    {'(', "...#." "..#.." ".#..." ".#..." ".#..." "..#.." "...#."},
+    {')', ".#..." "..#.." "...#." "...#." "...#." "..#.." ".#..."},
+};
+const int hudFontSize = sizeof(hudFont) / sizeof(hudFont[0]);
+
+class HudText
+{
+public:
+    static const int maxLines = 8, maxColumns = 40;
+    HudGlyph glyphs[maxLines*maxColumns];       // what the instance buffer holds, line by line
+    HudText();
+    bool setLine(int, const char*);             // replies whether anything changed
+    bool takeChanged(int&, int&);               // the first changed instance and how many, since last taken
+    static int glyphFor(char);
+    static int atlasWidth(void) { return hudFontSize * glyphWidth; }
+    static void bakeAtlas(unsigned char*);      // atlasWidth() x glyphHeight texels, 255 where lit
+private:
+    char text[maxLines][maxColumns+1];
+    int glyphOf[256];
+    int firstChanged, lastChanged;
+};
+
+HudText::HudText()
+{
+    for (int c = 0; c < 256; c++) glyphOf[c] = glyphFor(char(c));
+    for (int line = 0; line < maxLines; line++) {
+        text[line][0] = '\0';
+        for (int column = 0; column < maxColumns; column++) {
+            HudGlyph& g = glyphs[line*maxColumns + column];
+            g.column = column;
+            g.line = line;
+            g.glyph = -1;
+        }
+    }
+    firstChanged = 0;
+    lastChanged = maxLines*maxColumns - 1;
+}
+int HudText::glyphFor(char c)
+{
+    c = char(toupper((unsigned char) c));
+    for (int i = 0; i < hudFontSize; i++)
+        if (hudFont[i].character == c) return i;
+    return -1;
+}
+void HudText::bakeAtlas(unsigned char* texels)
+{
+    int width = atlasWidth();
+    memset(texels, 0, width * glyphHeight);
+    for (int i = 0; i < hudFontSize; i++)
+        for (int row = 0; row < 7; row++)
+            for (int column = 0; column < 5; column++)
+                if (hudFont[i].rows[row*5 + column] == '#')
+                    texels[row*width + i*glyphWidth + column] = 255;
+}
+bool HudText::setLine(int line, const char* s)
+{
+    if (line < 0 || line >= maxLines || strncmp(text[line], s, maxColumns) == 0) return false;
+    strncpy(text[line], s, maxColumns);
+    text[line][maxColumns] = '\0';
+    bool ended = false;
+    for (int column = 0; column < maxColumns; column++) {
+        if (text[line][column] == '\0') ended = true;
+        glyphs[line*maxColumns + column].glyph = ended ? -1 : glyphOf[(unsigned char) text[line][column]];
+    }
+    firstChanged = std::min(firstChanged, line*maxColumns);
+    lastChanged = std::max(lastChanged, line*maxColumns + maxColumns - 1);
+    return true;
+}
+bool HudText::takeChanged(int& first, int& count)
+{
+    if (firstChanged > lastChanged) return false;
+    first = firstChanged;
+    count = lastChanged - firstChanged + 1;
+    firstChanged = maxLines*maxColumns;
+    lastChanged = -1;
+    return true;
+}
+/*---  (END) HudText Class ---*/
+#endif
@@ -0,0 +1,40 @@
+#version 330
+// One camera-facing square per small object, just big enough to hold the sphere's outline
+// seen from the eye; AstronObjectGLSL.frag (compiled with IMPOSTOR) ray-casts the sphere in it.
+// Drawn as an instanced 4-vertex triangle strip with no vertex buffer. The overview inset draws
+// every object this way, one instance each, through its own camera (see drawOverview).
+in int bodyIndex;                           // per instance: which object this is (see classifyBodies)
+uniform int allBodies;                      // 1 for the overview: the object is gl_InstanceID, not bodyIndex
+uniform float minRadius;                    // for the overview: no object is drawn smaller than this
+uniform camera {
+    mat4 modelvMatrix;
+    mat4 projMatrix;
+};
+uniform samplerBuffer objectTransforms;     // two texels per object: rotation quaternion, translation and scale
+out vec3 quadPosition;
+flat out vec4 sphere;
+flat out vec4 rotation;
+flat out vec3 eyePosition;
+flat out int instanceID;
+
+const vec2 corners[4] = vec2[4](vec2(-1.0,-1.0), vec2(1.0,-1.0), vec2(-1.0,1.0), vec2(1.0,1.0));
+
+void main() {
+    // the mesh is a unit sphere, so the translation and scale are the centre and radius
+    int body = (allBodies != 0) ? gl_InstanceID : bodyIndex;
+    rotation = texelFetch(objectTransforms, 2*body);
+    sphere = texelFetch(objectTransforms, 2*body+1);
+    if (allBodies != 0 && sphere.w > 0.0) sphere.w = max(sphere.w, minRadius);   // a free slot stays a point
+    mat3 view = mat3(modelvMatrix);
+    eyePosition = -(modelvMatrix[3].xyz * view);            // the inverse rotation of the view's translation
+    vec3 toCentre = sphere.xyz - eyePosition;
+    float dist = length(toCentre);
+    vec3 forward = toCentre / dist;
+    vec3 right = normalize(cross(forward, vec3(view[0][1], view[1][1], view[2][1])));   // against the camera's up
+    vec3 up = cross(right, forward);
+    // the outline is a cone of half-angle asin(r/dist); at the centre's distance it is this wide
+    float halfSize = sphere.w * dist / sqrt(max(dist*dist - sphere.w*sphere.w, 1.0e-12));
+    quadPosition = sphere.xyz + halfSize * (corners[gl_VertexID].x*right + corners[gl_VertexID].y*up);
+    gl_Position = projMatrix * modelvMatrix * vec4(quadPosition, 1.0);
+    instanceID = body;
+}
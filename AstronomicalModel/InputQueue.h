@@ -0,0 +1,114 @@
+//
+//  InputQueue.h
+//  AstronomicalModel
+//
+//  Created by Matthew McGuire on 10/19/26.
+//  Copyright (c) 2026 Matthew McGuire. All rights reserved.
+//
+
+#ifndef AstronomicalModel_InputQueue_h
+#define AstronomicalModel_InputQueue_h
+
+#include <algorithm>
+
+/*---  (BEGIN) InputQueue Class ---*/
+// Mouse events as GLFW delivered them, each stamped with the time it arrived. The callbacks only
+// push; the frame takes them all at once, just before it latches the camera (see processInput).
+// GLFW calls back on the main thread, inside glfwPollEvents, so nothing here is locked. A fixed
+// ring: when it is full the oldest event is dropped, and counted.
+enum InputKinds {CURSORMOVED, BUTTONCHANGED, SCROLLED};
+struct InputEvent
+{
+    double time;                    // glfwGetTime() when the callback ran
+    int kind;
+    double x, y;                    // the cursor (or, scrolled, the offsets)
+    int button, action;
+};
+class InputQueue
+{
+public:
+    static const int capacity = 256;
+    InputQueue() : head(0), count(0), dropped(0) {}
+    void push(const InputEvent&);
+    bool pop(InputEvent&);
+    int waiting(void) { return count; }
+    long droppedEvents(void) { return dropped; }
+private:
+    InputEvent events[capacity];
+    int head, count;                // the oldest event, and how many follow it
+    long dropped;
+};
+void InputQueue::push(const InputEvent& event)
+{
+    if (count == capacity) {
+        head = (head + 1) % capacity;
+        count--;
+        dropped++;
+    }
+    events[(head + count) % capacity] = event;
+    count++;
+}
+bool InputQueue::pop(InputEvent& event)
+{
+    if (count == 0) return false;
+    event = events[head];
+    head = (head + 1) % capacity;
+    count--;
+    return true;
+}
+/*---  (END) InputQueue Class ---*/
+
+/*---  (BEGIN) LatencyTracker Class ---*/
+// The last 'capacity' frames that carried camera input, each with the time from its earliest
+// event to when the camera was latched, to when the frame was handed to the swap, and to when
+// the GPU finished drawing it (the nearest to the photons that can be measured), in seconds.
+struct LatencySample
+{
+    double toLatch, toSubmit, toPresent;
+};
+class LatencyTracker
+{
+public:
+    static const int capacity = 128;
+    LatencyTracker() : next(0), filled(0) {}
+    void record(const LatencySample& sample)
+    {
+        samples[next] = sample;
+        next = (next + 1) % capacity;
+        filled = std::min(filled + 1, capacity);
+    }
+    int count(void) { return filled; }
+    const LatencySample& last(void) { return samples[(next + capacity - 1) % capacity]; }
+    LatencySample mean(void);
+    LatencySample worst(void);
+private:
+    LatencySample samples[capacity];
+    int next, filled;
+};
+LatencySample LatencyTracker::mean(void)
+{
+    LatencySample total = {0.0, 0.0, 0.0};
+    for (int i = 0; i < filled; i++) {
+        total.toLatch += samples[i].toLatch;
+        total.toSubmit += samples[i].toSubmit;
+        total.toPresent += samples[i].toPresent;
+    }
+    if (filled > 0) {
+        total.toLatch /= filled;
+        total.toSubmit /= filled;
+        total.toPresent /= filled;
+    }
+    return total;
+}
+LatencySample LatencyTracker::worst(void)
+{
+    LatencySample most = {0.0, 0.0, 0.0};
+    for (int i = 0; i < filled; i++) {
+        most.toLatch = std::max(most.toLatch, samples[i].toLatch);
+        most.toSubmit = std::max(most.toSubmit, samples[i].toSubmit);
+        most.toPresent = std::max(most.toPresent, samples[i].toPresent);
+    }
+    return most;
+}
+/*---  (END) LatencyTracker Class ---*/
+#endif
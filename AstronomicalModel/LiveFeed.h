@@ -0,0 +1,256 @@
+//
+//  LiveFeed.h
+//  AstronomicalModel
+//
+//  Created by Matthew McGuire on 10/19/26.
+//  Copyright (c) 2026 Matthew McGuire. All rights reserved.
+//
+
+#ifndef AstronomicalModel_LiveFeed_h
+#define AstronomicalModel_LiveFeed_h
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <string>
+#include <iostream>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+/*---  (BEGIN) LiveFeed Classes ---*/
+// The objects' positions, orientations and radii, with the simulation time, in a POSIX shared memory
+// segment that other processes on the machine map and read while the app runs. The app writes it
+// each step (LiveFeedWriter); a reader (LiveFeedReader) needs nothing but this header: it includes
+// no GL and no part of the model, and it never blocks the writer or talks to it.
+//
+// Segment layout (native byte order):
+//   LiveFeedHeader                      magic "ASTRFEED", version, capacity, the sequence, the frame's
+//                                       step, simulation time and count
+//   float[capacity] x numFeedArrays     one array per quantity (structure of arrays), 64-byte aligned
+// A frame is guarded by a sequence lock: the sequence is odd while the writer is filling the arrays
+// and is moved on to the next even number when it is done. A reader notes the sequence, reads,
+// and keeps what it read only if the sequence was even and is still the same; so it never keeps a
+// torn frame, and the writer never waits for anyone. When the objects outgrow the segment the
+// writer marks it retired and makes a bigger one under the same name, and readers open it again.
+enum LiveFeedArrays {FEEDX, FEEDY, FEEDZ, FEEDQX, FEEDQY, FEEDQZ, FEEDQW, FEEDRADIUS, numFeedArrays};
+struct LiveFeedHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t capacity;                      // objects each array has room for
+    std::atomic<uint64_t> sequence;         // odd while a frame is being written
+    std::atomic<uint32_t> retired;          // 1 once the writer has moved to a new segment
+    uint32_t count;                         // objects in this frame (free slots have radius 0)
+    uint64_t step;                          // frames written since the feed was opened
+    double simulationMinutes;               // the time the positions belong to
+    int64_t publishedNanoseconds;           // steady clock when the frame was finished
+};
+const uint32_t liveFeedVersion = 1;
+const size_t liveFeedAlign = 64;
+inline size_t liveFeedArrayOffset(uint32_t capacity, int which)
+{
+    size_t first = (sizeof(LiveFeedHeader) + liveFeedAlign - 1) / liveFeedAlign * liveFeedAlign;
+    size_t stride = (sizeof(float) * capacity + liveFeedAlign - 1) / liveFeedAlign * liveFeedAlign;
+    return first + stride * which;
+}
+inline size_t liveFeedSize(uint32_t capacity) { return liveFeedArrayOffset(capacity, numFeedArrays); }
+inline int64_t liveFeedNow(void)            // the clock publishedNanoseconds is on, the same in every process
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+class LiveFeedWriter
+{
+public:
+    LiveFeedWriter() : header(NULL), size(0), steps(0) {}
+    ~LiveFeedWriter() { close(); }
+    bool open(const char*, uint32_t);       // make (or make again) the named segment with room for so many
+    void close(void);                       // retire the segment and remove its name
+    bool isOpen(void) { return header != NULL; }
+    uint32_t capacity(void) { return header != NULL ? header->capacity : 0; }
+    bool beginFrame(uint32_t);              // before the arrays are written; grows the segment if needed
+    float* array(int which) { return (float*) ((char*) header + liveFeedArrayOffset(header->capacity, which)); }
+    void endFrame(double);                  // the arrays are written: publish them, as of this simulation time
+private:
+    std::string name;
+    LiveFeedHeader* header;
+    size_t size;
+    uint64_t steps;
+    uint32_t frameCount;
+};
+bool LiveFeedWriter::open(const char* feedName, uint32_t objects)
+{
+    close();
+    name = feedName;
+    uint32_t room = objects + objects/2 + 64;
+    shm_unlink(feedName);                   // one left by a run that did not close it
+    int fd = shm_open(feedName, O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        std::cerr << "Live feed " << feedName << " could not be made." << std::endl;
+        return false;
+    }
+    size = liveFeedSize(room);
+    void* mapping = MAP_FAILED;
+    if (ftruncate(fd, off_t(size)) == 0)
+        mapping = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        std::cerr << "Live feed " << feedName << " could not be mapped." << std::endl;
+        shm_unlink(feedName);
+        size = 0;
+        return false;
+    }
+    header = (LiveFeedHeader*) mapping;
+    header->version = liveFeedVersion;
+    header->capacity = room;
+    header->sequence.store(0, std::memory_order_relaxed);
+    header->retired.store(0, std::memory_order_relaxed);
+    header->count = 0;
+    header->step = steps;
+    header->simulationMinutes = 0.0;
+    header->publishedNanoseconds = 0;
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(header->magic, "ASTRFEED", 8);   // last: a reader takes the segment once it sees this
+    return true;
+}
+void LiveFeedWriter::close(void)
+{
+    if (header == NULL) return;
+    header->retired.store(1, std::memory_order_release);
+    munmap(header, size);
+    shm_unlink(name.c_str());
+    header = NULL;
+    size = 0;
+}
+bool LiveFeedWriter::beginFrame(uint32_t count)
+{
+    if (header == NULL) return false;
+    if (count > header->capacity) {
+        std::string again = name;
+        if (!open(again.c_str(), count)) return false;
+    }
+    frameCount = count;
+    uint64_t s = header->sequence.load(std::memory_order_relaxed);
+    header->sequence.store(s + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);    // the odd sequence is seen before any new value
+    return true;
+}
+void LiveFeedWriter::endFrame(double simulationMinutes)
+{
+    header->count = frameCount;
+    header->step = ++steps;
+    header->simulationMinutes = simulationMinutes;
+    header->publishedNanoseconds = liveFeedNow();
+    header->sequence.store(header->sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+// A whole frame, as copied out by LiveFeedReader::read
+struct LiveFeedFrame
+{
+    uint64_t step;
+    double simulationMinutes;
+    int64_t publishedNanoseconds;
+    uint32_t count;
+    std::vector<float> arrays[numFeedArrays];
+};
+class LiveFeedReader
+{
+public:
+    long retries;                           // reads begun again because the writer was in the middle of a frame
+    long reopened;                          // times the writer moved to a new segment
+    LiveFeedReader() : retries(0), reopened(0), header(NULL), size(0) {}
+    ~LiveFeedReader() { close(); }
+    bool open(const char*);                 // map the named feed; false if there is none (yet)
+    void close(void);
+    bool read(LiveFeedFrame&);              // copy out the latest whole frame
+    // Zero-copy: read the arrays in place between begin and stillValid, and keep what was read
+    // only if stillValid replies true. begin replies false if there is no segment to read.
+    bool begin(uint64_t&);
+    const float* array(int which) const { return (const float*) ((const char*) header + liveFeedArrayOffset(capacity, which)); }
+    const LiveFeedHeader& frame(void) const { return *header; }
+    bool stillValid(uint64_t) const;
+private:
+    std::string name;
+    const LiveFeedHeader* header;
+    size_t size;
+    uint32_t capacity;
+};
+bool LiveFeedReader::open(const char* feedName)
+{
+    close();
+    name = feedName;
+    int fd = shm_open(feedName, O_RDONLY, 0);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || size_t(info.st_size) < sizeof(LiveFeedHeader)) {
+        ::close(fd);
+        return false;
+    }
+    size = size_t(info.st_size);
+    void* mapping = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        size = 0;
+        return false;
+    }
+    header = (const LiveFeedHeader*) mapping;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    capacity = header->capacity;
+    if (memcmp(header->magic, "ASTRFEED", 8) != 0 || header->version != liveFeedVersion || liveFeedSize(capacity) > size) {
+        close();
+        return false;
+    }
+    return true;
+}
+void LiveFeedReader::close(void)
+{
+    if (header != NULL) munmap((void*) header, size);
+    header = NULL;
+    size = 0;
+}
+bool LiveFeedReader::begin(uint64_t& sequence)
+{
+    for (;;) {
+        if (header == NULL || header->retired.load(std::memory_order_acquire)) {
+            if (name.empty()) return false;
+            if (header != NULL) reopened++;
+            std::string again = name;
+            if (!open(again.c_str())) return false;
+        }
+        sequence = header->sequence.load(std::memory_order_acquire);
+        if ((sequence & 1) == 0) return true;
+        retries++;
+        std::this_thread::yield();          // the writer may be waiting for this core to finish the frame
+    }
+}
+bool LiveFeedReader::stillValid(uint64_t sequence) const
+{
+    std::atomic_thread_fence(std::memory_order_acquire);    // every read of the frame is done before the check
+    return header->sequence.load(std::memory_order_relaxed) == sequence;
+}
+bool LiveFeedReader::read(LiveFeedFrame& out)
+{
+    uint64_t sequence;
+    for (;;) {
+        if (!begin(sequence)) return false;
+        uint32_t count = std::min(header->count, capacity);
+        out.step = header->step;
+        out.simulationMinutes = header->simulationMinutes;
+        out.publishedNanoseconds = header->publishedNanoseconds;
+        out.count = count;
+        for (int a = 0; a < numFeedArrays; a++) {
+            out.arrays[a].resize(count);
+            if (count > 0) memcpy(&out.arrays[a].front(), array(a), sizeof(float) * count);
+        }
+        if (stillValid(sequence)) return true;
+        retries++;
+    }
+}
+/*---  (END) LiveFeed Classes ---*/
+#endif
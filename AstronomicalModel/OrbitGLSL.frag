@@ -0,0 +1,7 @@
+#version 330
+in vec4 colour;
+out vec4 fColor;
+
+void main() {
+    fColor = colour;
+}
@@ -0,0 +1,43 @@
+#version 330
+// Orbit paths and trails, drawn without any vertex buffer: one line-strip instance per
+// body, with every vertex position worked out from gl_VertexID.
+uniform camera {
+    mat4 modelvMatrix;
+    mat4 projMatrix;
+};
+uniform samplerBuffer bodySpheres;      // xyz = current centre of each body (the same buffer program[0] uses)
+uniform samplerBuffer orbitParams;      // x = parent index, y = orbit radius (as specified, in km)
+uniform samplerBuffer trailPoints;      // ring buffer of past centres: slot s of body b is texel s*numBodies+b
+uniform int numBodies;
+uniform int orbitPart;                  // 0 = orbit paths, 1 = trails
+uniform int orbitSegments;
+uniform int trailLength;                // slots in the ring buffer
+uniform int trailHead;                  // slot written most recently
+uniform int trailFilled;                // slots written so far (at most trailLength)
+uniform int selectedObject;
+uniform float scaleFactor;              // viewing scale exponent, as in AstroObject::viewingScale
+out vec4 colour;
+
+const float twoPi = 6.28318531;
+
+void main() {
+    int body = gl_InstanceID + 1;       // the Sun (body 0) has neither orbit nor trail
+    colour = (body == selectedObject) ? vec4(1.0, 1.0, 0.6, 0.9) : vec4(0.35, 0.45, 0.6, 0.5);
+    vec3 position;
+    if (orbitPart == 0) {
+        // a circle in the x-z plane about the parent's current centre, as in AstroObject::incremObject
+        vec4 orbit = texelFetch(orbitParams, body);
+        vec3 centre = texelFetch(bodySpheres, int(orbit.x)).xyz;
+        float angle = twoPi * float(gl_VertexID) / float(orbitSegments);
+        float radius = orbit.y > 0.0 ? pow(orbit.y, scaleFactor) : 0.0;
+        position = centre + radius * vec3(cos(angle), 0.0, -sin(angle));
+    }
+    else {
+        // vertex 0 is the oldest point; vertices past the filled part repeat the newest one
+        int age = max(trailFilled - 1 - gl_VertexID, 0);
+        int slot = (trailHead - age + trailLength) % trailLength;
+        position = texelFetch(trailPoints, slot*numBodies + body).xyz;
+        colour.a *= 1.0 - float(age)/float(trailLength);
+    }
+    gl_Position = projMatrix * modelvMatrix * vec4(position, 1.0);
+}
@@ -0,0 +1,82 @@
+//
+//  OrbitModel.h
+//  AstronomicalModel
+//
+//  Created by Matthew McGuire on 10/19/26.
+//  Copyright (c) 2026 Matthew McGuire. All rights reserved.
+//
+
+#ifndef AstronomicalModel_OrbitModel_h
+#define AstronomicalModel_OrbitModel_h
+
+#include <vector>
+
+/*---  (BEGIN) OrbitModel Class ---*/
+// A copy of an AstroGroup's orbits that can be evaluated at any time, without
+// stepping. Every orbit in AstroObject is a circle about the parent in the x-z
+// plane, so a relative position is just (r cos θ, 0, -r sin θ) with θ growing
+// linearly in time. Times are in minutes from the moment of capture.
+struct OrbitModel
+{
+    std::vector<int> parent;
+    std::vector<double> radius;         // body radius
+    std::vector<double> orbitRadius;
+    std::vector<double> rate;           // radians per minute
+    std::vector<double> phase;          // orbit angle at time zero
+    std::vector<double> tilt;           // of the spin axis, about z (radians)
+    std::vector<double> spinRate;       // radians per minute
+    std::vector<double> spinPhase;      // rotation angle at time zero
+    std::vector<int> order;             // the objects held, every parent before its children
+    std::vector<bool> held;             // false for a free slot of the group
+    void capture(AstroGroup&, bool);    // true = use the viewing scale, false = true sizes (km)
+    glm::dvec3 positionAt(int, double) const;
+    glm::dquat orientationAt(int, double) const;    // as in the body's modelTransform: spun, then tilted
+    int size(void) const { return int(parent.size()); }
+};
+
+void OrbitModel::capture(AstroGroup& group, bool viewingScale)
+{
+    int n = group.numObjects;
+    parent = group.parentOf;
+    radius.resize(n);
+    orbitRadius.resize(n);
+    rate.resize(n);
+    phase.resize(n);
+    tilt.resize(n);
+    spinRate.resize(n);
+    spinPhase.resize(n);
+    held.resize(n);
+    order.clear();
+    for (size_t k = 0; k < group.order.size(); k++)
+        if (group.montum.valid(group.order[k])) order.push_back(group.order[k].slot);
+    float scale = group.currentScaleFactor();   // the objects may not have taken it yet (see AstroGroup::adjustScale)
+    for (int i = 0; i < n; i++) {
+        held[i] = group.alive(i);
+        AstroObject& obj = group.montum[i];
+        radius[i] = viewingScale ? float(pow(obj.trueRadius(), scale)) : obj.trueRadius();
+        orbitRadius[i] = viewingScale ? float(pow(obj.trueOrbitRadius(), scale)) : obj.trueOrbitRadius();
+        rate[i] = obj.orbitRate();
+        phase[i] = obj.currentOrbitAngle;
+        tilt[i] = obj.tilt();
+        spinRate[i] = obj.rotationRate();
+        spinPhase[i] = obj.currentRotAngle;
+    }
+}
+
+glm::dvec3 OrbitModel::positionAt(int body, double minutes) const
+{
+    glm::dvec3 pos(0.0);
+    for (int i = body; i >= 0; i = parent[i]) {
+        double angle = phase[i] + rate[i]*minutes;
+        pos += glm::dvec3(orbitRadius[i]*cos(angle), 0.0, -orbitRadius[i]*sin(angle));
+    }
+    return pos;
+}
+
+glm::dquat OrbitModel::orientationAt(int body, double minutes) const
+{
+    double spin = 0.5*(spinPhase[body] + spinRate[body]*minutes), half = 0.5*tilt[body];
+    return glm::dquat(cos(half), 0.0, 0.0, sin(half)) * glm::dquat(cos(spin), 0.0, sin(spin), 0.0);
+}
+/*---  (END) OrbitModel Class ---*/
+#endif
@@ -0,0 +1,7 @@
+#version 330
+uniform vec4 markerColour;
+out vec4 fColor;
+
+void main() {
+    fColor = markerColour;
+}
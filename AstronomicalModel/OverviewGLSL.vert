@@ -0,0 +1,13 @@
+#version 330
+// The main camera's place in the overview inset: a line from the eye to the point it looks at,
+// then the eye alone as a point. Two vertices, both from gl_VertexID.
+uniform camera {
+    mat4 modelvMatrix;
+    mat4 projMatrix;
+};
+uniform vec3 markerEnds[2];             // the main camera's eye, and the point it looks at
+
+void main() {
+    gl_Position = projMatrix * modelvMatrix * vec4(markerEnds[gl_VertexID], 1.0);
+    gl_PointSize = 7.0;
+}
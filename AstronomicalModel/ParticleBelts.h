@@ -0,0 +1,85 @@
+//
+//  ParticleBelts.h
+//  AstronomicalModel
+//
+//  Created by Matthew McGuire on 10/19/26.
+//  Copyright (c) 2026 Matthew McGuire. All rights reserved.
+//
+
+#ifndef AstronomicalModel_ParticleBelts_h
+#define AstronomicalModel_ParticleBelts_h
+
+#include <vector>
+
+/*---  (BEGIN) ParticleBelts Class ---*/
+// Asteroid belts and planetary rings as clouds of particles whose orbits never change.
+// Each particle's orbit is written once into a static vertex buffer; the vertex shader
+// (ParticleGLSL.vert) places it from the simulation time alone, so the CPU work and the
+// data sent each frame do not depend on how many particles there are.
+//
+// Orbits are circles about the parent's centre, as for AstroObject, but tilted a little:
+// the particle rises and falls by radius*tilt*sin(angle - node) as it goes around.
+struct ParticleOrbit
+{
+    float orbitRadius;      // km from the parent; the shader applies the viewing scale
+    float phase;            // orbit angle at the particles' epoch (radians)
+    float rate;             // radians per minute
+    float tilt;             // small-angle inclination (radians)
+    float node;             // orbit angle at which the particle crosses the parent's plane upward
+    float parent;           // index in montum of the body at the centre
+};
+
+class ParticleBelts
+{
+public:
+    std::vector<ParticleOrbit> orbits;
+    // A belt of 'count' particles between two orbit radii (km) about 'parent'. The period
+    // at the inner edge is in years, as for AstroObject's orbitSpeed, and grows outward
+    // as radius^1.5 (Kepler's third law).
+    void addBelt(int parent, float innerKm, float outerKm, int count, float innerPeriod, float maxTilt, unsigned int seed);
+    void addDefaultBelts(AstroGroup&, int);     // main belt, Kuiper belt and a ring around Jupiter
+    void release(void);                         // free the CPU copy once it is on the GPU
+    GLsizei size(void) { return GLsizei(orbits.size()); }
+};
+
+void ParticleBelts::addBelt(int parent, float innerKm, float outerKm, int count, float innerPeriod, float maxTilt, unsigned int seed)
+{
+    srand(seed);
+    orbits.reserve(orbits.size() + count);
+    for (int i = 0; i < count; i++) {
+        // uniform over the belt's area, so the density does not pile up at the inner edge
+        float u = float(rand())/RAND_MAX;
+        float r = sqrt(innerKm*innerKm + u*(outerKm*outerKm - innerKm*innerKm));
+        ParticleOrbit p;
+        p.orbitRadius = r;
+        p.phase = twoPi * float(rand())/RAND_MAX;
+        p.rate = orbitPerInc / (innerPeriod * pow(r/innerKm, 1.5f));
+        p.tilt = maxTilt * float(rand())/RAND_MAX;
+        p.node = twoPi * float(rand())/RAND_MAX;
+        p.parent = float(parent);
+        orbits.push_back(p);
+    }
+}
+
+// 'total' particles shared out as 60% main belt, 30% Kuiper belt and 10% ring
+void ParticleBelts::addDefaultBelts(AstroGroup& group, int total)
+{
+    const float AU = 149600000.0;
+    addBelt(0, 2.1*AU, 3.3*AU, int(0.6*total), pow(2.1f, 1.5f), 0.3, 11);
+    addBelt(0, 30.0*AU, 50.0*AU, int(0.3*total), pow(30.0f, 1.5f), 0.35, 12);
+    int jupiter = -1;
+    for (int i = 0; i < group.numObjects; i++)
+        if (group.montum[i].name == "Jupiter") jupiter = i;
+    if (jupiter >= 0) {
+        // rings sit just outside the planet, and a particle there goes around in about 7 hours
+        float r = group.montum[jupiter].trueRadius();
+        addBelt(jupiter, 1.3*r, 2.2*r, total - int(0.6*total) - int(0.3*total), 7.0/(365.25*24.0), 0.002, 13);
+    }
+}
+
+void ParticleBelts::release(void)
+{
+    std::vector<ParticleOrbit>().swap(orbits);
+}
+/*---  (END) ParticleBelts Class ---*/
+#endif
@@ -0,0 +1,25 @@
+#version 330
+// Belt and ring particles. Nothing about a particle changes after it is uploaded: its
+// position now comes from its fixed orbit, the simulation time, and the parent's centre.
+in vec4 particleOrbit;                  // orbit radius (km), phase, rate (radians per minute), tilt
+in vec2 particleNode;                   // x = node angle, y = parent index
+uniform camera {
+    mat4 modelvMatrix;
+    mat4 projMatrix;
+};
+uniform samplerBuffer bodySpheres;      // xyz = current centre of each body
+uniform float simMinutes;               // simulation time since the particles' epoch, kept small
+uniform float scaleFactor;              // viewing scale exponent, as in AstroObject::viewingScale
+out vec4 colour;
+
+void main() {
+    vec3 centre = texelFetch(bodySpheres, int(particleNode.y)).xyz;
+    float angle = particleOrbit.y + particleOrbit.z * simMinutes;
+    float r = pow(particleOrbit.x, scaleFactor);
+    vec3 offset = r * vec3(cos(angle), particleOrbit.w * sin(angle - particleNode.x), -sin(angle));
+    gl_Position = projMatrix * modelvMatrix * vec4(centre + offset, 1.0);
+    gl_PointSize = 1.0;
+    // rock for the belts around the Sun, ice for rings; a little variety from the vertex number
+    float shade = 0.6 + 0.4 * fract(sin(float(gl_VertexID) * 12.9898) * 43758.5453);
+    colour = vec4(shade * ((particleNode.y < 0.5) ? vec3(0.55, 0.48, 0.40) : vec3(0.80, 0.78, 0.72)), 1.0);
+}
@@ -0,0 +1,17 @@
+#version 330
+// Moves every belt and ring particle's phase on to a new epoch: one vertex per particle, nothing
+// rasterised. Transform feedback writes each particle, in the layout of ParticleOrbit, into the
+// other particle buffer, so the clock of ParticleGLSL.vert can start again from zero.
+in vec4 particleOrbit;                  // orbit radius (km), phase, rate (radians per minute), tilt
+in vec2 particleNode;                   // x = node angle, y = parent index
+uniform float rebaseMinutes;            // from the old epoch to the new
+out vec4 rebasedOrbit;
+out vec2 rebasedNode;
+
+const float twoPi = 6.28318530718;
+
+void main() {
+    float phase = mod(particleOrbit.y + particleOrbit.z * rebaseMinutes, twoPi);
+    rebasedOrbit = vec4(particleOrbit.x, phase, particleOrbit.zw);
+    rebasedNode = particleNode;
+}
@@ -0,0 +1,447 @@
+//
+//  PlanetTerrain.h
+//  AstronomicalModel
+//
+//  Created by Matthew McGuire on 10/19/26.
+//  Copyright (c) 2026 Matthew McGuire. All rights reserved.
+//
+
+#ifndef AstronomicalModel_PlanetTerrain_h
+#define AstronomicalModel_PlanetTerrain_h
+
+#include <vector>
+#include <map>
+#include <set>
+#include <deque>
+#include <algorithm>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+/*---  (BEGIN) PlanetTerrain Class ---*/
+// Close-up surfaces for objects that fill much of the window. Each object's surface is a
+// quadtree on each of the six faces of a cube (laid out as in CubeSphere): a patch is a
+// grid x grid square of the face, drawn in TerrainGLSL.vert as a grid pushed out to the
+// sphere and raised by a height tile of (grid+1)^2 samples, one per vertex.
+//
+// Every frame the quadtrees are walked from the six roots and a patch is split while its
+// vertex spacing would look bigger than maxPixelError on screen, but only once all four of
+// its children's tiles are on the GPU. Tiles that are missing are asked for, and read by a
+// loader thread (coarsest first) from
+//     <directory>/<object index>/<face>_<level>_<x>_<y>.r32    (raw floats, row by row)
+// or made up from noise if there is no such file. They are kept in the layers of one texture
+// array, as many as the memory budget allows, and the tile drawn least recently is replaced.
+//
+// Where a patch meets a coarser one, the vertices the coarser one lacks are moved onto its
+// edge in the shader, so the two meet without cracks; each patch carries, for each of its
+// four edges, how many levels coarser the patch across that edge is.
+struct TerrainKey
+{
+    int level, body, face, x, y;    // in this order, so that coarser tiles sort first
+    TerrainKey() : level(0), body(-1), face(0), x(0), y(0) {}
+    TerrainKey(int b, int f, int l, int px, int py) : level(l), body(b), face(f), x(px), y(py) {}
+    bool operator<(const TerrainKey& k) const {
+        if (level != k.level) return level < k.level;
+        if (body != k.body) return body < k.body;
+        if (face != k.face) return face < k.face;
+        if (x != k.x) return x < k.x;
+        return y < k.y;
+    }
+    TerrainKey child(int k) const { return TerrainKey(body, face, level+1, 2*x + (k&1), 2*y + (k>>1)); }
+    float size(void) const { return 2.0f / float(1 << level); }     // faces run from -1 to 1
+    float u0(void) const { return -1.0f + x*size(); }
+    float v0(void) const { return -1.0f + y*size(); }
+};
+struct TerrainTile
+{
+    TerrainKey key;
+    int layer;
+    std::vector<float> heights;     // (grid+1)^2, from -1 to 1
+};
+struct TerrainPatch                 // one instance for TerrainGLSL.vert
+{
+    GLfloat u0, v0, size;           // where it is on its cube face
+    GLint face, body, layer;        // its object (index in montum) and its height tile's layer
+    GLint edges;                    // 4 bits per edge (v0, u0+size, v0+size, u0 sides): levels to the coarser neighbour
+};
+
+class PlanetTerrain
+{
+private:
+    std::map<TerrainKey, int> resident;     // tiles in the texture array, and their layers
+    std::vector<TerrainKey> layerTile;
+    std::vector<unsigned int> layerFrame;   // the frame each layer was last drawn in
+    std::vector<glm::vec2> layerHeights;    // the lowest and highest height in each layer's tile
+    std::vector<int> freeLayers;
+    unsigned int frame;
+    std::set<TerrainKey> drawn;             // this frame's patches
+    glm::vec4 frustum[6];                   // this frame's clip planes, inside where positive
+    std::vector<TerrainKey> drawList;
+    std::set<TerrainKey> wanted;            // tiles asked for since the last endFrame
+    std::thread loader;
+    std::mutex lock;
+    std::condition_variable wake;
+    std::set<TerrainKey> queue;             // for the loader, coarsest first
+    std::set<TerrainKey> loading;           // queued, being read, or read and not yet taken
+    std::deque<TerrainTile> loaded;
+    bool stopping;
+    void loaderLoop(void);
+    void request(const TerrainKey&);
+    void selectPatch(const TerrainKey&, const CompactTransform&, point3, float, float);
+    int neighbourLevel(const TerrainKey&, int);
+    static void faceAxes(int, point3&, point3&, point3&);
+public:
+    int grid;                       // squares along a patch's side (a power of two)
+    int maxLevel;
+    float heightScale;              // the greatest height, as a fraction of the radius
+    size_t budgetBytes;             // for the texture array of height tiles
+    int maxQueued;                  // tiles waiting for the loader at any time
+    std::string directory;
+    std::vector<TerrainPatch> patches;      // this frame's, after endFrame
+    PlanetTerrain();
+    ~PlanetTerrain();
+    size_t tileBytes(void);
+    int layersInBudget(void);
+    void start(int);                // with this many empty texture array layers; starts the loader
+    bool ready(int);                // are an object's six root tiles in? (asks for them if not)
+    void beginFrame(const glm::mat4&);      // with the view-projection matrix
+    void select(int, const CompactTransform&, point3, float, float);   // object, its transform, eye, pixels per unit at unit distance, error
+    void endFrame(void);            // hands the loader its work, and fills patches
+    int takeLoaded(std::vector<TerrainTile>&, int);     // up to n read tiles, each given a layer to go into
+    int residentTiles(void);
+    int waitingTiles(void);
+    void readTile(const TerrainKey&, std::vector<float>&);
+    static point3 cubeToSphere(int, float, float);
+    static float height(point3, int);
+};
+
+PlanetTerrain::PlanetTerrain()
+{
+    frame = 0;
+    stopping = false;
+    grid = 32;
+    maxLevel = 14;
+    heightScale = 0.01;
+    budgetBytes = 8 << 20;
+    maxQueued = 64;
+    directory = "terrain";
+}
+PlanetTerrain::~PlanetTerrain()
+{
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        stopping = true;
+    }
+    wake.notify_all();
+    if (loader.joinable()) loader.join();
+}
+
+size_t PlanetTerrain::tileBytes(void)
+{
+    return sizeof(float) * (grid+1) * (grid+1);
+}
+int PlanetTerrain::layersInBudget(void)
+{
+    return int(budgetBytes / tileBytes());
+}
+void PlanetTerrain::start(int layers)
+{
+    resident.clear();
+    layerTile.assign(layers, TerrainKey());
+    layerFrame.assign(layers, 0);
+    layerHeights.assign(layers, glm::vec2(-1.0, 1.0));
+    freeLayers.clear();
+    for (int i = layers-1; i >= 0; i--) freeLayers.push_back(i);
+    if (!loader.joinable()) loader = std::thread(&PlanetTerrain::loaderLoop, this);
+}
+
+// The axes of a cube face, as CubeSphere has them: it faces along 'normal', and u and v run along 'across' and 'up'
+void PlanetTerrain::faceAxes(int face, point3& normal, point3& across, point3& up)
+{
+    int axis = face / 2;
+    float side = (face % 2 == 0) ? 1.0 : -1.0;
+    normal = across = up = point3(0.0);
+    normal[axis] = side;
+    across[(axis+1)%3] = side;
+    up[(axis+2)%3] = 1.0;
+}
+point3 PlanetTerrain::cubeToSphere(int face, float u, float v)
+{
+    point3 normal, across, up;
+    faceAxes(face, normal, across, up);
+    point3 p = normal + u*across + v*up;
+    point3 q = p*p;
+    return glm::normalize(point3(p.x*sqrt(1.0 - 0.5*q.y - 0.5*q.z + q.y*q.z/3.0),
+                                 p.y*sqrt(1.0 - 0.5*q.z - 0.5*q.x + q.z*q.x/3.0),
+                                 p.z*sqrt(1.0 - 0.5*q.x - 0.5*q.y + q.x*q.y/3.0)));
+}
+
+// Made-up terrain: noise summed over twenty octaves, each half as strong and twice as fine as
+// the last, so that there is something new to see at every level. From -1 to 1.
+static float terrainLattice(int x, int y, int z, int seed)
+{
+    unsigned int h = unsigned(x)*73856093u ^ unsigned(y)*19349663u ^ unsigned(z)*83492791u ^ unsigned(seed)*2654435761u;
+    h ^= h >> 13;
+    h *= 0x5bd1e995u;
+    h ^= h >> 15;
+    return float(h & 0xffffff) / 8388607.5f - 1.0f;
+}
+static float terrainNoise(double x, double y, double z, int seed)
+{
+    double fx = floor(x), fy = floor(y), fz = floor(z);
+    int ix = int(fx), iy = int(fy), iz = int(fz);
+    double tx = x-fx, ty = y-fy, tz = z-fz;
+    tx = tx*tx*(3.0-2.0*tx);
+    ty = ty*ty*(3.0-2.0*ty);
+    tz = tz*tz*(3.0-2.0*tz);
+    double value = 0.0;
+    for (int corner = 0; corner < 8; corner++) {
+        int dx = corner & 1, dy = (corner >> 1) & 1, dz = corner >> 2;
+        value += (dx ? tx : 1.0-tx) * (dy ? ty : 1.0-ty) * (dz ? tz : 1.0-tz) *
+                 terrainLattice(ix+dx, iy+dy, iz+dz, seed);
+    }
+    return float(value);
+}
+float PlanetTerrain::height(point3 dir, int body)
+{
+    double sum = 0.0, strength = 1.0, frequency = 2.0;
+    for (int octave = 0; octave < 20; octave++) {
+        sum += strength * terrainNoise(dir.x*frequency, dir.y*frequency, dir.z*frequency, body*31 + octave);
+        strength *= 0.5;
+        frequency *= 2.0;
+    }
+    return float(0.5*sum);
+}
+
+void PlanetTerrain::readTile(const TerrainKey& key, std::vector<float>& heights)
+{
+    heights.resize((grid+1)*(grid+1));
+    std::ostringstream path;
+    path << directory << "/" << key.body << "/" << key.face << "_" << key.level << "_" << key.x << "_" << key.y << ".r32";
+    std::ifstream in(path.str().c_str(), std::ios::binary);
+    if (in && in.read((char*) &heights.front(), tileBytes()) && in.gcount() == std::streamsize(tileBytes()))
+        return;
+    float size = key.size();
+    for (int j = 0; j <= grid; j++)
+        for (int i = 0; i <= grid; i++)
+            heights[j*(grid+1)+i] = height(cubeToSphere(key.face, key.u0() + size*i/grid, key.v0() + size*j/grid), key.body);
+}
+
+void PlanetTerrain::loaderLoop(void)
+{
+    while (true) {
+        TerrainTile tile;
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            while (!stopping && queue.empty())
+                wake.wait(guard);
+            if (stopping) return;
+            tile.key = *queue.begin();
+            queue.erase(queue.begin());
+        }
+        readTile(tile.key, tile.heights);
+        std::unique_lock<std::mutex> guard(lock);
+        loaded.push_back(tile);
+    }
+}
+
+void PlanetTerrain::request(const TerrainKey& key)
+{
+    if (resident.count(key) == 0) wanted.insert(key);
+}
+bool PlanetTerrain::ready(int body)
+{
+    bool allIn = true;
+    for (int face = 0; face < 6; face++) {
+        TerrainKey root(body, face, 0, 0, 0);
+        if (resident.count(root) == 0) {
+            request(root);
+            allIn = false;
+        }
+    }
+    return allIn;
+}
+
+void PlanetTerrain::beginFrame(const glm::mat4& viewProjection)
+{
+    for (int k = 0; k < 6; k++) {
+        int row = k / 2;
+        float side = (k % 2 == 0) ? 1.0 : -1.0;
+        glm::vec4 plane;
+        for (int column = 0; column < 4; column++)
+            plane[column] = viewProjection[column][3] + side*viewProjection[column][row];
+        frustum[k] = plane / glm::length(glm::vec3(plane));
+    }
+    frame++;
+    drawn.clear();
+    drawList.clear();
+}
+
+void PlanetTerrain::select(int body, const CompactTransform& place, point3 eye, float pixelsPerUnit, float maxPixelError)
+{
+    for (int face = 0; face < 6; face++) {
+        TerrainKey root(body, face, 0, 0, 0);
+        if (resident.count(root) == 0) request(root);
+        else selectPatch(root, place, eye, pixelsPerUnit, maxPixelError);
+    }
+}
+
+void PlanetTerrain::selectPatch(const TerrainKey& key, const CompactTransform& place, point3 eye, float pixelsPerUnit, float maxPixelError)
+{
+    float angle = 0.5*M_PI / float(1 << key.level);         // about the patch's width, seen from the centre
+    int layer = resident[key];
+    layerFrame[layer] = frame;                              // its tile is in use, drawn or not
+    point3 centreDir = place.rotation * cubeToSphere(key.face, key.u0() + 0.5*key.size(), key.v0() + 0.5*key.size());
+    point3 toEye = eye - place.translation;
+    float eyeDistance = glm::length(toEye);
+    // hidden below the horizon, allowing for the lowest valleys in front and the highest peaks on the patch
+    float lowest = place.scale*(1.0 - heightScale), highest = place.scale*(1.0 + heightScale);
+    if (eyeDistance > lowest) {
+        float visible = acos(lowest/eyeDistance) + acos(lowest/highest);
+        float apart = acos(glm::clamp(glm::dot(centreDir, toEye/eyeDistance), -1.0f, 1.0f));
+        if (apart - angle > visible) return;
+    }
+    // outside the view, as a sphere that holds it: the half-diagonal (with the evening-out's
+    // stretch) across, and the tile's own heights up and down, which shrink level by level
+    float low = 1.0 + heightScale*layerHeights[layer].x, high = 1.0 + heightScale*layerHeights[layer].y;
+    point3 centre = place.translation + (0.5f*place.scale*(low + high))*centreDir;
+    float reach = place.scale*(0.85*angle*high + 0.5*(high - low));
+    for (int k = 0; k < 6; k++)
+        if (glm::dot(glm::vec3(frustum[k]), centre) + frustum[k].w < -reach) return;
+    float distance = std::max(glm::length(centre - eye) - reach, 1.0e-6f*place.scale);
+    float spacing = place.scale * angle / grid;
+    if (key.level < maxLevel && spacing*pixelsPerUnit > maxPixelError*distance) {
+        bool childrenIn = true;
+        for (int k = 0; k < 4; k++)
+            if (resident.count(key.child(k)) == 0) {
+                request(key.child(k));
+                childrenIn = false;
+            }
+        if (childrenIn) {
+            for (int k = 0; k < 4; k++) selectPatch(key.child(k), place, eye, pixelsPerUnit, maxPixelError);
+            return;
+        }
+    }
+    drawList.push_back(key);
+    drawn.insert(key);
+}
+
+// The level of the drawn patch just across one edge of this one (found by looking for it from
+// this one's level up to the root), or this one's own level if the patches there are finer
+// (they fit themselves to this one) or not drawn
+int PlanetTerrain::neighbourLevel(const TerrainKey& key, int edge)
+{
+    float half = 0.5*key.size();
+    float beyond = half * (1.0 + 1.0/grid);
+    float u = key.u0() + half, v = key.v0() + half;
+    if (edge == 0) v -= beyond;
+    else if (edge == 1) u += beyond;
+    else if (edge == 2) v += beyond;
+    else u -= beyond;
+    // the point on the cube, and the face it is on now (it may have gone over the cube's edge)
+    point3 normal, across, up;
+    faceAxes(key.face, normal, across, up);
+    point3 p = normal + u*across + v*up;
+    int axis = 0;
+    for (int k = 1; k < 3; k++)
+        if (fabs(p[k]) > fabs(p[axis])) axis = k;
+    int face = 2*axis + (p[axis] < 0.0 ? 1 : 0);
+    p /= fabs(p[axis]);
+    faceAxes(face, normal, across, up);
+    u = glm::dot(p, across);
+    v = glm::dot(p, up);
+    for (int level = key.level; level >= 0; level--) {      // neighbours are seldom more than a level apart
+        int n = 1 << level;
+        int x = glm::clamp(int(0.5*(u+1.0)*n), 0, n-1), y = glm::clamp(int(0.5*(v+1.0)*n), 0, n-1);
+        if (drawn.count(TerrainKey(key.body, face, level, x, y)) > 0) return level;
+    }
+    return key.level;
+}
+
+void PlanetTerrain::endFrame(void)
+{
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        // what was asked for before and is not wanted now is dropped, unless it is being read already
+        for (std::set<TerrainKey>::iterator k = queue.begin(); k != queue.end(); k++) loading.erase(*k);
+        queue.clear();
+        for (std::set<TerrainKey>::iterator k = wanted.begin(); k != wanted.end() && int(queue.size()) < maxQueued; k++)
+            if (loading.count(*k) == 0) {
+                queue.insert(*k);
+                loading.insert(*k);
+            }
+    }
+    wake.notify_one();
+    wanted.clear();
+
+    int maxStep = 0;
+    while ((2 << maxStep) <= grid) maxStep++;
+    patches.resize(drawList.size());
+    for (size_t i = 0; i < drawList.size(); i++) {
+        const TerrainKey& key = drawList[i];
+        TerrainPatch& patch = patches[i];
+        patch.u0 = key.u0();
+        patch.v0 = key.v0();
+        patch.size = key.size();
+        patch.face = key.face;
+        patch.body = key.body;
+        patch.layer = resident[key];
+        patch.edges = 0;
+        for (int edge = 0; edge < 4; edge++)
+            patch.edges |= std::min(key.level - neighbourLevel(key, edge), maxStep) << (4*edge);
+    }
+}
+
+int PlanetTerrain::takeLoaded(std::vector<TerrainTile>& tiles, int most)
+{
+    tiles.clear();
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        while (!loaded.empty() && int(tiles.size()) < most) {
+            tiles.push_back(loaded.front());
+            loaded.pop_front();
+            loading.erase(tiles.back().key);
+        }
+    }
+    size_t kept = 0;
+    for (size_t t = 0; t < tiles.size(); t++) {
+        if (resident.count(tiles[t].key) > 0) continue;
+        int layer = -1;
+        if (!freeLayers.empty()) {
+            layer = freeLayers.back();
+            freeLayers.pop_back();
+        }
+        else {
+            // the tile drawn least recently, but not one drawn last frame
+            for (int i = 0; i < int(layerFrame.size()); i++)
+                if (layerFrame[i] < frame && (layer < 0 || layerFrame[i] < layerFrame[layer])) layer = i;
+            if (layer < 0) continue;        // every layer is in use: it will be asked for again
+            resident.erase(layerTile[layer]);
+        }
+        resident[tiles[t].key] = layer;
+        const std::vector<float>& h = tiles[t].heights;
+        layerHeights[layer] = glm::vec2(*std::min_element(h.begin(), h.end()), *std::max_element(h.begin(), h.end()));
+        layerTile[layer] = tiles[t].key;
+        layerFrame[layer] = frame;
+        tiles[t].layer = layer;
+        if (kept != t) std::swap(tiles[kept], tiles[t]);
+        kept++;
+    }
+    tiles.resize(kept);
+    return int(kept);
+}
+
+int PlanetTerrain::residentTiles(void)
+{
+    return int(resident.size());
+}
+int PlanetTerrain::waitingTiles(void)
+{
+    std::unique_lock<std::mutex> guard(lock);
+    return int(loading.size());
+}
+/*---  (END) PlanetTerrain Class ---*/
+#endif
@@ -0,0 +1,67 @@
+#version 330
+// Compiled twice: as FXAA, and with TAA defined as the temporal filter (see AntiAliasing.h).
+in vec2 screenUV;
+uniform sampler2D sceneColour;          // the scene, resolved to one sample a pixel
+uniform vec2 texelSize;                 // 1/width, 1/height
+out vec4 fColor;
+
+const vec3 lumaWeights = vec3(0.299, 0.587, 0.114);
+
+#ifdef TAA
+uniform sampler2D sceneDepth;
+uniform sampler2D history;              // what this filter wrote last frame
+uniform mat4 reprojection;              // this frame's clip space to the last one's
+uniform float historyWeight;            // 0 when there is no history to use
+
+void main() {
+    vec3 current = texture(sceneColour, screenUV).rgb;
+    // the history is clamped to the colours around the pixel now, so what has moved or been
+    // uncovered does not leave a trail
+    vec3 lowest = current, highest = current;
+    for (int y = -1; y <= 1; y++)
+        for (int x = -1; x <= 1; x++) {
+            vec3 near = texture(sceneColour, screenUV + vec2(x, y)*texelSize).rgb;
+            lowest = min(lowest, near);
+            highest = max(highest, near);
+        }
+    float depth = texture(sceneDepth, screenUV).r;
+    vec4 previous = reprojection * vec4(2.0*screenUV - 1.0, 2.0*depth - 1.0, 1.0);
+    vec2 previousUV = 0.5*previous.xy/previous.w + 0.5;
+    float weight = historyWeight;
+    if (any(lessThan(previousUV, vec2(0.0))) || any(greaterThan(previousUV, vec2(1.0)))) weight = 0.0;
+    vec3 past = clamp(texture(history, previousUV).rgb, lowest, highest);
+    fColor = vec4(mix(current, past, weight), 1.0);
+}
+#else
+// FXAA, in the short form of Lottes' console version: the luma of the four diagonal neighbours
+// gives the direction along an edge, and the pixel is blurred along it, by two taps or four,
+// whichever stays within the luma range around it.
+const float reduceMin = 1.0/128.0;
+const float reduceMul = 1.0/8.0;
+const float spanMax = 8.0;
+
+void main() {
+    vec3 rgbNW = texture(sceneColour, screenUV + vec2(-1.0, -1.0)*texelSize).rgb;
+    vec3 rgbNE = texture(sceneColour, screenUV + vec2(1.0, -1.0)*texelSize).rgb;
+    vec3 rgbSW = texture(sceneColour, screenUV + vec2(-1.0, 1.0)*texelSize).rgb;
+    vec3 rgbSE = texture(sceneColour, screenUV + vec2(1.0, 1.0)*texelSize).rgb;
+    vec3 rgbM = texture(sceneColour, screenUV).rgb;
+    float lumaNW = dot(rgbNW, lumaWeights), lumaNE = dot(rgbNE, lumaWeights);
+    float lumaSW = dot(rgbSW, lumaWeights), lumaSE = dot(rgbSE, lumaWeights);
+    float lumaM = dot(rgbM, lumaWeights);
+    float lumaMin = min(lumaM, min(min(lumaNW, lumaNE), min(lumaSW, lumaSE)));
+    float lumaMax = max(lumaM, max(max(lumaNW, lumaNE), max(lumaSW, lumaSE)));
+
+    vec2 dir = vec2(-((lumaNW + lumaNE) - (lumaSW + lumaSE)), (lumaNW + lumaSW) - (lumaNE + lumaSE));
+    float dirReduce = max((lumaNW + lumaNE + lumaSW + lumaSE) * 0.25 * reduceMul, reduceMin);
+    float rcpDirMin = 1.0/(min(abs(dir.x), abs(dir.y)) + dirReduce);
+    dir = clamp(dir*rcpDirMin, vec2(-spanMax), vec2(spanMax)) * texelSize;
+
+    vec3 rgbA = 0.5 * (texture(sceneColour, screenUV + dir*(1.0/3.0 - 0.5)).rgb +
+                       texture(sceneColour, screenUV + dir*(2.0/3.0 - 0.5)).rgb);
+    vec3 rgbB = 0.5*rgbA + 0.25 * (texture(sceneColour, screenUV - 0.5*dir).rgb +
+                                   texture(sceneColour, screenUV + 0.5*dir).rgb);
+    float lumaB = dot(rgbB, lumaWeights);
+    fColor = vec4((lumaB < lumaMin || lumaB > lumaMax) ? rgbA : rgbB, 1.0);
+}
+#endif
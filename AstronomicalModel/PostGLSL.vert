@@ -0,0 +1,10 @@
+#version 330
+// The post-pass over the resolved scene: one triangle that covers the window, drawn with no
+// vertex buffer, its corners (0,0), (2,0) and (0,2) in texture coordinates.
+out vec2 screenUV;
+
+void main() {
+    vec2 corner = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    screenUV = corner;
+    gl_Position = vec4(2.0*corner - 1.0, 0.0, 1.0);
+}
@@ -0,0 +1,190 @@
+//
+//  SceneManager.h
+//  AstronomicalModel
+//
+//  Created by Matthew McGuire on 10/19/26.
+//  Copyright (c) 2026 Matthew McGuire. All rights reserved.
+//
+
+#ifndef AstronomicalModel_SceneManager_h
+#define AstronomicalModel_SceneManager_h
+
+#include <deque>
+#include <vector>
+#include <string>
+#include "WorkPool.h"
+
+/*---  (BEGIN) SceneManager Class ---*/
+// Other star systems, each its own AstroGroup placed somewhere in the scene. They share
+// everything that can be shared: the one sphere (AstroGroup::s is static), and the impostor program,
+// texture and buffers they are drawn with (see drawSceneSystems); what each holds is its objects.
+//
+// step runs on a work-stealing pool, one task per system due a step. A system near the eye and in
+// view is stepped every time; one further off every 'cadence' times, a power of two that grows with
+// distance up to maxCadence; one out of view at maxCadence. A system that is passed over keeps the
+// minutes it missed and takes them all in its next step: every angle is a constant rate times time,
+// so nothing is lost but freshness. Cadences are staggered by system, so the work is spread evenly.
+struct StarSystem
+{
+    std::string name;
+    point3 position;                // of its star, in the scene
+    AstroGroup group;
+    GLfloat reach;                  // how far from its star any of its objects reaches
+    double owedMinutes;             // simulation minutes not yet stepped
+    int cadence;                    // stepped one time in this many
+    bool inView;
+    StarSystem(std::string n, point3 p, float scaleFact, const AstroObject& star)
+    : name(n), position(p), group(scaleFact, star), reach(0.0), owedMinutes(0.0), cadence(1), inView(true) {}
+};
+class SceneManager
+{
+public:
+    std::deque<StarSystem> systems;         // a deque, so adding one never moves the others
+    GLfloat nearDistance;                   // systems closer than this (and in view) step every time
+    int maxCadence;
+    GLboolean reducedCadence;               // off: every system steps every time
+    std::vector<CompactTransform> transforms;   // every object of the systems in view, placed in the scene
+    std::vector<glm::vec4> stars;           // for each of them its star's centre and radius (negative for the star itself)
+    GLboolean changed;                      // transforms and stars were gathered again since they were last sent
+    int lastStepped;                        // systems stepped in the last step
+    long lastObjectsStepped;
+    SceneManager(int threads) : nearDistance(3000.0), maxCadence(16), reducedCadence(GL_TRUE), changed(GL_FALSE),
+                     lastStepped(0), lastObjectsStepped(0), workers(threads), pool(NULL), frame(0) {}
+    ~SceneManager() { if (pool != NULL) releasePool(pool); }
+    StarSystem& addSystem(std::string, point3, float, const AstroObject&);
+    void addSyntheticSystems(int, float, float, float, unsigned int);
+    void step(float, point3, const glm::mat4&);
+    void adjustScale(float);
+    long totalObjects(void);
+    int threads(void) { return pool ? pool->threads() : (workers < 0 ? std::max(1, int(std::thread::hardware_concurrency())) : workers+1); }
+    long stolen(void) { return pool ? pool->stolen() : 0; }
+private:
+    class StepJob : public PoolJob
+    {
+    public:
+        SceneManager* scene;
+        void run(int task) { scene->stepSystem(scene->due[task]); }
+    };
+    int workers;                            // the pool's threads besides the caller's (-1: one per core)
+    WorkPool* pool;                         // taken at the first step (the shared one, for -1)
+    std::vector<int> due;                   // the systems to step this time
+    long frame;
+    void stepSystem(int);
+    void gather(void);
+};
+StarSystem& SceneManager::addSystem(std::string name, point3 position, float scaleFact, const AstroObject& star)
+{
+    systems.push_back(StarSystem(name, position, scaleFact, star));
+    return systems.back();
+}
+// 'count' made-up systems at random places between 'inner' and 'outer' from the origin, near its
+// plane, each a star with up to 'maxObjects' planets and moons (see AstroGroup::addSyntheticObjects)
+void SceneManager::addSyntheticSystems(int count, float inner, float outer, float scaleFact, unsigned int seed)
+{
+    const int maxObjects = 200;
+    for (int i = 0; i < count; i++) {
+        srand(seed + 7919*i);
+        float angle = twoPi * float(rand())/RAND_MAX;
+        float distance = inner + (outer - inner) * float(rand())/RAND_MAX;
+        point3 position(distance*cos(angle), 0.1f*distance*(float(rand())/RAND_MAX - 0.5f), distance*sin(angle));
+        int objects = 3 + rand() % maxObjects;
+        AstroObject star("S" + std::to_string(i), 2.0e5 + 2.0e6*float(rand())/RAND_MAX, 0.0, 20.0 + 20.0*float(rand())/RAND_MAX,
+                         0.0, 9999.0, scaleFact);
+        StarSystem& system = addSystem(star.name, position, scaleFact, star);
+        system.group.addSyntheticObjects(objects, seed + 7919*i + 1);
+    }
+}
+void SceneManager::stepSystem(int i)
+{
+    StarSystem& system = systems[i];
+    system.group.updateMontum(float(system.owedMinutes));
+    system.owedMinutes = 0.0;
+    GLfloat reach = 0.0;
+    point3 centre = system.group.montum[0].modelTransform.translation;
+    for (int k = 0; k < system.group.numObjects; k++) {
+        if (!system.group.alive(k)) continue;
+        const CompactTransform& t = system.group.montum[k].modelTransform;
+        reach = std::max(reach, glm::length(t.translation - centre) + t.scale);
+    }
+    system.reach = reach;
+}
+// Advance the clock by 'minutes' for every system, seen from 'eye' through 'viewProjection', and
+// step those that are due (on the pool); then gather the objects of those in view, if any changed
+void SceneManager::step(float minutes, point3 eye, const glm::mat4& viewProjection)
+{
+    glm::vec4 planes[6];
+    for (int k = 0; k < 3; k++) {
+        for (int c = 0; c < 4; c++) {
+            planes[2*k][c] = viewProjection[c][3] + viewProjection[c][k];
+            planes[2*k+1][c] = viewProjection[c][3] - viewProjection[c][k];
+        }
+    }
+    for (int k = 0; k < 6; k++) planes[k] /= glm::length(point3(planes[k]));
+    due.clear();
+    lastObjectsStepped = 0;
+    bool viewChanged = false;
+    for (int i = 0; i < int(systems.size()); i++) {
+        StarSystem& system = systems[i];
+        system.owedMinutes += minutes;
+        bool inView = true;
+        for (int k = 0; k < 6 && inView; k++)
+            inView = glm::dot(point3(planes[k]), system.position) + planes[k].w > -system.reach;
+        viewChanged = viewChanged || (inView != system.inView);
+        system.inView = inView;
+        int cadence = 1;
+        if (reducedCadence) {
+            if (!inView)
+                cadence = maxCadence;
+            else
+                while (cadence < maxCadence && glm::length(system.position - eye) > nearDistance * cadence) cadence *= 2;
+        }
+        system.cadence = cadence;
+        if ((frame + i) % cadence == 0 || system.reach == 0.0) {
+            due.push_back(i);
+            lastObjectsStepped += system.group.numObjects;
+        }
+    }
+    frame++;
+    lastStepped = int(due.size());
+    if (pool == NULL) pool = acquirePool(workers);
+    StepJob job;
+    job.scene = this;
+    pool->runAll(job, lastStepped);
+    if (lastStepped > 0 || viewChanged) {
+        gather();
+        changed = GL_TRUE;                  // until drawSceneSystems has sent them
+    }
+}
+void SceneManager::gather(void)
+{
+    transforms.clear();
+    stars.clear();
+    for (size_t i = 0; i < systems.size(); i++) {
+        StarSystem& system = systems[i];
+        if (!system.inView) continue;
+        const CompactTransform& star = system.group.montum[0].modelTransform;
+        glm::vec4 starSphere(system.position + star.translation, star.scale);
+        for (int k = 0; k < system.group.numObjects; k++) {
+            if (!system.group.alive(k)) continue;
+            CompactTransform t = system.group.montum[k].modelTransform;
+            t.translation += system.position;
+            transforms.push_back(t);
+            stars.push_back(k == 0 ? glm::vec4(point3(starSphere), -starSphere.w) : starSphere);
+        }
+    }
+}
+void SceneManager::adjustScale(float scaleFactorChange)
+{
+    for (size_t i = 0; i < systems.size(); i++) {
+        systems[i].group.adjustScale(scaleFactorChange);
+        systems[i].reach = 0.0;             // stepped (and measured) again at once
+    }
+}
+long SceneManager::totalObjects(void)
+{
+    long total = 0;
+    for (size_t i = 0; i < systems.size(); i++) total += systems[i].group.montum.count();
+    return total;
+}
+/*---  (END) SceneManager Class ---*/
+#endif
@@ -0,0 +1,204 @@
+//
+//  ShadowCasters.h
+//  AstronomicalModel
+//
+//  Created by Matthew McGuire on 10/19/26.
+//  Copyright (c) 2026 Matthew McGuire. All rights reserved.
+//
+
+#ifndef AstronomicalModel_ShadowCasters_h
+#define AstronomicalModel_ShadowCasters_h
+
+#include <vector>
+#include <algorithm>
+
+/*---  (BEGIN) ShadowCasters Class ---*/
+// Each step, every object gets a short list of the spheres that could possibly
+// block part of the Sun's disc from it. The fragment shader then only has to
+// test those few spheres (see discOcclusion in AstronObjectGLSL.frag).
+//
+// A sphere can only shade a receiver if it touches the truncated cone that joins
+// the Sun to the receiver. Whole subtrees of the object tree (a planet and all of
+// its moons) are rejected at once using a bounding sphere around the subtree.
+// The Sun's own children are sorted into bins by direction (azimuth) as seen from
+// the Sun, so a receiver only visits the subtrees that lie roughly sunward of it.
+class ShadowCasters
+{
+private:
+    std::vector<float> subtreeReach;    // radius of a sphere around each object and all its descendants
+    std::vector<AstroObject*> stack;    // traversal stack, kept to avoid reallocation every step
+    std::vector<std::vector<AstroObject*> > azimuthBins;   // the light's children, binned by direction
+    std::vector<float> nearestToLight;  // closest approach of each subtree to the light's centre
+    struct NearerToLight {
+        const std::vector<float>& nearest;
+        NearerToLight(const std::vector<float>& n) : nearest(n) {}
+        bool operator()(AstroObject* a, AstroObject* b) const { return nearest[a->index] < nearest[b->index]; }
+    };
+    int azimuthBin(glm::vec3);
+    void binLightChildren(AstroGroup&);
+    struct ShadowCone {                 // truncated cone from one receiver to the light
+        glm::vec3 receiverPos, axis;
+        float axisLen, receiverRad, radiusGrowth, slantFactor;
+    } cone;
+    void setShadowCone(int);
+    bool touchesShadowCone(glm::vec3, float, float&);
+public:
+    static const int maxOccluders = 4;  // must match the ivec4 used in the fragment shader
+    int lightSource = 0;                // index (in montum) of the object that emits light
+    std::vector<glm::vec4> spheres;     // per object: absolute centre and viewing radius
+    std::vector<glm::ivec4> occluders;  // per object: indices of possible occluders, -1 where unused
+    void update(AstroGroup&);           // rebuild spheres and occluder lists from the current positions
+    int totalOccluders(void);           // number of occluder entries across all lists
+};
+
+void ShadowCasters::setShadowCone(int receiver)
+{
+    cone.receiverPos = glm::vec3(spheres[receiver]);
+    cone.receiverRad = spheres[receiver].w;
+    cone.axis = glm::vec3(spheres[lightSource]) - cone.receiverPos;
+    cone.axisLen = glm::length(cone.axis);
+    cone.axis /= std::max(cone.axisLen, DivideByZeroTolerance);
+    cone.radiusGrowth = (spheres[lightSource].w - cone.receiverRad)/std::max(cone.axisLen, DivideByZeroTolerance);
+    cone.slantFactor = sqrt(1.0f + cone.radiusGrowth*cone.radiusGrowth);      // widen for the cone's slope
+}
+// Is a sphere (centre c, radius rad) inside the current cone from the receiver to the light?
+// 'closeness' is set to how near the sphere lies to the cone axis (smaller shades more).
+inline bool ShadowCasters::touchesShadowCone(glm::vec3 c, float rad, float& closeness)
+{
+    // how far along the axis (0 = receiver, axisLen = light) the sphere centre projects
+    glm::vec3 offset = c - cone.receiverPos;
+    float along = glm::dot(offset, cone.axis);
+    if (along < -rad || along > cone.axisLen) return false;    // behind the receiver, or beyond the light
+    along = glm::clamp(along, 0.0f, cone.axisLen);
+    float coneRad = cone.receiverRad + along*cone.radiusGrowth;
+    glm::vec3 toAxis = offset - cone.axis*along;
+    float allowed = (coneRad + rad) * cone.slantFactor;
+    float fromAxis2 = glm::dot(toAxis, toAxis);
+    if (fromAxis2 > allowed*allowed) return false;
+    closeness = (sqrt(fromAxis2) - rad)/allowed;
+    return true;
+}
+
+int ShadowCasters::azimuthBin(glm::vec3 fromLight)
+{
+    float az = atan2(fromLight.z, fromLight.x) + M_PI;      // [0,2π]
+    int bin = int(az / twoPi * azimuthBins.size());
+    return bin < int(azimuthBins.size()) ? bin : 0;
+}
+// Every child of the light goes into each bin its shadow could reach. The cone to any
+// receiver lies within 'widest' of its axis, so a subtree (centre c, reach ρ) can only
+// touch it within an angle asin((ρ+widest)/(|c|-ρ)) of the direction to c.
+void ShadowCasters::binLightChildren(AstroGroup& group)
+{
+    glm::vec3 lightPos = glm::vec3(spheres[lightSource]);
+    float widest = 0.0;
+    for (AstroObject* child = group.montum[lightSource].leftmostChild; child != NULL; child = child->rightSibling)
+        widest = std::max(widest, subtreeReach[child->index]);
+    widest = std::max(widest, spheres[lightSource].w);
+
+    int numChildren = 0;
+    for (AstroObject* child = group.montum[lightSource].leftmostChild; child != NULL; child = child->rightSibling)
+        numChildren++;
+    azimuthBins.resize(std::max(16, numChildren/4));
+    for (size_t b = 0; b < azimuthBins.size(); b++) azimuthBins[b].clear();
+    float binWidth = twoPi / azimuthBins.size();
+    nearestToLight.resize(group.numObjects);
+
+    for (AstroObject* child = group.montum[lightSource].leftmostChild; child != NULL; child = child->rightSibling) {
+        int k = child->index;
+        glm::vec3 fromLight = glm::vec3(spheres[k]) - lightPos;
+        float dist = glm::length(fromLight);
+        float nearest = dist - subtreeReach[k];
+        nearestToLight[k] = nearest;
+        float elevation = (dist > DivideByZeroTolerance) ? asin(glm::clamp(fromLight.y/dist, -1.0f, 1.0f)) : 0.0f;
+        float halfAngle = (nearest > DivideByZeroTolerance) ? (subtreeReach[k] + widest)/nearest : 2.0f;
+        float spread = M_PI;            // azimuth half-width; a cap over a pole covers every azimuth
+        if (halfAngle < 1.0 && asin(halfAngle) + fabs(elevation) < 0.5*M_PI)
+            spread = asin(std::min(1.0f, halfAngle / float(cos(elevation))));
+        int numBins = int(azimuthBins.size());
+        int reach = int(spread / binWidth) + 1;
+        if (2*reach+1 >= numBins) {
+            for (int b = 0; b < numBins; b++) azimuthBins[b].push_back(child);
+            continue;
+        }
+        int first = azimuthBin(fromLight);
+        for (int b = -reach; b <= reach; b++)
+            azimuthBins[(first + b + numBins) % numBins].push_back(child);
+    }
+    // nearest subtrees first, so a receiver can stop once the bin is further from the light than itself
+    for (size_t b = 0; b < azimuthBins.size(); b++)
+        std::sort(azimuthBins[b].begin(), azimuthBins[b].end(), NearerToLight(nearestToLight));
+}
+
+void ShadowCasters::update(AstroGroup& group)
+{
+    int n = group.numObjects;
+    spheres.resize(n);
+    occluders.resize(n);
+    subtreeReach.resize(n);
+    for (int i = 0; i < n; i++) {
+        // a free slot is a point, so it shades nothing and is shaded by nothing
+        spheres[i] = glm::vec4(group.montum[i].currentAbsLocation, group.alive(i) ? group.montum[i].viewingRadius() : 0.0f);
+        subtreeReach[i] = spheres[i].w;
+    }
+    // children follow their parents in the group's order, so a backward pass grows every subtree sphere
+    for (int k = int(group.order.size())-1; k >= 0; k--) {
+        if (!group.montum.valid(group.order[k])) continue;
+        int i = group.order[k].slot, p = group.parentOf[i];
+        if (p < 0) continue;
+        float reach = glm::length(glm::vec3(spheres[i]) - glm::vec3(spheres[p])) + subtreeReach[i];
+        if (reach > subtreeReach[p]) subtreeReach[p] = reach;
+    }
+
+    binLightChildren(group);
+
+    for (int r = 0; r < n; r++) {
+        occluders[r] = glm::ivec4(-1);
+        if (r == lightSource || !group.alive(r)) continue;
+        float bestCloseness[maxOccluders];
+        int found = 0;
+        setShadowCone(r);
+
+        std::vector<AstroObject*>& bin = azimuthBins[azimuthBin(glm::vec3(spheres[r]) - glm::vec3(spheres[lightSource]))];
+        float receiverFar = cone.axisLen + cone.receiverRad;
+        stack.clear();
+        for (size_t b = 0; b < bin.size() && nearestToLight[bin[b]->index] < receiverFar; b++)
+            stack.push_back(bin[b]);
+        while (!stack.empty()) {
+            AstroObject* node = stack.back();
+            stack.pop_back();
+            int k = node->index;
+            float closeness;
+            if (!touchesShadowCone(glm::vec3(spheres[k]), subtreeReach[k], closeness))
+                continue;       // nothing in this subtree can reach the cone
+            for (AstroObject* child = node->leftmostChild; child != NULL; child = child->rightSibling)
+                stack.push_back(child);
+            if (k == r || !touchesShadowCone(glm::vec3(spheres[k]), spheres[k].w, closeness))
+                continue;
+            // keep the maxOccluders spheres closest to the axis, sorted by insertion
+            int slot = found < maxOccluders ? found++ : maxOccluders;
+            while (slot > 0 && bestCloseness[slot-1] > closeness) {
+                if (slot < maxOccluders) {
+                    bestCloseness[slot] = bestCloseness[slot-1];
+                    occluders[r][slot] = occluders[r][slot-1];
+                }
+                slot--;
+            }
+            if (slot < maxOccluders) {
+                bestCloseness[slot] = closeness;
+                occluders[r][slot] = k;
+            }
+        }
+    }
+}
+
+int ShadowCasters::totalOccluders(void)
+{
+    int total = 0;
+    for (size_t i = 0; i < occluders.size(); i++)
+        for (int j = 0; j < maxOccluders; j++)
+            if (occluders[i][j] >= 0) total++;
+    return total;
+}
+/*---  (END) ShadowCasters Class ---*/
+#endif
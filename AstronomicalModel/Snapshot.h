@@ -0,0 +1,268 @@
+//
+//  Snapshot.h
+//  AstronomicalModel
+//
+//  Created by Matthew McGuire on 10/19/26.
+//  Copyright (c) 2026 Matthew McGuire. All rights reserved.
+//
+
+#ifndef AstronomicalModel_Snapshot_h
+#define AstronomicalModel_Snapshot_h
+
+#include <vector>
+#include <fstream>
+#include <cstdint>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+/*---  (BEGIN) Snapshot Class ---*/
+// A scene saved whole: every slot of an AstroGroup, each object with all of its state (the
+// derived state too, so nothing is computed again on the way back), with the clock, the scale
+// and the camera. It is written as one buffer in one write, and read back by mapping the file:
+// the records are copied straight into the group's pool, with no parsing and no search: even the
+// tree pointers are saved, as slots, and are pointed back into the pool as each record is copied.
+//
+// File layout (native byte order, like the star catalog):
+//   SnapshotHeader          magic "ASTRSNAP", version, sizes and counts, then the SnapshotScene
+//   SnapshotBody[slots]     every slot of montum in order, free ones included (even generation)
+//   int32_t[live]           the update order of the live objects, every parent before its children
+//   char[nameBytes]         the names, one after another, with no terminators
+// A change to either record's layout changes its size, which is checked, or needs a new version.
+struct SnapshotScene
+{
+    double simulationMinutes;
+    float simulationSpeed;
+    float scaleFactor;
+    float camEyeTheta, camEyePhi, camEyeR;
+    glm::vec3 camRight, camUp;
+    int32_t selectedObject;
+    uint32_t flags;                 // SnapshotFlags
+};
+enum SnapshotFlags {SNAPSHOTPAUSED = 1, SNAPSHOTFOLLOWING = 2};
+struct SnapshotHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize, bodySize;
+    uint32_t slots, live, nameBytes;
+    SnapshotScene scene;
+};
+struct SnapshotBody
+{
+    float radius, scaledRadius, tiltAngle, rotSpeed;
+    float orbitRadius, scaledOrbitRadius, orbitSpeed, scaleFactor;
+    glm::vec3 rotateAxis, orbitAxis;
+    float currentRotAngle, currentOrbitAngle;
+    glm::vec3 currentRelLocation, currentRelVelocity, currentAbsLocation;
+    CompactTransform absLocation, relLocation, modelTransform;
+    int32_t parent;
+    int32_t leftmostChild, rightSibling, leftSibling;   // the tree pointers, as slots (-1 for NULL)
+    uint32_t generation;            // even for a free slot
+    uint32_t nameOffset, nameLength;
+};
+
+class Snapshot
+{
+private:
+    void* mapping;
+    size_t mappingSize;
+    const SnapshotHeader* header;
+    AstroObject* slotAddress(AstroGroup& group, int32_t slot) const
+        { return (slot >= 0 && uint32_t(slot) < header->slots) ? group.montum.address(slot) : NULL; }
+    bool recordsFit(void) const;    // every name within the names, every parent a slot or none
+public:
+    static const uint32_t version = 1;
+    Snapshot() : mapping(NULL), mappingSize(0), header(NULL) {}
+    ~Snapshot() { close(); }
+    static bool save(const char*, AstroGroup&, const SnapshotScene&);
+    static size_t fileSize(AstroGroup&);
+    bool open(const char*);         // map a snapshot; replies false (and says why) if it cannot be used
+    void close(void);
+    const SnapshotScene& scene(void) const { return header->scene; }
+    uint32_t slots(void) const { return header->slots; }
+    void restore(AstroGroup&) const;    // the group becomes the one saved; pointers into it die
+};
+
+size_t Snapshot::fileSize(AstroGroup& group)
+{
+    size_t names = 0;
+    for (int i = 0; i < group.numObjects; i++) names += group.montum[i].name.size();
+    size_t live = 0;
+    for (size_t k = 0; k < group.order.size(); k++)
+        if (group.montum.valid(group.order[k])) live++;
+    return sizeof(SnapshotHeader) + sizeof(SnapshotBody) * group.numObjects + sizeof(int32_t) * live + names;
+}
+// Lay the whole file out in one buffer, then write it at once
+bool Snapshot::save(const char* path, AstroGroup& group, const SnapshotScene& scene)
+{
+    std::vector<char> image(fileSize(group));
+    SnapshotHeader* h = (SnapshotHeader*) &image.front();
+    memset((void*) h, 0, sizeof(SnapshotHeader));        // the padding too, so equal scenes give equal files
+    memcpy(h->magic, "ASTRSNAP", 8);
+    h->version = version;
+    h->headerSize = sizeof(SnapshotHeader);
+    h->bodySize = sizeof(SnapshotBody);
+    h->slots = uint32_t(group.numObjects);
+    h->scene = scene;
+    h->scene.scaleFactor = group.objectScaleFactor;
+
+    SnapshotBody* bodies = (SnapshotBody*) (&image.front() + sizeof(SnapshotHeader));
+    int32_t* order = (int32_t*) (bodies + group.numObjects);
+    uint32_t live = 0;
+    for (size_t k = 0; k < group.order.size(); k++)
+        if (group.montum.valid(group.order[k])) order[live++] = group.order[k].slot;
+    h->live = live;
+    char* names = (char*) (order + live);
+    uint32_t nameBytes = 0;
+    for (int i = 0; i < group.numObjects; i++) {
+        const AstroObject& obj = group.montum[i];
+        SnapshotBody& b = bodies[i];
+        memset((void*) &b, 0, sizeof(b));
+        b.radius = obj.radius;
+        b.scaledRadius = obj.scaledRadius;
+        b.tiltAngle = obj.tiltAngle;
+        b.rotSpeed = obj.rotSpeed;
+        b.orbitRadius = obj.orbitRadius;
+        b.scaledOrbitRadius = obj.scaledOrbitRadius;
+        b.orbitSpeed = obj.orbitSpeed;
+        b.scaleFactor = obj.scaleFactor;
+        b.rotateAxis = obj.rotateAxis;
+        b.orbitAxis = obj.orbitAxis;
+        b.currentRotAngle = obj.currentRotAngle;
+        b.currentOrbitAngle = obj.currentOrbitAngle;
+        b.currentRelLocation = obj.currentRelLocation;
+        b.currentRelVelocity = obj.currentRelVelocity;
+        b.currentAbsLocation = obj.currentAbsLocation;
+        b.absLocation = obj.absLocation;
+        b.relLocation = obj.relLocation;
+        b.modelTransform = obj.modelTransform;
+        b.parent = group.parentOf[i];
+        b.leftmostChild = obj.leftmostChild != NULL ? obj.leftmostChild->index : -1;
+        b.rightSibling = obj.rightSibling != NULL ? obj.rightSibling->index : -1;
+        b.leftSibling = obj.leftSibling != NULL ? obj.leftSibling->index : -1;
+        b.generation = group.montum.alive(i) ? group.montum.handle(i).generation : 0;
+        b.nameOffset = nameBytes;
+        b.nameLength = uint32_t(obj.name.size());
+        memcpy(names + nameBytes, obj.name.data(), obj.name.size());
+        nameBytes += b.nameLength;
+    }
+    h->nameBytes = nameBytes;
+
+    std::ofstream out(path, std::ios::binary);
+    out.write(&image.front(), image.size());
+    if (!out) {
+        std::cerr << "Snapshot " << path << " could not be written." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool Snapshot::open(const char* path)
+{
+    close();
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Snapshot " << path << " could not be opened." << std::endl;
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || size_t(info.st_size) < sizeof(SnapshotHeader)) {
+        std::cerr << "Snapshot " << path << " is too short." << std::endl;
+        ::close(fd);
+        return false;
+    }
+    mappingSize = size_t(info.st_size);
+    mapping = mmap(NULL, mappingSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);                // the mapping stays valid without the descriptor
+    if (mapping == MAP_FAILED) {
+        std::cerr << "Snapshot " << path << " could not be mapped." << std::endl;
+        mapping = NULL;
+        return false;
+    }
+    header = (const SnapshotHeader*) mapping;
+    if (memcmp(header->magic, "ASTRSNAP", 8) != 0 || header->version != version ||
+        header->headerSize != sizeof(SnapshotHeader) || header->bodySize != sizeof(SnapshotBody) ||
+        sizeof(SnapshotHeader) + sizeof(SnapshotBody) * size_t(header->slots) + sizeof(int32_t) * size_t(header->live)
+        + header->nameBytes > mappingSize || header->slots == 0 || !recordsFit()) {
+        std::cerr << "Snapshot " << path << " is not a version " << version << " snapshot." << std::endl;
+        close();
+        return false;
+    }
+    madvise(mapping, mappingSize, MADV_SEQUENTIAL);     // it is read once, front to back
+    return true;
+}
+
+// Checked once on opening, so that restore can copy with no checks of its own
+bool Snapshot::recordsFit(void) const
+{
+    const SnapshotBody* bodies = (const SnapshotBody*) ((const char*) mapping + sizeof(SnapshotHeader));
+    for (uint32_t i = 0; i < header->slots; i++) {
+        const SnapshotBody& b = bodies[i];
+        if (uint64_t(b.nameOffset) + b.nameLength > header->nameBytes) return false;
+        if (b.parent < -1 || (b.parent >= 0 && uint32_t(b.parent) >= header->slots)) return false;
+    }
+    return true;
+}
+
+void Snapshot::close(void)
+{
+    if (mapping != NULL) munmap(mapping, mappingSize);
+    mapping = NULL;
+    mappingSize = 0;
+    header = NULL;
+}
+
+// Each record is copied into one object, which goes into the next slot as it was saved. Every
+// chunk is reserved first, so a pointer can be made to a slot before its object is copied in.
+void Snapshot::restore(AstroGroup& group) const
+{
+    const SnapshotBody* bodies = (const SnapshotBody*) ((const char*) mapping + sizeof(SnapshotHeader));
+    const int32_t* order = (const int32_t*) (bodies + header->slots);
+    const char* names = (const char*) (order + header->live);
+    int slots = int(header->slots);
+
+    group.montum.clear();
+    group.montum.reserve(slots);
+    group.parentOf.resize(slots);
+    AstroObject obj("", 1.0, 0.0, 1.0, 0.0, 1.0, header->scene.scaleFactor);   // every field is overwritten
+    for (int i = 0; i < slots; i++) {
+        const SnapshotBody& b = bodies[i];
+        obj.radius = b.radius;
+        obj.scaledRadius = b.scaledRadius;
+        obj.tiltAngle = b.tiltAngle;
+        obj.rotSpeed = b.rotSpeed;
+        obj.orbitRadius = b.orbitRadius;
+        obj.scaledOrbitRadius = b.scaledOrbitRadius;
+        obj.orbitSpeed = b.orbitSpeed;
+        obj.scaleFactor = b.scaleFactor;
+        obj.rotateAxis = b.rotateAxis;
+        obj.orbitAxis = b.orbitAxis;
+        obj.currentRotAngle = b.currentRotAngle;
+        obj.currentOrbitAngle = b.currentOrbitAngle;
+        obj.currentRelLocation = b.currentRelLocation;
+        obj.currentRelVelocity = b.currentRelVelocity;
+        obj.currentAbsLocation = b.currentAbsLocation;
+        obj.absLocation = b.absLocation;
+        obj.relLocation = b.relLocation;
+        obj.modelTransform = b.modelTransform;
+        obj.leftmostChild = slotAddress(group, b.leftmostChild);
+        obj.rightSibling = slotAddress(group, b.rightSibling);
+        obj.leftSibling = slotAddress(group, b.leftSibling);
+        obj.name.assign(names + b.nameOffset, b.nameLength);
+        obj.index = i;
+        group.montum.restore(obj, b.generation);
+        group.parentOf[i] = b.parent;
+    }
+    group.order.clear();
+    group.order.reserve(header->live);
+    for (uint32_t k = 0; k < header->live; k++)
+        if (order[k] >= 0 && order[k] < slots) group.order.push_back(group.montum.handle(order[k]));
+    group.numObjects = GLsizei(slots);
+    group.objectScaleFactor = header->scene.scaleFactor;
+    group.staleInOrder = 0;
+    group.changedSlots.clear();
+}
+/*---  (END) Snapshot Class ---*/
+#endif
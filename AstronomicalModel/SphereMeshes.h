@@ -0,0 +1,218 @@
+//
+//  SphereMeshes.h
+//  AstronomicalModel
+//
+//  Created by Matthew McGuire on 10/19/26.
+//  Copyright (c) 2026 Matthew McGuire. All rights reserved.
+//
+
+#ifndef AstronomicalModel_SphereMeshes_h
+#define AstronomicalModel_SphereMeshes_h
+
+#include <vector>
+#include <map>
+#include <utility>
+#include <algorithm>
+
+// Unit spheres with more even triangles than BetterSphere's bands and polar fans. Both fill a
+// sphereSpec with the same vertices, norms and stMap (the same equirectangular projection as
+// BetterSphere), but as a list of separate triangles: fans and bands are 0, and the indices
+// are drawn with GL_TRIANGLES (see AstroGroup::drawMontumTriangles).
+
+/*---  (BEGIN) Sphere mesh helpers ---*/
+// s and t as BetterSphere has them at the point p of the unit sphere (see euclidSpherical)
+point2 sphereST(point3 p)
+{
+    float s = atan2(p.x, p.z) / (2.0*M_PI);
+    if (s < 0.0) s += 1.0;
+    return point2(s, 1.0 - acos(glm::clamp(p.y, -1.0f, 1.0f)) / M_PI);
+}
+void addSphereVertex(sphereSpec& spec, point3 p, point2 st)
+{
+    spec.vertices.push_back(p);
+    spec.norms.push_back(p);            // exact on a unit sphere
+    spec.stMap.push_back(st);
+}
+// Give every vertex its st, then mend the triangles where that goes wrong. Where a triangle
+// crosses the seam (s running from near 1 back to near 0), the vertices on the near-0 side are
+// replaced by copies with s + 1; GL_REPEAT wraps them back. A vertex at a pole has no s of its
+// own, so each triangle there gets its own copy with the mean s of its other two vertices.
+void seamCorrectST(sphereSpec& spec)
+{
+    int original = int(spec.vertices.size());
+    spec.stMap.resize(original);
+    std::vector<bool> atPole(original);
+    for (int i = 0; i < original; i++) {
+        spec.stMap[i] = sphereST(spec.vertices[i]);
+        atPole[i] = fabs(spec.vertices[i].x) < 1.0e-6 && fabs(spec.vertices[i].z) < 1.0e-6;
+    }
+    std::vector<int> wrapped(original, -1);        // index of each vertex's s + 1 copy, once made
+    for (size_t tri = 0; tri + 2 < spec.indices.size(); tri += 3) {
+        unsigned int* corner = &spec.indices[tri];
+        float lowest = 2.0, highest = -1.0;
+        for (int k = 0; k < 3; k++) {
+            if (atPole[corner[k]]) continue;
+            lowest = std::min(lowest, spec.stMap[corner[k]].x);
+            highest = std::max(highest, spec.stMap[corner[k]].x);
+        }
+        if (highest - lowest > 0.5) {
+            for (int k = 0; k < 3; k++) {
+                int v = corner[k];
+                if (atPole[v] || spec.stMap[v].x >= 0.5) continue;
+                if (wrapped[v] < 0) {
+                    wrapped[v] = int(spec.vertices.size());
+                    addSphereVertex(spec, spec.vertices[v], spec.stMap[v] + point2(1.0, 0.0));
+                }
+                corner[k] = wrapped[v];
+            }
+        }
+        for (int k = 0; k < 3; k++) {
+            if (corner[k] >= (unsigned int) original || !atPole[corner[k]]) continue;
+            int pole = corner[k];
+            float s = 0.5*(spec.stMap[corner[(k+1)%3]].x + spec.stMap[corner[(k+2)%3]].x);
+            corner[k] = int(spec.vertices.size());
+            addSphereVertex(spec, spec.vertices[pole], point2(s, spec.stMap[pole].y));
+        }
+    }
+    spec.fans = 0;
+    spec.bands = 0;
+    spec.numVertices = int(spec.vertices.size());
+    spec.numIndices = int(spec.indices.size());
+}
+// The largest gap between the mesh and the true unit sphere: the least |p| over each triangle's
+// surface, found by sampling it, and turned into a distance from the sphere. Works for
+// BetterSphere's fans and strips as well as for triangle lists.
+float maxSphereError(sphereSpec& spec)
+{
+    std::vector<unsigned int> triangles;
+    if (spec.bands > 0) {
+        int fanLength = spec.fans + 2, stripLength = 2*spec.fans + 2;
+        for (int cap = 0; cap < 2; cap++) {
+            int first = (cap == 0) ? 0 : spec.numIndices - fanLength;
+            for (int i = 1; i + 1 < fanLength; i++) {
+                triangles.push_back(spec.indices[first]);
+                triangles.push_back(spec.indices[first+i]);
+                triangles.push_back(spec.indices[first+i+1]);
+            }
+        }
+        for (int j = 0; j < spec.bands-2; j++) {
+            int first = fanLength + j*stripLength;
+            for (int i = 0; i + 2 < stripLength; i++)
+                for (int k = 0; k < 3; k++) triangles.push_back(spec.indices[first+i+k]);
+        }
+    }
+    else
+        triangles = spec.indices;
+    const int steps = 8;
+    float nearest = 1.0;
+    for (size_t tri = 0; tri + 2 < triangles.size(); tri += 3) {
+        point3 a = spec.vertices[triangles[tri]], b = spec.vertices[triangles[tri+1]], c = spec.vertices[triangles[tri+2]];
+        for (int i = 0; i <= steps; i++)
+            for (int j = 0; i + j <= steps; j++)
+                nearest = std::min(nearest, glm::length(a + (float(i)*(b-a) + float(j)*(c-a))/float(steps)));
+    }
+    return 1.0 - nearest;
+}
+/*---  (END) Sphere mesh helpers ---*/
+
+/*---  (BEGIN) IcoSphere Class ---*/
+// An icosahedron with a vertex at each pole, each triangle split into four 'subdivisions'
+// times and pushed out to the sphere: 20*4^n nearly equal triangles.
+class IcoSphere
+{
+private:
+    std::map<std::pair<int,int>, int> midpoints;
+    int midpoint(int, int);
+public:
+    IcoSphere(int);
+    sphereSpec theSphere;
+};
+int IcoSphere::midpoint(int a, int b)
+{
+    std::pair<int,int> edge(std::min(a, b), std::max(a, b));
+    std::map<std::pair<int,int>, int>::iterator found = midpoints.find(edge);
+    if (found != midpoints.end()) return found->second;
+    int index = int(theSphere.vertices.size());
+    addSphereVertex(theSphere, glm::normalize(theSphere.vertices[a] + theSphere.vertices[b]), point2(0.0));
+    midpoints[edge] = index;
+    return index;
+}
+IcoSphere::IcoSphere(int subdivisions)
+{
+    // the poles, then two rings of five at latitude ±atan(1/2), the lower turned by a tenth of a turn
+    addSphereVertex(theSphere, point3(0.0, 1.0, 0.0), point2(0.0));
+    for (int ring = 0; ring < 2; ring++)
+        for (int k = 0; k < 5; k++) {
+            float theta = (2.0*k + ring) * M_PI / 5.0;
+            float y = (ring == 0 ? 1.0 : -1.0) / sqrt(5.0);
+            addSphereVertex(theSphere, euclidSpherical(1.0, theta, acos(y)), point2(0.0));
+        }
+    addSphereVertex(theSphere, point3(0.0, -1.0, 0.0), point2(0.0));
+    for (int k = 0; k < 5; k++) {
+        int upper = 1 + k, upperNext = 1 + (k+1)%5, lower = 6 + k, lowerNext = 6 + (k+1)%5;
+        unsigned int faces[12] = {0, (unsigned int) upper, (unsigned int) upperNext,
+                                  (unsigned int) upper, (unsigned int) lower, (unsigned int) upperNext,
+                                  (unsigned int) upperNext, (unsigned int) lower, (unsigned int) lowerNext,
+                                  11, (unsigned int) lowerNext, (unsigned int) lower};
+        theSphere.indices.insert(theSphere.indices.end(), faces, faces+12);
+    }
+    for (int level = 0; level < subdivisions; level++) {
+        std::vector<unsigned int> coarse;
+        coarse.swap(theSphere.indices);
+        midpoints.clear();
+        for (size_t tri = 0; tri + 2 < coarse.size(); tri += 3) {
+            int a = coarse[tri], b = coarse[tri+1], c = coarse[tri+2];
+            unsigned int ab = midpoint(a, b), bc = midpoint(b, c), ca = midpoint(c, a);
+            unsigned int faces[12] = {(unsigned int) a, ab, ca,  ab, (unsigned int) b, bc,
+                                      ca, bc, (unsigned int) c,  ab, bc, ca};
+            theSphere.indices.insert(theSphere.indices.end(), faces, faces+12);
+        }
+    }
+    midpoints.clear();
+    seamCorrectST(theSphere);
+}
+/*---  (END) IcoSphere Class ---*/
+
+/*---  (BEGIN) CubeSphere Class ---*/
+// A cube whose faces are each a grid of divisions x divisions squares, pushed out to the
+// sphere. Each point is moved along its face before it is normalised, as in
+//     x' = x * sqrt(1 - y²/2 - z²/2 + y²z²/3)
+// which keeps the squares near the corners about as large as those at the face centres.
+class CubeSphere
+{
+public:
+    CubeSphere(int);
+    sphereSpec theSphere;
+};
+CubeSphere::CubeSphere(int divisions)
+{
+    for (int face = 0; face < 6; face++) {
+        // each face: the axis it faces along, and two axes across it (right-handed, so it faces out)
+        int axis = face / 2;
+        float side = (face % 2 == 0) ? 1.0 : -1.0;
+        point3 normal(0.0), across(0.0), up(0.0);
+        normal[axis] = side;
+        across[(axis+1)%3] = side;
+        up[(axis+2)%3] = 1.0;
+        int first = int(theSphere.vertices.size());
+        for (int j = 0; j <= divisions; j++)
+            for (int i = 0; i <= divisions; i++) {
+                point3 p = normal + (2.0f*i/divisions - 1.0f)*across + (2.0f*j/divisions - 1.0f)*up;
+                point3 q = p*p;
+                point3 even(p.x*sqrt(1.0 - 0.5*q.y - 0.5*q.z + q.y*q.z/3.0),
+                            p.y*sqrt(1.0 - 0.5*q.z - 0.5*q.x + q.z*q.x/3.0),
+                            p.z*sqrt(1.0 - 0.5*q.x - 0.5*q.y + q.x*q.y/3.0));
+                addSphereVertex(theSphere, glm::normalize(even), point2(0.0));
+            }
+        for (int j = 0; j < divisions; j++)
+            for (int i = 0; i < divisions; i++) {
+                unsigned int corner = first + j*(divisions+1) + i;
+                unsigned int faces[6] = {corner, corner+1, corner+divisions+1,
+                                         corner+1, corner+divisions+2, corner+divisions+1};
+                theSphere.indices.insert(theSphere.indices.end(), faces, faces+6);
+            }
+    }
+    seamCorrectST(theSphere);
+}
+/*---  (END) CubeSphere Class ---*/
+#endif
@@ -0,0 +1,235 @@
+//
+//  StarCatalog.h
+//  AstronomicalModel
+//
+//  Created by Matthew McGuire on 10/19/26.
+//  Copyright (c) 2026 Matthew McGuire. All rights reserved.
+//
+
+#ifndef AstronomicalModel_StarCatalog_h
+#define AstronomicalModel_StarCatalog_h
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+/*---  (BEGIN) StarCatalog Class ---*/
+// A binary star catalog, read by mapping the file into memory so that the records
+// can go straight into a vertex buffer without being copied or parsed.
+//
+// File layout (native byte order):
+//   StarCatalogHeader   magic "ASTRSTAR", version, number of stars, record size
+//   StarRecord[count]   sorted from brightest to faintest
+// Directions are unit vectors in model coordinates: the ecliptic is the x-z plane,
+// ecliptic longitude λ lies along (cos λ, 0, -sin λ) as in AstroObject::incremObject.
+struct StarCatalogHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t count;
+    uint32_t recordSize;
+    uint32_t reserved;
+};
+struct StarRecord
+{
+    float direction[3];
+    float magnitude;            // apparent visual magnitude
+    uint8_t colour[4];          // RGBA, from the B-V colour index
+};
+
+class StarCatalog
+{
+private:
+    void* mapping;
+    size_t mappingSize;
+    static void colourFromBV(float, uint8_t*);
+    static bool write(const char*, std::vector<StarRecord>&);
+public:
+    StarCatalog();
+    ~StarCatalog();
+    const StarRecord* stars;    // points into the mapped file, valid until close()
+    uint32_t count;
+    bool open(const char*);     // map a catalog; replies false (and says why) if it cannot be used
+    void close(void);
+    uint32_t countBrighterThan(float) const;    // how many records have a magnitude below the given one
+    static bool writeSynthetic(const char*, uint32_t, unsigned int);  // a random sky, for testing and benchmarks
+    static bool convertCSV(const char*, const char*);   // "ra_deg,dec_deg,magnitude,b-v" lines to a catalog
+};
+
+StarCatalog::StarCatalog()
+{
+    mapping = NULL;
+    mappingSize = 0;
+    stars = NULL;
+    count = 0;
+}
+StarCatalog::~StarCatalog()
+{
+    close();
+}
+
+bool StarCatalog::open(const char* path)
+{
+    close();
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Star catalog " << path << " could not be opened." << std::endl;
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || size_t(info.st_size) < sizeof(StarCatalogHeader)) {
+        std::cerr << "Star catalog " << path << " is too short." << std::endl;
+        ::close(fd);
+        return false;
+    }
+    mappingSize = size_t(info.st_size);
+    mapping = mmap(NULL, mappingSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);                // the mapping stays valid without the descriptor
+    if (mapping == MAP_FAILED) {
+        std::cerr << "Star catalog " << path << " could not be mapped." << std::endl;
+        mapping = NULL;
+        return false;
+    }
+    const StarCatalogHeader* header = (const StarCatalogHeader*) mapping;
+    if (memcmp(header->magic, "ASTRSTAR", 8) != 0 || header->version != 1 ||
+        header->recordSize != sizeof(StarRecord) ||
+        sizeof(StarCatalogHeader) + size_t(header->count) * sizeof(StarRecord) > mappingSize) {
+        std::cerr << "Star catalog " << path << " is not a version 1 catalog." << std::endl;
+        close();
+        return false;
+    }
+    madvise(mapping, mappingSize, MADV_SEQUENTIAL);     // it is read once, front to back
+    count = header->count;
+    stars = (const StarRecord*) ((const char*) mapping + sizeof(StarCatalogHeader));
+    return true;
+}
+
+void StarCatalog::close(void)
+{
+    if (mapping != NULL) munmap(mapping, mappingSize);
+    mapping = NULL;
+    mappingSize = 0;
+    stars = NULL;
+    count = 0;
+}
+
+uint32_t StarCatalog::countBrighterThan(float magnitude) const
+{
+    uint32_t lo = 0, hi = count;
+    while (lo < hi) {
+        uint32_t mid = (lo + hi) / 2;
+        if (stars[mid].magnitude < magnitude) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+// A rough blackbody colour: blue-white for B-V below 0, through white and yellow, to orange-red at 2
+void StarCatalog::colourFromBV(float bv, uint8_t* rgba)
+{
+    const float stops[4][4] = {     // B-V, r, g, b
+        {-0.4f, 0.62f, 0.72f, 1.00f},
+        { 0.4f, 1.00f, 0.98f, 0.95f},
+        { 1.0f, 1.00f, 0.85f, 0.62f},
+        { 2.0f, 1.00f, 0.60f, 0.35f}};
+    bv = glm::clamp(bv, stops[0][0], stops[3][0]);
+    int k = 0;
+    while (k < 2 && bv > stops[k+1][0]) k++;
+    float f = (bv - stops[k][0]) / (stops[k+1][0] - stops[k][0]);
+    for (int c = 0; c < 3; c++)
+        rgba[c] = uint8_t(255.0f * ((1.0f-f)*stops[k][c+1] + f*stops[k+1][c+1]));
+    rgba[3] = 255;
+}
+
+struct BrighterStar {
+    bool operator()(const StarRecord& a, const StarRecord& b) const { return a.magnitude < b.magnitude; }
+};
+
+// Sort and write in one buffered pass
+bool StarCatalog::write(const char* path, std::vector<StarRecord>& records)
+{
+    std::sort(records.begin(), records.end(), BrighterStar());
+    StarCatalogHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, "ASTRSTAR", 8);
+    header.version = 1;
+    header.count = uint32_t(records.size());
+    header.recordSize = sizeof(StarRecord);
+    std::ofstream out(path, std::ios::binary);
+    out.write((const char*) &header, sizeof(header));
+    if (!records.empty())
+        out.write((const char*) &records.front(), sizeof(StarRecord) * records.size());
+    if (!out) {
+        std::cerr << "Star catalog " << path << " could not be written." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Stars crowd toward a tilted galactic plane, and there are ~3.2 times as many at each
+// fainter magnitude, so the brightest 9000 reach magnitude 6.5 as they do in the real sky.
+bool StarCatalog::writeSynthetic(const char* path, uint32_t numStars, unsigned int seed)
+{
+    srand(seed);
+    float faintest = 6.5f + 2.0f*log10(std::max(1.0f, numStars/9000.0f));
+    glm::mat3 galaxyTilt = glm::mat3(glm::rotate(glm::mat4(1.0f), 1.05f, glm::vec3(1.0, 0.0, 0.3)));
+    std::vector<StarRecord> records(numStars);
+    for (uint32_t i = 0; i < numStars; i++) {
+        float longitude = twoPi * float(rand())/RAND_MAX;
+        float u = 2.0f*float(rand())/RAND_MAX - 1.0f;
+        float sinLatitude = u*u*u;          // most stars near the plane
+        float cosLatitude = sqrt(1.0f - sinLatitude*sinLatitude);
+        glm::vec3 dir = galaxyTilt * glm::vec3(cosLatitude*cos(longitude), sinLatitude, cosLatitude*sin(longitude));
+        records[i].direction[0] = dir.x;
+        records[i].direction[1] = dir.y;
+        records[i].direction[2] = dir.z;
+        records[i].magnitude = faintest + 2.0f*log10(std::max(1.0e-9f, float(rand())/RAND_MAX));
+        float bv = 0.6f + 0.45f*(float(rand())/RAND_MAX + float(rand())/RAND_MAX - 1.0f)*2.0f;
+        colourFromBV(bv, records[i].colour);
+    }
+    return write(path, records);
+}
+
+// Equatorial coordinates are turned to the ecliptic (obliquity 23.44°) and then into model axes
+bool StarCatalog::convertCSV(const char* csvPath, const char* path)
+{
+    std::ifstream in(csvPath);
+    if (!in) {
+        std::cerr << "Star list " << csvPath << " could not be opened." << std::endl;
+        return false;
+    }
+    const double obliquity = 23.4393 * DegreesToRadians;
+    std::vector<StarRecord> records;
+    std::string line;
+    while (std::getline(in, line)) {
+        double ra, dec, magnitude, bv = 0.6;
+        char comma;
+        std::istringstream fields(line);
+        if (!(fields >> ra >> comma >> dec >> comma >> magnitude)) continue;   // headers, blank lines
+        fields >> comma >> bv;
+        ra *= DegreesToRadians;
+        dec *= DegreesToRadians;
+        double x = cos(dec)*cos(ra), y = cos(dec)*sin(ra), z = sin(dec);
+        double yEcliptic = y*cos(obliquity) + z*sin(obliquity);
+        double zEcliptic = -y*sin(obliquity) + z*cos(obliquity);
+        StarRecord star;
+        star.direction[0] = float(x);
+        star.direction[1] = float(zEcliptic);
+        star.direction[2] = float(-yEcliptic);
+        star.magnitude = float(magnitude);
+        colourFromBV(float(bv), star.colour);
+        records.push_back(star);
+    }
+    std::cout << "Star catalog: " << records.size() << " stars from " << csvPath << std::endl;
+    return write(path, records);
+}
+/*---  (END) StarCatalog Class ---*/
+#endif
@@ -0,0 +1,10 @@
+#version 330
+in vec4 colour;
+out vec4 fColor;
+
+void main() {
+    // a round sprite, fading toward its edge
+    float r = length(gl_PointCoord - vec2(0.5)) * 2.0;
+    if (r > 1.0) discard;
+    fColor = vec4(colour.rgb, colour.a * (1.0 - r*r));
+}
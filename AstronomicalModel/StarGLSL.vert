@@ -0,0 +1,23 @@
+#version 330
+// Background stars as point sprites. Each star is a direction, so only the camera's
+// rotation applies: the stars stay put however far the camera moves.
+in vec3 starDirection;
+in float starMagnitude;
+in vec4 starColour;
+uniform camera {
+    mat4 modelvMatrix;
+    mat4 projMatrix;
+};
+uniform float magnitudeLimit;           // stars this faint are just visible
+uniform float maxStarSize;              // sprite diameter (pixels) of the brightest stars
+out vec4 colour;
+
+void main() {
+    gl_Position = projMatrix * vec4(mat3(modelvMatrix) * starDirection, 1.0);
+    // brightness doubles every 0.75 magnitudes, from 5% of a full pixel at magnitudeLimit.
+    // The sprite grows with the square root of the brightness, and alpha carries the rest.
+    float flux = 0.05 * pow(10.0, 0.4*(magnitudeLimit - starMagnitude));
+    float size = clamp(sqrt(flux), 1.0, maxStarSize);
+    gl_PointSize = size;
+    colour = vec4(starColour.rgb, clamp(flux / (size*size), 0.0, 1.0));
+}
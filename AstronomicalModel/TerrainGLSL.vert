@@ -0,0 +1,94 @@
+#version 330
+// One quadtree patch of an object's surface per instance (see PlanetTerrain.h): a grid of
+// terrainGrid x terrainGrid squares on one face of the cube, pushed out to the sphere as in
+// CubeSphere and raised by its height tile. Drawn as one triangle strip per instance, row by
+// row with degenerate triangles between rows, with no vertex buffer; lit by AstronObjectGLSL.frag.
+in vec3 patchCorner;                        // per instance: u and v of the patch's first corner on its face, and its size
+in ivec4 patchInfo;                         // face, object index, height tile layer, levels to the coarser neighbour (4 bits per edge)
+uniform camera {
+    mat4 modelvMatrix;
+    mat4 projMatrix;
+};
+uniform samplerBuffer objectTransforms;     // two texels per object: rotation quaternion, translation and scale
+uniform sampler2DArray heightTiles;         // (terrainGrid+1)² heights per layer, from -1 to 1
+uniform int terrainGrid;
+uniform float heightScale;                  // the greatest height, as a fraction of the radius
+out vec2 textureSTMapFrag;
+out vec3 worldPosition;
+out vec3 worldNormal;
+flat out int instanceID;
+
+const float PI = 3.14159265;
+
+vec3 rotate(vec4 q, vec3 v) {
+    return v + 2.0*cross(q.xyz, cross(q.xyz, v) + q.w*v);
+}
+
+// The point of the unit sphere over (u, v) of a cube face, with the axes and the evening-out of CubeSphere
+vec3 cubeToSphere(int face, vec2 uv) {
+    int axis = face / 2;
+    float side = (face % 2 == 0) ? 1.0 : -1.0;
+    vec3 normal = vec3(0.0), across = vec3(0.0), up = vec3(0.0);
+    normal[axis] = side;
+    across[(axis+1)%3] = side;
+    up[(axis+2)%3] = 1.0;
+    vec3 p = normal + uv.x*across + uv.y*up;
+    vec3 q = p*p;
+    return normalize(p * sqrt(1.0 - 0.5*q.yzx - 0.5*q.zxy + q.yzx*q.zxy/3.0));
+}
+
+// Grid corner (i, j) of this patch on the raised surface, in the object's frame with unit radius
+vec3 surfacePoint(ivec2 ij) {
+    ij = clamp(ij, ivec2(0), ivec2(terrainGrid));
+    vec2 uv = patchCorner.xy + patchCorner.z * vec2(ij) / float(terrainGrid);
+    float h = texelFetch(heightTiles, ivec3(ij, patchInfo.z), 0).r;
+    return cubeToSphere(patchInfo.x, uv) * (1.0 + heightScale*h);
+}
+
+// Where the patch across an edge is coarser, it has only every step'th vertex of this edge;
+// the ones in between are moved onto the straight line between its two, so the edges meet
+vec3 stitchedPoint(ivec2 ij) {
+    int edge, along;
+    if (ij.y == 0) { edge = 0; along = ij.x; }
+    else if (ij.x == terrainGrid) { edge = 1; along = ij.y; }
+    else if (ij.y == terrainGrid) { edge = 2; along = ij.x; }
+    else if (ij.x == 0) { edge = 3; along = ij.y; }
+    else return surfacePoint(ij);
+    int step = 1 << ((patchInfo.w >> (4*edge)) & 15);
+    int before = (along / step) * step;
+    if (before == along) return surfacePoint(ij);
+    ivec2 direction = (edge % 2 == 0) ? ivec2(1, 0) : ivec2(0, 1);
+    ivec2 a = ij - (along - before)*direction;
+    return mix(surfacePoint(a), surfacePoint(a + step*direction), float(along - before)/float(step));
+}
+
+void main() {
+    int perRow = 2*terrainGrid + 4;
+    int row = gl_VertexID / perRow;
+    int k = clamp(gl_VertexID - row*perRow - 1, 0, 2*terrainGrid + 1);
+    ivec2 ij = ivec2(k / 2, row + (k % 2));
+    vec3 local = stitchedPoint(ij);
+    vec3 normal = normalize(cross(surfacePoint(ij + ivec2(1, 0)) - surfacePoint(ij - ivec2(1, 0)),
+                                  surfacePoint(ij + ivec2(0, 1)) - surfacePoint(ij - ivec2(0, 1))));
+    if (dot(normal, local) < 0.0) normal = -normal;
+
+    vec4 rotation = texelFetch(objectTransforms, 2*patchInfo.y);
+    vec4 translationScale = texelFetch(objectTransforms, 2*patchInfo.y+1);
+    vec3 offset = translationScale.w * rotate(rotation, local);     // from the object's centre
+    worldPosition = translationScale.xyz + offset;
+    worldNormal = rotate(rotation, normal);
+    // placed relative to the eye, so that vertices a hair apart on an object far from the origin
+    // stay a hair apart: the object's centre less the eye is the same for every vertex
+    mat3 view = mat3(modelvMatrix);
+    vec3 eyePosition = -(modelvMatrix[3].xyz * view);
+    gl_Position = projMatrix * vec4(view * ((translationScale.xyz - eyePosition) + offset), 1.0);
+    instanceID = patchInfo.y;
+
+    // s and t as BetterSphere has them, with s kept within half a turn of the patch centre's
+    // so that no triangle runs the long way round across the seam
+    vec3 dir = normalize(local);
+    vec3 centre = cubeToSphere(patchInfo.x, patchCorner.xy + 0.5*patchCorner.z);
+    float s = atan(dir.x, dir.z) / (2.0*PI);
+    s += round(atan(centre.x, centre.z) / (2.0*PI) - s);
+    textureSTMapFrag = vec2(s, 1.0 - acos(clamp(dir.y, -1.0, 1.0)) / PI);
+}
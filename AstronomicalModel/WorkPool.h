@@ -0,0 +1,229 @@
+//
+//  WorkPool.h
+//  AstronomicalModel
+//
+//  Created by Matthew McGuire on 10/19/26.
+//  Copyright (c) 2026 Matthew McGuire. All rights reserved.
+//
+
+#ifndef AstronomicalModel_WorkPool_h
+#define AstronomicalModel_WorkPool_h
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <algorithm>
+
+/*---  (BEGIN) WorkPool Class ---*/
+// A fixed set of worker threads that run batches of numbered tasks, with work stealing. runAll
+// deals the task numbers out in runs, one queue per thread (the caller's own thread is one of
+// them and works too); each takes from the back of its own queue, and when that is empty steals
+// from the front of another's. Tasks of very different sizes (a system of three objects beside
+// one of three hundred) so even out without any guessing up front. runAll returns when every
+// task of the batch has run.
+//
+// Batches may overlap. start() deals a batch to the workers alone and returns at once, so a long
+// piece of work (the event search) runs in the background while the caller goes on; its tasks
+// may call runAll in turn, whose tasks then go to the workers alone. A caller that is not one of
+// the workers only ever runs tasks of its own batch, so a frame's batch never runs a background
+// task on the calling thread; and the workers take the newest tasks in their own queues first.
+//
+// A process has one pool of a thread per core (sharedWorkPool), which everything that runs on
+// every core takes through acquirePool(-1): the scene's other systems, the event search and the
+// library's batch queries. Only a set number of workers makes a pool of its own.
+class PoolJob
+{
+public:
+    virtual ~PoolJob() {}
+    virtual void run(int task) = 0;
+};
+// One batch's job and how many of its tasks have still to finish
+class PoolBatch
+{
+public:
+    PoolJob* job;
+    std::atomic<int> remaining;
+    PoolBatch() : job(NULL), remaining(0) {}
+    bool done(void) const { return remaining == 0; }
+};
+class WorkPool
+{
+public:
+    WorkPool(int);                  // worker threads besides the caller (-1: one per core, less the caller's)
+    ~WorkPool();
+    void runAll(PoolJob&, int);
+    void start(PoolJob&, int, PoolBatch&);  // on the workers only; done() once every task has run
+    int threads(void) { return int(queues.size()); }
+    long stolen(void) const { return steals; }  // tasks run by a thread other than the one dealt them, since construction
+private:
+    struct PoolTask
+    {
+        PoolBatch* batch;
+        int task;
+    };
+    struct TaskQueue
+    {
+        std::mutex lock;
+        std::deque<PoolTask> tasks;
+    };
+    std::vector<TaskQueue*> queues;     // the workers', then the callers' (the last)
+    std::vector<std::thread> workers;
+    std::mutex gate;
+    std::condition_variable wake, finished;
+    std::atomic<int> queued;            // tasks in any queue (raised under gate, so no worker misses it)
+    std::atomic<long> steals;
+    bool stopping;
+    void deal(PoolBatch&, int, int);
+    bool take(int, bool, PoolTask&);
+    bool takeOwn(PoolBatch&, PoolTask&);
+    void runTask(const PoolTask&);
+    int workerIndex(void);
+    void workerLoop(int);
+};
+WorkPool::WorkPool(int count) : queued(0), steals(0), stopping(false)
+{
+    if (count < 0) count = std::max(0, int(std::thread::hardware_concurrency()) - 1);
+    for (int i = 0; i <= count; i++) queues.push_back(new TaskQueue);
+    for (int i = 0; i < count; i++) workers.push_back(std::thread(&WorkPool::workerLoop, this, i));
+}
+WorkPool::~WorkPool()
+{
+    {
+        std::lock_guard<std::mutex> hold(gate);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (size_t i = 0; i < workers.size(); i++) workers[i].join();
+    for (size_t i = 0; i < queues.size(); i++) delete queues[i];
+}
+// Deal the batch's tasks out in runs over the first 'over' queues
+void WorkPool::deal(PoolBatch& batch, int tasks, int over)
+{
+    for (int q = 0; q < over; q++) {
+        std::lock_guard<std::mutex> holdQueue(queues[q]->lock);
+        for (int t = q*tasks/over; t < (q+1)*tasks/over; t++) {
+            PoolTask entry = {&batch, t};
+            queues[q]->tasks.push_back(entry);
+        }
+    }
+    std::lock_guard<std::mutex> hold(gate);
+    queued += tasks;
+}
+// The back of this thread's own queue, or else (if it may steal) the front of the first other
+// queue with any left
+bool WorkPool::take(int self, bool steal, PoolTask& entry)
+{
+    {
+        std::lock_guard<std::mutex> hold(queues[self]->lock);
+        if (!queues[self]->tasks.empty()) {
+            entry = queues[self]->tasks.back();
+            queues[self]->tasks.pop_back();
+            queued--;
+            return true;
+        }
+    }
+    int n = steal ? int(queues.size()) : 0;
+    for (int k = 1; k < n; k++) {
+        TaskQueue* victim = queues[(self + k) % n];
+        std::lock_guard<std::mutex> hold(victim->lock);
+        if (!victim->tasks.empty()) {
+            entry = victim->tasks.front();
+            victim->tasks.pop_front();
+            steals++;
+            queued--;
+            return true;
+        }
+    }
+    return false;
+}
+// Any task of this batch, from whichever queue holds one: a caller that is not a worker helps with
+// its own batch only, and so never waits on a background task
+bool WorkPool::takeOwn(PoolBatch& batch, PoolTask& entry)
+{
+    for (size_t q = 0; q < queues.size(); q++) {
+        std::lock_guard<std::mutex> hold(queues[q]->lock);
+        std::deque<PoolTask>& tasks = queues[q]->tasks;
+        for (std::deque<PoolTask>::iterator it = tasks.begin(); it != tasks.end(); ++it) {
+            if (it->batch != &batch) continue;
+            entry = *it;
+            tasks.erase(it);
+            steals++;
+            queued--;
+            return true;
+        }
+    }
+    return false;
+}
+void WorkPool::runTask(const PoolTask& entry)
+{
+    PoolBatch* batch = entry.batch;
+    batch->job->run(entry.task);
+    std::lock_guard<std::mutex> hold(gate);     // so that a waiter cannot miss the last one
+    if (--batch->remaining == 0) finished.notify_all();
+}
+// This thread's queue: its own for a worker, the callers' for any other thread
+int WorkPool::workerIndex(void)
+{
+    std::thread::id self = std::this_thread::get_id();
+    for (size_t i = 0; i < workers.size(); i++)
+        if (workers[i].get_id() == self) return int(i);
+    return int(queues.size()) - 1;
+}
+void WorkPool::workerLoop(int self)
+{
+    PoolTask entry;
+    for (;;) {
+        while (take(self, true, entry)) runTask(entry);
+        std::unique_lock<std::mutex> hold(gate);
+        while (!stopping && queued == 0) wake.wait(hold);
+        if (stopping) return;
+    }
+}
+void WorkPool::runAll(PoolJob& newJob, int tasks)
+{
+    if (tasks <= 0) return;
+    PoolBatch batch;
+    batch.job = &newJob;
+    batch.remaining = tasks;
+    int self = workerIndex();
+    bool isWorker = self < int(workers.size());
+    deal(batch, tasks, isWorker ? int(workers.size()) : int(queues.size()));
+    wake.notify_all();
+    PoolTask entry;
+    while (take(self, isWorker, entry) || (!isWorker && takeOwn(batch, entry))) runTask(entry);
+    std::unique_lock<std::mutex> hold(gate);
+    while (batch.remaining > 0) finished.wait(hold);
+}
+void WorkPool::start(PoolJob& newJob, int tasks, PoolBatch& batch)
+{
+    batch.job = &newJob;
+    batch.remaining = tasks;
+    if (tasks <= 0) return;
+    if (workers.empty()) {                  // no one else to run it: it runs now
+        for (int t = 0; t < tasks; t++) newJob.run(t);
+        batch.remaining = 0;
+        return;
+    }
+    deal(batch, tasks, int(workers.size()));
+    wake.notify_all();
+}
+WorkPool& sharedWorkPool(void)
+{
+    // started the first time it is asked for, with a worker even on one core, for work started in the background
+    static WorkPool pool(std::max(1, int(std::thread::hardware_concurrency()) - 1));
+    return pool;
+}
+// The shared pool for -1 workers, otherwise a pool of its own with so many; give it back with releasePool
+WorkPool* acquirePool(int workers)
+{
+    return workers < 0 ? &sharedWorkPool() : new WorkPool(workers);
+}
+void releasePool(WorkPool* pool)
+{
+    if (pool != &sharedWorkPool()) delete pool;
+}
+/*---  (END) WorkPool Class ---*/
+#endif
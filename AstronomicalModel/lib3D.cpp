@@ -7,6 +7,7 @@
 //
 
 #include "lib3D.h"
+#include <cstring>
 #define STB_IMAGE_IMPLEMENTATION
 #include <STB/stb_image.h>
 
@@ -66,76 +67,90 @@ namespace myOpenGl3D {
         return fileBuffer;
     }
     
-    // Function: prepareShaders (const char*, const char*)
-    // Create a GLSL program object from vertex and fragment shader files
-    GLuint prepareShaders(const char* vertexShadr, const char* fragmentShadr) {
-        int numShaders = 2;
-        struct Shader {
-            const char*  filename;
-            GLenum       type;
-            GLchar*      source;
-        };
-        Shader shaders[numShaders];
-        shaders[0]= {vertexShadr, GL_VERTEX_SHADER, NULL};
-        shaders[1]= {fragmentShadr, GL_FRAGMENT_SHADER, NULL};
+    // Function: compileShaderFile (const char*, GLenum, const char*)
+    // Read one shader file and compile it; exits with the compiler's log on failure.
+    // Any 'defines' (e.g. "#define IMPOSTOR\n") go in just after the file's #version line.
+    static GLuint compileShaderFile(const char* filename, GLenum type, const char* defines = NULL) {
+        GLchar* source = readShaderSource(filename);
+        if (source == NULL) {
+            std::cerr << "It was not possible to read this shader file: "
+            << filename << std::endl;
+            exit(EXIT_FAILURE);
+        }
         
-        shaderProgram = glCreateProgram();
+        // create the shader, then compile it
+        GLuint shader = glCreateShader(type);
+        const GLchar* afterVersion = strchr(source, '\n');
+        afterVersion = (afterVersion == NULL) ? source + strlen(source) : afterVersion + 1;
+        const GLchar* parts[3] = {source, (defines == NULL) ? "" : defines, afterVersion};
+        GLint lengths[3] = {GLint(afterVersion - source), -1, -1};
+        glShaderSource(shader, 3, parts, lengths);
+        glCompileShader(shader);
+        GLint compiledStatus;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &compiledStatus);
         
-        // read the shader source code, compile it, and attach to GLSL program
-        for (int i = 0; i < numShaders; ++i) {
-            Shader& s = shaders[i];
-            s.source = readShaderSource(s.filename);
-            if (shaders[i].source == NULL) {
-                std::cerr << "It was not possible to read this shader file: "
-                << s.filename << std::endl;
-                exit(EXIT_FAILURE);
-            }
-            
-            // create the shader, then compile it
-            GLuint shader = glCreateShader(s.type);
-            glShaderSource(shader, 1, (const GLchar**) &s.source, NULL);
-            glCompileShader(shader);
-            GLint compiledStatus;
-            glGetShaderiv(shader, GL_COMPILE_STATUS, &compiledStatus);
-            
-            // report any compilation problems
-            if (!compiledStatus) {
-                std::cerr << s.filename << " would not compile. "
-                << "Error detail follows:" << std::endl;
-                GLint logSize;
-                glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &logSize);
-                char* logMsg = new char[logSize];
-                glGetShaderInfoLog(shader, logSize, NULL, logMsg);
-                std::cerr << logMsg << std::endl;
-                gl_log(logMsg);
-                delete [] logMsg;
-                exit(EXIT_FAILURE);
-            }
-            delete [] s.source;
-            glAttachShader(shaderProgram, shader);
+        // report any compilation problems
+        if (!compiledStatus) {
+            std::cerr << filename << " would not compile. "
+            << "Error detail follows:" << std::endl;
+            GLint logSize;
+            glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &logSize);
+            char* logMsg = new char[logSize];
+            glGetShaderInfoLog(shader, logSize, NULL, logMsg);
+            std::cerr << logMsg << std::endl;
+            gl_log(logMsg);
+            delete [] logMsg;
+            exit(EXIT_FAILURE);
         }
-        
-        // link the shaders and report linking problems
-        glLinkProgram(shaderProgram);
+        delete [] source;
+        return shader;
+    }
+    
+    // Function: linkShaderProgram (GLuint)
+    // Link the attached shaders and report linking problems
+    static void linkShaderProgram(GLuint program) {
+        glLinkProgram(program);
         GLint linkedStatus;
-        glGetProgramiv(shaderProgram, GL_LINK_STATUS, &linkedStatus);
+        glGetProgramiv(program, GL_LINK_STATUS, &linkedStatus);
         if (!linkedStatus) {
             std::cerr << "Shader program failed to link" << std::endl;
             GLint logSize;
-            glGetProgramiv(shaderProgram, GL_INFO_LOG_LENGTH, &logSize);
+            glGetProgramiv(program, GL_INFO_LOG_LENGTH, &logSize);
             char* logMsg = new char[logSize];
-            glGetProgramInfoLog(shaderProgram, logSize, NULL, logMsg);
+            glGetProgramInfoLog(program, logSize, NULL, logMsg);
             gl_log(logMsg);
             std::cerr << logMsg << std::endl;
             delete [] logMsg;
             exit(EXIT_FAILURE);
         }
+    }
+    
+    // Function: prepareShaders (const char*, const char*, const char*)
+    // Create a GLSL program object from vertex and fragment shader files,
+    // optionally compiled with some #defines (so one file can serve two programs)
+    GLuint prepareShaders(const char* vertexShadr, const char* fragmentShadr, const char* defines) {
+        shaderProgram = glCreateProgram();
         
-        // and return its ID
-
+        // read the shader source code, compile it, and attach to GLSL program
+        glAttachShader(shaderProgram, compileShaderFile(vertexShadr, GL_VERTEX_SHADER, defines));
+        glAttachShader(shaderProgram, compileShaderFile(fragmentShadr, GL_FRAGMENT_SHADER, defines));
+        
+        // link the shaders, and return its ID
+        linkShaderProgram(shaderProgram);
         return shaderProgram;
     }
     
+    // Function: prepareFeedbackShader (const char*, GLsizei, const char**)
+    // Create a vertex-only GLSL program whose named outputs are captured, one after
+    // another for each vertex, into a single transform feedback buffer
+    GLuint prepareFeedbackShader(const char* vertexShadr, GLsizei numVaryings, const char** varyings) {
+        GLuint program = glCreateProgram();
+        glAttachShader(program, compileShaderFile(vertexShadr, GL_VERTEX_SHADER));
+        glTransformFeedbackVaryings(program, numVaryings, varyings, GL_INTERLEAVED_ATTRIBS);
+        linkShaderProgram(program);
+        return program;
+    }
+    
     void loadTextureImg(const char * imagepath)
     {
         // Create one OpenGL texture
@@ -207,11 +222,6 @@ case Enum: size = Count * sizeof(Type); break
         return size;
     }
     
-    // convert camera location from spherical to euclidean
-    point3 euclidSpherical(GLfloat r,GLfloat th, GLfloat ph) {
-        return point3(r*sin(ph)*sin(th), r*cos(ph), r*cos(th)*sin(ph));
-    }
-    
     // error callback function
     void errorCallb(int errcode, const char* description) {
         fprintf(stderr, "%d: %s\n", errcode, description);
@@ -17,65 +17,30 @@
 #include <OpenGL/gl3.h>
 #define GLFW_DLL
 #include <GLFW/glfw3.h>
-#include <cstdlib>
-#include <iostream>
-#include <vector>
-#include <cmath>
-
-#include <GLM/glm.hpp>
-#include <GLM/gtc/matrix_transform.hpp>
-#include <GLM/gtc/type_ptr.hpp>
-#include <GLM/gtc/quaternion.hpp>
-#include <GLM/gtx/quaternion.hpp>
+#include "lib3DMath.h"
 
 #define GLFW_NO_GLU
 #define  GLFW_INCLUDE_GL3
 
-//  Define M_PI to an extraordinary accuracy
-#ifndef M_PI
-#  define M_PI 3.14159265358979323846
-#endif
-
-// for readability
-typedef glm::vec3 point3;
-typedef glm::vec3 vec3;
-typedef glm::vec4 point4;
-typedef glm::vec4 vec4;
-typedef glm::mat4 matr4;
-typedef glm::mat3 matr3;
-typedef glm::vec2 vec2;
-typedef glm::vec2 point2;
-
-
 // Define a helpful macro for handling offsets into buffer objects
 #define BUFFER_OFFSET( offset )  ((GLvoid*) (offset))
 
 namespace myOpenGl3D {
     
     glm::quat RotationBetweenVectors(vec3, vec3);
-    //  Convenient figure to avoid division by zero errors
-    const GLfloat DivideByZeroTolerance = GLfloat(1.0e-07);
-    
-    //  Degrees-to-radians constant
-    const GLfloat DegreesToRadians = M_PI / 180.0;
-    
     // Create a NULL-terminated string by reading the provided file
     
-    //  function to load vertex and fragment shader files
-    GLuint prepareShaders(const char* vertexShadr, const char* fragmentShadr);
+    //  function to load vertex and fragment shader files, with optional #defines for both
+    GLuint prepareShaders(const char* vertexShadr, const char* fragmentShadr, const char* defines = NULL);
+    
+    //  function to load a vertex shader whose outputs are captured by transform feedback
+    GLuint prepareFeedbackShader(const char* vertexShadr, GLsizei numVaryings, const char** varyings);
     
     void loadTextureImg(const char * imagepath);
     
     /* Helper function to convert GLSL types to storage sizes */
     size_t TypeSize(GLenum type);
     
-    template <typename T> int sgn(T val) {
-        return (T(0) < val) - (val < T(0));
-    }
-    
-    // convert camera location from spherical to euclidean
-    point3 euclidSpherical(GLfloat r,GLfloat th, GLfloat ph);
-    
     // error callback function
     void errorCallb(int errcode, const char* desc);
     
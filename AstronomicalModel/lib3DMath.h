@@ -0,0 +1,61 @@
+//
+//  lib3DMath.h
+//  AstronomicalModel
+//
+//  Created by Matthew McGuire on 10/19/26.
+//  Copyright (c) 2026 Matthew McGuire. All rights reserved.
+//
+//  The part of lib3D that needs no OpenGL: GLM, the short type names, and the few helpers the
+//  model itself uses. The model (AstronObject.h) includes only this, so it builds without GL
+//  (see AstroModelLib.cpp); lib3D.h includes it for everything else.
+
+#ifndef AstronomicalModel_lib3DMath_h
+#define AstronomicalModel_lib3DMath_h
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cmath>
+
+#include <GLM/glm.hpp>
+#include <GLM/gtc/matrix_transform.hpp>
+#include <GLM/gtc/type_ptr.hpp>
+#include <GLM/gtc/quaternion.hpp>
+#include <GLM/gtx/quaternion.hpp>
+
+//  Define M_PI to an extraordinary accuracy
+#ifndef M_PI
+#  define M_PI 3.14159265358979323846
+#endif
+
+// for readability
+typedef glm::vec3 point3;
+typedef glm::vec3 vec3;
+typedef glm::vec4 point4;
+typedef glm::vec4 vec4;
+typedef glm::mat4 matr4;
+typedef glm::mat3 matr3;
+typedef glm::vec2 vec2;
+typedef glm::vec2 point2;
+
+namespace myOpenGl3D {
+
+    //  Convenient figure to avoid division by zero errors
+    const float DivideByZeroTolerance = float(1.0e-07);
+
+    //  Degrees-to-radians constant
+    const float DegreesToRadians = M_PI / 180.0;
+
+    template <typename T> int sgn(T val) {
+        return (T(0) < val) - (val < T(0));
+    }
+
+    // convert camera location from spherical to euclidean
+    inline point3 euclidSpherical(float r, float th, float ph) {
+        return point3(r*sin(ph)*sin(th), r*cos(ph), r*cos(th)*sin(ph));
+    }
+}
+using namespace myOpenGl3D;
+
+#endif
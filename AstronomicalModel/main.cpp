@@ -7,33 +7,35 @@
 //
 
 #include "main.h"
+#include "Benchmarks.h"
 #include <iostream>
 
 /* Primary GLFW display loop */
 void updateDisplay() {
+    redrawNeeded = GL_FALSE;
+    beginGPUTiming();
     glClear(GL_COLOR_BUFFER_BIT| GL_DEPTH_BUFFER_BIT );
-    if (donePausing==GL_TRUE) {
-        lastPauseEnd = glfwGetTime();
-        donePausing = GL_FALSE;
-        if(glfwGetMouseButton(mainWin,GLFW_MOUSE_BUTTON_RIGHT) == GLFW_PRESS)
-            moveCamera();
-        updateCamera();
-        modelAnimate();
-    }
-    // draw scene
-    drawObjects();
+    animateIfDue();
+    // take input, latch the camera and draw scene, after the model's work is done
+    latchAndDraw();
+    endGPUTiming();
 
     nowFPS = glfwGetTime();
     if(nowFPS > fps[1] + 1.0) {
-        char newTitle[50];
-        std::strcpy(newTitle, ("Solar System (" + std::to_string(fpsCounter) + " fps)").c_str());
+        // formatted in place: no strings are built (nor freed) once a second
+        char newTitle[100];
+        snprintf(newTitle, sizeof(newTitle), "Solar System (%u fps)%s%s", fpsCounter,
+                 hoveredObject >= 0 ? " - " : "", hoveredObject >= 0 ? solarSystem.montum[hoveredObject].name.c_str() : "");
         glfwSetWindowTitle(mainWin,newTitle );
+        hudFPS = fpsCounter;
 
         fpsCounter = 0;
         fps[1]=nowFPS;
     }
     else fpsCounter++;
     glfwSwapBuffers(mainWin);
+    collectInputTiming();
+    collectGPUTiming();
     glfwMakeContextCurrent(mainWin);
     if(donePausing==GL_FALSE && (glfwGetTime()-lastPauseEnd)> pauseLength) donePausing = GL_TRUE;
 
@@ -41,18 +43,45 @@ void updateDisplay() {
 
 
 int main(int argc, const char * argv[]) {
+    if (argc > 2 && strcmp(argv[1], "-bench") == 0)     // e.g. -bench shadows 2000
+        return runBenchmark(argv[2], argc > 3 ? atoi(argv[3]) : 0);
+    if (argc > 3 && strcmp(argv[1], "-makestars") == 0)  // e.g. -makestars hipparcos.csv stars.bin
+        return StarCatalog::convertCSV(argv[2], argv[3]) ? 0 : 1;
+    int otherSystems = 0;
+    if (argc > 2 && strcmp(argv[1], "-systems") == 0)    // e.g. -systems 300
+        otherSystems = atoi(argv[2]);
+    const char* resumePath = NULL;
+    if (argc > 2 && strcmp(argv[1], "-resume") == 0)     // e.g. -resume scene.snap
+        resumePath = argv[2];
     std::cout << "Hello, Worlds!\n";
     fps[0] = glfwGetTime();                 // begin to measure 'time to initialize'
     
     initGLFW();
     initOpenGL();
     initTextures();
+    if (otherSystems > 0) {
+        sceneManager.addSyntheticSystems(otherSystems, 3000.0, 9000.0, solarSystem.currentScaleFactor(), 1);
+        std::cout << otherSystems << " other systems, " << sceneManager.totalObjects() << " objects, stepped on "
+        << sceneManager.threads() << " threads\n";
+    }
+    if (liveFeed.open(liveFeedName, uint32_t(solarSystem.numObjects)))
+        std::cout << "Positions are published in shared memory as " << liveFeedName << "\n";
+    publishFeed();
+    if (resumePath != NULL) restoreScene(resumePath);
     
     std::cout << "it took " << glfwGetTime()-fps[0] << " s. to get started.\n";
     /* Enter the main interactive display loop*/
     do{
+        reportEvents();
+        if (sceneIsStill()) {
+            // the same frame would be drawn again: sleep until something happens instead
+            glfwWaitEventsTimeout(idleTimeout);
+            framePacer.restart();
+            lastStepTime = glfwGetTime();   // the time asleep was paused time
+            continue;
+        }
         updateDisplay();
-        glfwPollEvents();
+        framePacer.waitForNextFrame();
     } while (!glfwWindowShouldClose(mainWin));
 
     return 0;
@@ -12,25 +12,44 @@
 #include "lib3D.h"
 #include "BetterSphere.h"
 #include "AstronObject.h"
+#include "ShadowCasters.h"
+#include "BodyBVH.h"
+#include "EventFinder.h"
+#include "StarCatalog.h"
+#include "ParticleBelts.h"
+#include "SphereMeshes.h"
+#include "PlanetTerrain.h"
+#include "HudText.h"
+#include "InputQueue.h"
+#include "FramePacer.h"
+#include "SceneManager.h"
+#include "Snapshot.h"
+#include "LiveFeed.h"
+#include "AstroModelLib.h"
+#include "AntiAliasing.h"
+#include "AccuracyCheck.h"
 
 // Sphere and Solar system objects are initialized
 AstroGroup solarSystem(0.35);       // create a solar system object, passing a spatial scaling value
 
 //**************************************************
 /*@@##====--- OpenGL parameters (BEGIN) ---====##@@*/
-const int numVAO = 3;
-const int numBuffers = 6;
-const int numUBuffs = 3;
+const int numVAO = 9;
+const int numBuffers = 20;
+const int numUBuffs = 7;
 GLuint VertexArrayID[numVAO];       //  Array of Vertex Array Objects
-GLuint program[1];                  //  max. number of shader programs
+GLuint program[13];                 //  max. number of shader programs
 GLuint shaderBuffer[numBuffers];    //  Array of ordinary shader buffers
-GLuint attribLocation[6];           //  Array of shader attribute locations
-GLint uniformLocation[3];           //  Array of uniform variable locations
-GLuint textureName[6];              //  Array of texture names
+GLuint attribLocation[15];          //  Array of shader attribute locations
+GLint uniformLocation[72];          //  Array of uniform variable locations
+GLuint textureName[15];             //  Array of texture names
+GLuint frameBuffer[4];              //  the scene target, its resolve, and the two TAA histories
+GLuint renderBuffer[2];             //  the scene target's multisampled colour and depth
 GLuint uBlockIndex[numUBuffs];      //  Array of Uniform buffer block names
 GLint uBlockSize[numUBuffs];        //  Sizes of Uniform buffer blocks
 GLuint uBlockBinding​[numUBuffs];    //  Names of Uniform block binding, should we use multiple shaders
 GLubyte * uBufferCamera;
+GLubyte * uBufferOverview;          //  the camera block as the overview inset sees it
 enum PolygonModes {LINE, SURFACE, POINT};
 PolygonModes polygonModeToggle = SURFACE;
 /*@@##====--- OpenGL parameters (END) ---====##@@*/
@@ -73,6 +92,70 @@ GLfloat frAspect = 1.0f;            // aspect ratio for perspective frustrum
 GLfloat frNear = 0.1f;              // near side of perspective frustrum
 GLfloat frFar = 10020.0f;            // far side of perspective frustrum
 
+int hoveredObject = -1;             // object under the cursor (index in montum), or -1
+int selectedObject = -1;            // object last clicked on, or -1
+enum SphereSources {PROCEDURALSPHERE, UVSPHERE, ICOSPHERE, CUBESPHERE, numSphereSources};
+GLint sphereSource = PROCEDURALSPHERE;  // the BetterSphere built in the vertex shader, with no buffers
+GLint uploadedSphere = -1;          // the sphere source whose arrays are in shader buffers 0-2
+GLsizei sphereMeshIndices = 0;      // indices in shader buffer 0
+int icoSubdivisions = 5;            // 20480 triangles, about a third of the UV sphere's greatest error
+int cubeDivisions = 40;             // 19200 triangles, about three quarters of it
+GLboolean useImpostors = GL_TRUE;
+GLfloat impostorRadius = 6.0;       // objects smaller than this on screen (radius in pixels) are ray-cast impostors
+std::vector<GLint> meshBodies;      // objects drawn as sphere meshes this frame
+std::vector<GLint> impostorBodies;  // objects drawn as impostors this frame
+GLboolean useTerrain = GL_TRUE;
+GLfloat terrainRadius = 150.0;      // objects bigger than this on screen (radius in pixels) are drawn as quadtree terrain
+GLfloat terrainPixelError = 4.0;    // terrain patches are split until their vertices are closer than this on screen
+int terrainUploadsPerFrame = 8;     // height tiles sent to the GPU in one frame, at most
+PlanetTerrain planetTerrain;        // the terrain quadtrees, their height tiles, and the thread that reads them
+std::vector<GLint> terrainBodies;   // objects drawn as terrain this frame
+GLboolean followSelected = GL_FALSE;    // circle the selected object instead of the origin
+GLboolean showOverview = GL_TRUE;   // the bird's-eye inset in the top right corner
+GLfloat overviewFraction = 0.3;     // the inset's side, as a fraction of the window's shorter side
+GLfloat systemExtent = 0.0;         // how far from the Sun any object reaches
+GLboolean overviewStale = GL_TRUE;  // systemExtent needs measuring again (the scale or the objects changed)
+GLfloat overviewExtent = 0.0;       // how far from the Sun the inset reaches, as last uploaded
+GLsizei overviewSide = 0;           // the inset's side in pixels, as last uploaded
+GLfloat overviewMinRadius = 0.0;    // the least radius objects are drawn with in the inset, as last uploaded
+GLsizei orbitParamSlots = 0;        // objects shader buffer 7 has room for (a few more than there are)
+GLsizei bodyParamSlots = 0;         // objects shader buffer 11 has room for
+int craftLaunched = 0;              // craft added with 'c', to name the next one
+const char* snapshotPath = "scene.snap";    // written with 'w', read back with 'r'
+LiveFeedWriter liveFeed;            // the objects' positions for other processes, in shared memory (see LiveFeed.h)
+const char* liveFeedName = "/astronomicalmodel-feed";
+SceneManager sceneManager(-1);       // other star systems, stepped on a pool of threads and drawn as impostors
+GLboolean showHud = GL_TRUE;        // the panel of simulation time, speed and scale in the top left corner
+GLfloat hudScale = 2.0;             // screen pixels per glyph atlas texel
+HudText hudText;                    // the panel's characters, as sent to shader buffer 16
+GLuint hudFPS = 0;                  // frames drawn in the last whole second
+InputQueue inputQueue;              // mouse events as they arrived, taken once a frame just before the camera is latched
+LatencyTracker inputLatency;        // input-to-present times of the last frames that moved the camera
+GLboolean steering = GL_FALSE;      // the right button is held: the cursor's offset from the centre turns the camera
+GLdouble lastSteerTime = 0.0;       // when the camera was last turned, to turn it by the time since
+GLdouble frameInputTime = -1.0;     // the earliest camera input taken this frame, or -1
+GLdouble frameLatchTime = 0.0;      // when this frame's camera was latched
+GLint64 frameLatchGPUTime = 0;      // the GL's clock at the same moment, in ns
+const int numTimerQueries = 4;      // frames whose finishing time can be waited on at once
+GLuint timerQuery[numTimerQueries];
+struct PendingFrame { GLdouble inputTime, latchTime, submitTime; GLint64 latchGPUTime; GLboolean waiting; };
+PendingFrame pendingFrames[numTimerQueries];
+int nextTimerQuery = 0;
+FramePacer framePacer(60.0);        // holds the frames to a steady rate, and reports what they cost
+const GLdouble paceRates[4] = {60.0, 120.0, 30.0, 0.0};     // the target rates 'k' cycles through (0: unpaced)
+int paceRate = 0;
+GLboolean simulationPaused = GL_FALSE;
+GLboolean redrawNeeded = GL_TRUE;   // something (a key, the window) changed what would be drawn
+GLdouble idleTimeout = 0.5;         // seconds to sleep waiting for events when nothing moves
+GLuint gpuTimerQuery[numTimerQueries];      // GL_TIME_ELAPSED over each frame's drawing
+GLboolean gpuQueryWaiting[numTimerQueries];
+int nextGPUQuery = 0;
+GLboolean gpuQueryActive = GL_FALSE;
+AntiAliasing antiAliasing;          // the scene target's samples and post-pass, chosen with 'a' and 'z'
+GLboolean sceneTargetsStale = GL_TRUE;  // the targets need making again (the window or the mode changed)
+matr4 sceneViewProj;                // this frame's view-projection without the TAA jitter
+const GLfloat taaHistoryWeight = 0.9;   // the share of the history in each TAA frame
+
 GLfloat accelFactor = 0.2f;
 GLfloat zoomFactor = 0.15f;
 GLfloat rShift;                 // magnitude of mouse scroll event
@@ -83,13 +166,40 @@ float simulationSpeed = 1.0;
 GLboolean donePausing = GL_TRUE;
 GLdouble lastPauseEnd;
 GLdouble pauseLength = 0.02;    // update wait duration (in seconds) for mouse-driven events
-matr4 objTransforms[20];        // array of model transforms for each object
+GLdouble lastStepTime = 0.0;    // when the model last stepped, or was last found paused
+const GLdouble longestStep = 0.1;   // the most wall time one paced step stands for: a longer stall is not caught up
+std::vector<CompactTransform> objTransforms;    // model transform for each object, uploaded as a texture buffer
+ShadowCasters shadowCasters;        // per-object lists of spheres that may eclipse the Sun
+BodyBVH bodyBVH;                    // bounding spheres of every object, for spatial queries
+EventFinder eventFinder(0);         // eclipses, transits and close approaches in the coming year
+enum ShadowModes {NOSHADOWS, LISTEDSHADOWS, NAIVESHADOWS, numShadowModes};
+GLint shadowMode = LISTEDSHADOWS;
+enum OrbitModes {NOORBITS, ORBITPATHS, ORBITSANDTRAILS, numOrbitModes};
+GLint orbitMode = ORBITPATHS;
+const GLint orbitSegments = 128;    // line segments in each orbit path
+const GLint trailLength = 256;      // simulation steps remembered in each trail
+GLint trailHead = 0;                // ring buffer slot written most recently
+GLint trailFilled = 0;              // ring buffer slots written so far
+int trailBodies = 0;                // number of objects the ring buffer was allocated for
+const char* starCatalogPath = "stars.bin";
+GLfloat starMagnitudeLimit = 7.5;   // faintest stars that can be seen
+GLsizei starsDrawn = 0;             // stars in shaderBuffer[9], brightest first
+double simulationMinutes = 0.0;     // simulation time since start, drives the belt particles
+ParticleBelts particleBelts;        // belt and ring orbits, only until they are uploaded
+GLsizei particlesDrawn = 0;         // particles in shaderBuffer[particleBuffer]
+int particleBuffer = 10;            // 10 or 19: which of the two particle buffers holds them now
+double particleEpoch = 0.0;         // simulationMinutes when the particles were at their phases
+const double particleRebaseMinutes = 30.0*24.0*60.0;    // how far the particles' float clock may run
+GLboolean showParticles = GL_TRUE;
+GLboolean gpuHierarchy = GL_FALSE;  // evaluate the object tree in HierarchyGLSL.vert instead of updateMontum
+double hierarchyEpoch = 0.0;        // simulationMinutes when the GPU's starting angles were captured
+const double hierarchyResyncMinutes = 24.0*60.0;    // how often the CPU catches up, in GPU mode
 /*@@##====--- Simulation parameters (END) ---====##@@*/
 
 //*********************************************************
 /*@@##====--- General helper functions (BEGIN) ---====##@@*/
 // This reportParam function sends various parameters to stdout for problem-solving
-enum {simspeed,simscale};
+enum {simspeed,simscale,simshadows,simorbits,simhierarchy,simimpostors,simsphere,simterrain,simfollow,siminput,simpacing,simantialias};
 void reportParam(int report)
 {
     float hoursPerSecond;
@@ -98,11 +208,79 @@ void reportParam(int report)
         case simspeed:
             hoursPerSecond = simulationSpeed/pauseLength;         // number of simulation 'hours' per sec.
             hoursPerSecond = float(int(hoursPerSecond*100.0))/100.0;    // round to hundredths
-            std::cout << "Simulation speed: " << hoursPerSecond << " hours per second" << std::endl;
+            std::cout << "Simulation speed: " << hoursPerSecond << " hours per second"
+            << (simulationPaused ? " (paused)" : "") << std::endl;
             break;
         case simscale:
             std::cout << "Simulation Scale: " << solarSystem.currentScaleFactor() << std::endl;
             break;
+        case simshadows:
+            std::cout << "Shadows: " << (shadowMode == NOSHADOWS ? "off" :
+                                         shadowMode == LISTEDSHADOWS ? "occluder lists" : "every body")
+            << " (" << shadowCasters.totalOccluders() << " occluders listed)" << std::endl;
+            break;
+        case simorbits:
+            std::cout << "Orbits: " << (orbitMode == NOORBITS ? "off" :
+                                        orbitMode == ORBITPATHS ? "paths" : "paths and trails") << std::endl;
+            break;
+        case simhierarchy:
+            std::cout << "Object tree evaluated on the " << (gpuHierarchy ? "GPU" : "CPU") << std::endl;
+            break;
+        case simimpostors:
+            if (useImpostors)
+                std::cout << "Impostors: objects under " << impostorRadius << " pixels ("
+                << impostorBodies.size() << " of " << solarSystem.numObjects << " last frame)" << std::endl;
+            else
+                std::cout << "Impostors: off" << std::endl;
+            break;
+        case simsphere:
+            std::cout << "Sphere mesh: " << (sphereSource == PROCEDURALSPHERE ? "UV sphere built from gl_VertexID" :
+                                             sphereSource == UVSPHERE ? "UV sphere from buffers" :
+                                             sphereSource == ICOSPHERE ? "icosphere from buffers" : "cube-sphere from buffers")
+            << " (" << (sphereSource == PROCEDURALSPHERE ? solarSystem.s.stripVertices() : sphereMeshIndices)
+            << " vertices per object)" << std::endl;
+            break;
+        case simterrain:
+            if (useTerrain)
+                std::cout << "Terrain: objects over " << terrainRadius << " pixels (" << terrainBodies.size()
+                << " last frame, " << planetTerrain.patches.size() << " patches, " << planetTerrain.residentTiles()
+                << " height tiles in, " << planetTerrain.waitingTiles() << " waiting)" << std::endl;
+            else
+                std::cout << "Terrain: off" << std::endl;
+            break;
+        case simfollow:
+            if (followSelected && selectedObject >= 0)
+                std::cout << "Camera following " << solarSystem.montum[selectedObject].name << std::endl;
+            else
+                std::cout << "Camera circling the origin" << std::endl;
+            break;
+        case siminput:
+            if (inputLatency.count() > 0) {
+                LatencySample mean = inputLatency.mean(), worst = inputLatency.worst();
+                std::cout << "Input to latch / submit / GPU done, last " << inputLatency.count() << " frames with input: mean "
+                << 1000.0*mean.toLatch << " / " << 1000.0*mean.toSubmit << " / " << 1000.0*mean.toPresent << " ms, worst "
+                << 1000.0*worst.toLatch << " / " << 1000.0*worst.toSubmit << " / " << 1000.0*worst.toPresent << " ms ("
+                << inputQueue.droppedEvents() << " events dropped)" << std::endl;
+            }
+            else
+                std::cout << "Input latency: no frames with camera input yet" << std::endl;
+            break;
+        case simpacing:
+            if (framePacer.targetRate > 0.0)
+                std::cout << "Frames: paced to " << framePacer.targetRate << " per second; ";
+            else
+                std::cout << "Frames: unpaced; ";
+            std::cout << framePacer.report.frames << " in the last second, " << 1000.0*framePacer.report.meanFrame << " ms mean, "
+            << 1000.0*framePacer.report.deviation << " ms deviation, " << 1000.0*framePacer.report.worstFrame << " ms worst; CPU "
+            << 100.0*framePacer.report.cpuUse << "%, GPU " << 100.0*framePacer.report.gpuUse << "%" << std::endl;
+            break;
+        case simantialias:
+            std::cout << "Anti-aliasing: " << antiAliasing.samples() << " samples";
+            if (antiAliasing.samples() < AntiAliasing::sampleCount(antiAliasing.sampleChoice))
+                std::cout << " (" << AntiAliasing::sampleCount(antiAliasing.sampleChoice) << " asked for)";
+            std::cout << ", post-pass " << antiAliasing.postFilterName() << ", "
+            << antiAliasing.targetBytes()/(1024.0*1024.0) << " MB of targets" << std::endl;
+            break;
     }
 }
 void togglePolyMode(void)
@@ -123,22 +301,503 @@ void togglePolyMode(void)
         break;
     }
 }
-void moveCamera(void)
+void moveCamera(GLdouble seconds)
 {
-    // Obtain current mouse location from GLFW
+    // Take the cursor position last queued (see processInput)
     // Then normalize the x and y positions to [-1,1]
-    glfwGetCursorPos(mainWin, &xCursorPos, &yCursorPos);
     GLdouble displacedHorizontal = (xCursorPos-halfWinWidth)/halfWinWidth;
     GLdouble displacedVertical = (yCursorPos-halfWinHeight)/halfWinHeight;
     
     // Compute the acceleration (exponentially) based on distance from window midpoint.
-    // Modify the camera spherical coordinates to change the viewing location accordingly
-    camEyeθ += fabs(accelFactor*pow(displacedHorizontal,2.0))* sgn(displacedHorizontal);
-    camEyeφ += fabs(accelFactor*pow(displacedVertical,2.0))* sgn(displacedVertical);
+    // Modify the camera spherical coordinates to change the viewing location accordingly;
+    // the turn is accelFactor per pauseLength, scaled to the time since the last one
+    GLdouble steps = seconds / pauseLength;
+    camEyeθ += fabs(accelFactor*pow(displacedHorizontal,2.0))* sgn(displacedHorizontal) * steps;
+    camEyeφ += fabs(accelFactor*pow(displacedVertical,2.0))* sgn(displacedVertical) * steps;
     camEyeθ = smallPiBound(camEyeθ);
     camEyeφ = smallPiBound(camEyeφ);
     camRight = {cos(camEyeθ),0,-sin(camEyeθ)};
-    camUp = glm::cross(camEye,camRight);
+    camUp = glm::cross(camEye-camAt,camRight);
+}
+// Gather each object's transform, rebuild the occluder lists, and send both to the texture buffers
+void uploadObjectData(void)
+{
+    objTransforms.resize(solarSystem.numObjects);
+    // gather each object's drawn transform (32 bytes; expanded to a matrix in the vertex shader)
+    for (int i=0; i < solarSystem.numObjects; i++)      // a free slot is drawn at no size
+        objTransforms[i] = solarSystem.alive(i) ? solarSystem.montum[i].modelTransform :
+                                                  CompactTransform(glm::quat(), point3(0.0), 0.0);
+    glBindBuffer(GL_TEXTURE_BUFFER, shaderBuffer[4]);
+    glBufferData(GL_TEXTURE_BUFFER, sizeof(objTransforms[0]) * objTransforms.size(),
+                 &objTransforms.front(), GL_STREAM_DRAW);
+
+    shadowCasters.update(solarSystem);
+    glBindBuffer(GL_TEXTURE_BUFFER, shaderBuffer[5]);
+    glBufferData(GL_TEXTURE_BUFFER, sizeof(shadowCasters.spheres[0]) * shadowCasters.spheres.size(),
+                 &shadowCasters.spheres.front(), GL_STREAM_DRAW);
+    glBindBuffer(GL_TEXTURE_BUFFER, shaderBuffer[6]);
+    glBufferData(GL_TEXTURE_BUFFER, sizeof(shadowCasters.occluders[0]) * shadowCasters.occluders.size(),
+                 &shadowCasters.occluders.front(), GL_STREAM_DRAW);
+    glUniform1i(uniformLocation[4], solarSystem.numObjects);
+}
+// Send one sphere model's arrays to shader buffers 0-2 and point VAO 0's mesh attributes at them
+void uploadSphereSpec(sphereSpec& mesh)
+{
+    glBindVertexArray(VertexArrayID[0]);
+
+    // Sphere model Indices are placed into shader buffer 0
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, shaderBuffer[0]);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+                 (sizeof(mesh.indices[0]) * mesh.numIndices),
+                 &mesh.indices.front(),GL_STATIC_DRAW);
+    
+    // Sphere model Vertices and Norms are placed into shader buffer 1
+    glBindBuffer(GL_ARRAY_BUFFER, shaderBuffer[1]);
+    glBufferData(GL_ARRAY_BUFFER,
+                 ((sizeof(mesh.vertices[0])+sizeof(mesh.norms[0]))
+                  * mesh.numVertices),NULL,GL_STATIC_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0,
+                    (sizeof(mesh.vertices[0]) * mesh.numVertices),
+                    &mesh.vertices.front());
+    glBufferSubData(GL_ARRAY_BUFFER,
+                    (sizeof(mesh.vertices[0]) * mesh.numVertices),
+                    (sizeof(mesh.norms[0]) * mesh.numVertices),
+                    &mesh.norms.front());
+    
+    // Sphere model texture map coords (stMap) are placed into shader buffer 2
+    glBindBuffer(GL_ARRAY_BUFFER, shaderBuffer[2]);
+    glBufferData(GL_ARRAY_BUFFER,
+                 ((sizeof(mesh.stMap[0]))
+                  * mesh.numVertices),
+                 &mesh.stMap.front(),GL_STATIC_DRAW);
+    
+    // the shader variables 'vPosition', 'vNormal', and 'textureSTMap' are connected as vertex attribs
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, shaderBuffer[0]);
+    glBindBuffer(GL_ARRAY_BUFFER, shaderBuffer[1]);
+    glVertexAttribPointer(attribLocation[0],3,GL_FLOAT,GL_FALSE,0,BUFFER_OFFSET(0));
+
+    glVertexAttribPointer(attribLocation[1],3,GL_FLOAT,GL_FALSE,0,
+                          BUFFER_OFFSET(sizeof(mesh.vertices[0]) * mesh.numVertices));
+
+    glBindBuffer(GL_ARRAY_BUFFER, shaderBuffer[2]);
+    glVertexAttribPointer(attribLocation[2],2,GL_FLOAT,GL_FALSE,0,BUFFER_OFFSET(0));
+    sphereMeshIndices = mesh.numIndices;
+}
+// Generate the arrays of the chosen sphere source and upload them, then free the arrays again:
+// they last only as long as the upload. The sphere built from gl_VertexID needs none of this.
+void uploadSphereMesh(void)
+{
+    if (sphereSource == PROCEDURALSPHERE || uploadedSphere == sphereSource) return;
+    if (sphereSource == UVSPHERE) {
+        solarSystem.s.generate();
+        uploadSphereSpec(solarSystem.s.theSphere);
+        solarSystem.s.release();
+    }
+    else if (sphereSource == ICOSPHERE) {
+        IcoSphere ico(icoSubdivisions);
+        uploadSphereSpec(ico.theSphere);
+    }
+    else {
+        CubeSphere cube(cubeDivisions);
+        uploadSphereSpec(cube.theSphere);
+    }
+    uploadedSphere = sphereSource;
+}
+void setSphereSource(GLint source)
+{
+    sphereSource = source;
+    uploadSphereMesh();
+    glUseProgram(program[0]);
+    glUniform1i(uniformLocation[33], sphereSource == PROCEDURALSPHERE ? solarSystem.s.getFans() : 0);
+    reportParam(simsphere);
+}
+// Each object's parent and orbit radius, as its texel of shader buffer 7; a free slot's orbit is a point
+glm::vec2 orbitParamsOf(int i)
+{
+    if (!solarSystem.alive(i)) return glm::vec2(0.0);
+    return glm::vec2(float(std::max(solarSystem.parentOf[i], 0)), solarSystem.montum[i].trueOrbitRadius());
+}
+// Send each object's parent and orbit radius to its texture buffer. The orbit paths are built from
+// these in OrbitGLSL.vert, which applies the viewing scale itself, so this is only needed when objects
+// are added past the room left for them (see refreshBodySlots).
+void uploadOrbitParams(void)
+{
+    orbitParamSlots = solarSystem.numObjects + solarSystem.numObjects/4 + 16;
+    std::vector<glm::vec2> orbitParams(orbitParamSlots, glm::vec2(0.0));
+    for (int i=0; i < solarSystem.numObjects; i++)
+        orbitParams[i] = orbitParamsOf(i);
+    glBindBuffer(GL_TEXTURE_BUFFER, shaderBuffer[7]);
+    glBufferData(GL_TEXTURE_BUFFER, sizeof(orbitParams[0]) * orbitParams.size(), &orbitParams.front(), GL_STATIC_DRAW);
+}
+// Add the current centres to the trail ring buffer. They are copied from the bounding sphere
+// buffer (shaderBuffer[5]) on the GPU, so one step adds one slot and nothing else is re-sent.
+void appendTrailPoints(void)
+{
+    if (orbitMode != ORBITSANDTRAILS) return;
+    GLsizeiptr slotSize = sizeof(glm::vec4) * solarSystem.numObjects;
+    if (trailBodies != solarSystem.numObjects) {
+        glBindBuffer(GL_TEXTURE_BUFFER, shaderBuffer[8]);
+        glBufferData(GL_TEXTURE_BUFFER, slotSize * trailLength, NULL, GL_DYNAMIC_COPY);
+        trailBodies = solarSystem.numObjects;
+        trailFilled = 0;
+    }
+    trailHead = (trailFilled == 0) ? 0 : (trailHead+1) % trailLength;
+    glBindBuffer(GL_COPY_READ_BUFFER, shaderBuffer[5]);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, shaderBuffer[8]);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, slotSize * trailHead, slotSize);
+    trailFilled = std::min(trailFilled+1, trailLength);
+}
+// Map a star catalog and send it to the star vertex buffer (shaderBuffer[9]) straight from
+// the mapping, in one glBufferData. Stars too faint to show are left out; the catalog is
+// sorted brightest first, so they are simply the end of the file.
+bool loadStars(const char* path)
+{
+    StarCatalog catalog;
+    starsDrawn = 0;
+    if (!catalog.open(path)) return false;
+    GLsizei numStars = catalog.countBrighterThan(starMagnitudeLimit + 1.5);
+    glBindBuffer(GL_ARRAY_BUFFER, shaderBuffer[9]);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(StarRecord) * numStars, catalog.stars, GL_STATIC_DRAW);
+    starsDrawn = numStars;
+    std::cout << "Stars: " << starsDrawn << " of " << catalog.count << " in " << path << std::endl;
+    return true;
+}
+// Point a VAO's two particle attributes at one of the particle buffers
+void pointParticleArrays(GLuint vao, GLuint buffer, GLuint orbitAttrib, GLuint nodeAttrib)
+{
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    glVertexAttribPointer(orbitAttrib,4,GL_FLOAT,GL_FALSE,sizeof(ParticleOrbit),BUFFER_OFFSET(0));
+    glVertexAttribPointer(nodeAttrib,2,GL_FLOAT,GL_FALSE,sizeof(ParticleOrbit),
+                          BUFFER_OFFSET(offsetof(ParticleOrbit, node)));
+    glEnableVertexAttribArray(orbitAttrib);
+    glEnableVertexAttribArray(nodeAttrib);
+    glBindVertexArray(VertexArrayID[0]);
+}
+// Send the belt and ring particle orbits to their static vertex buffer (shaderBuffer[10]), make
+// room for them in the other (shaderBuffer[19]), then drop the CPU copy: nothing about a particle
+// is ever sent again.
+void uploadParticles(void)
+{
+    GLsizeiptr bytes = sizeof(ParticleOrbit) * particleBelts.size();
+    glBindBuffer(GL_ARRAY_BUFFER, shaderBuffer[10]);
+    glBufferData(GL_ARRAY_BUFFER, bytes, particleBelts.size() > 0 ? &particleBelts.orbits.front() : NULL, GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, shaderBuffer[19]);
+    glBufferData(GL_ARRAY_BUFFER, bytes, NULL, GL_STATIC_DRAW);
+    particlesDrawn = particleBelts.size();
+    particleEpoch = 0.0;                                // the phases are for time zero
+    particleBuffer = 10;
+    pointParticleArrays(VertexArrayID[3], shaderBuffer[10], attribLocation[6], attribLocation[7]);
+    particleBelts.release();
+}
+// Once the particles' clock has run particleRebaseMinutes, a transform feedback pass (program 12)
+// moves every phase on to now, from one particle buffer into the other, and the draws then read
+// that one, so the shader's float clock stays small enough that the belts and rings do not jitter
+// at large simulation times. Nothing is sent or read back.
+void rebaseParticles(void)
+{
+    int from = particleBuffer, to = (particleBuffer == 10) ? 19 : 10;
+    pointParticleArrays(VertexArrayID[8], shaderBuffer[from], attribLocation[13], attribLocation[14]);
+    glEnable(GL_RASTERIZER_DISCARD);
+    glUseProgram(program[12]);
+    glBindVertexArray(VertexArrayID[8]);
+    glUniform1f(uniformLocation[65], GLfloat(simulationMinutes - particleEpoch));
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, shaderBuffer[to]);
+    glBeginTransformFeedback(GL_POINTS);
+    glDrawArrays(GL_POINTS, 0, particlesDrawn);
+    glEndTransformFeedback();
+    glDisable(GL_RASTERIZER_DISCARD);
+    particleBuffer = to;
+    particleEpoch = simulationMinutes;
+    pointParticleArrays(VertexArrayID[3], shaderBuffer[to], attribLocation[6], attribLocation[7]);
+}
+// One object's two texels of shader buffer 11: parent, orbit radius, orbit rate, orbit angle, then spin
+// rate, spin angle, tilt, radius. A free slot has no parent and no size, so it is a point at the origin.
+void bodyParamsOf(int i, glm::vec4* texels)
+{
+    if (!solarSystem.alive(i)) {
+        texels[0] = glm::vec4(-1.0, 0.0, 0.0, 0.0);
+        texels[1] = glm::vec4(0.0);
+        return;
+    }
+    AstroObject& obj = solarSystem.montum[i];
+    texels[0] = glm::vec4(float(solarSystem.parentOf[i]), obj.trueOrbitRadius(),
+                          float(obj.orbitRate()), obj.currentOrbitAngle);
+    texels[1] = glm::vec4(float(obj.rotationRate()), obj.currentRotAngle, obj.tilt(), obj.trueRadius());
+}
+// Send every object's fixed orbit and spin parameters, with its angles as they are now, for
+// HierarchyGLSL.vert (two texels per object). The angles belong to time hierarchyEpoch.
+void uploadBodyParams(void)
+{
+    bodyParamSlots = solarSystem.numObjects + solarSystem.numObjects/4 + 16;
+    std::vector<glm::vec4> bodyParams(2*bodyParamSlots, glm::vec4(-1.0, 0.0, 0.0, 0.0));
+    for (int i=0; i < solarSystem.numObjects; i++)
+        bodyParamsOf(i, &bodyParams[2*i]);
+    glBindBuffer(GL_TEXTURE_BUFFER, shaderBuffer[11]);
+    glBufferData(GL_TEXTURE_BUFFER, sizeof(bodyParams[0]) * bodyParams.size(), &bodyParams.front(), GL_STATIC_DRAW);
+}
+// Write the objects as the CPU has them into the live feed, as of hierarchyEpoch: each step, or with
+// the object tree on the GPU each time the CPU catches up. Free slots go out with radius 0.
+void publishFeed(void)
+{
+    if (!liveFeed.isOpen() || !liveFeed.beginFrame(uint32_t(solarSystem.numObjects))) return;
+    float* a[numFeedArrays];
+    for (int k = 0; k < numFeedArrays; k++) a[k] = liveFeed.array(k);
+    for (int i = 0; i < solarSystem.numObjects; i++) {
+        const CompactTransform& t = solarSystem.montum[i].modelTransform;
+        bool alive = solarSystem.alive(i);
+        a[FEEDX][i] = t.translation.x;
+        a[FEEDY][i] = t.translation.y;
+        a[FEEDZ][i] = t.translation.z;
+        a[FEEDQX][i] = t.rotation.x;
+        a[FEEDQY][i] = t.rotation.y;
+        a[FEEDQZ][i] = t.rotation.z;
+        a[FEEDQW][i] = t.rotation.w;
+        a[FEEDRADIUS][i] = alive ? t.scale : 0.0f;
+    }
+    liveFeed.endFrame(hierarchyEpoch);
+}
+// Bring the CPU's object tree up to the simulation time in one step (every orbit is a circle,
+// so one long step lands where many short ones would), then refresh what is built from it.
+void syncCPUHierarchy(void)
+{
+    double elapsed = simulationMinutes - hierarchyEpoch;
+    if (elapsed > 0.0 || solarSystem.rescaled()) solarSystem.updateMontum(float(elapsed));
+    hierarchyEpoch = simulationMinutes;
+    bodyBVH.refit(solarSystem);
+    uploadObjectData();
+    publishFeed();
+}
+// In GPU mode the CPU catches up once every hierarchyResyncMinutes. That keeps the occluder
+// lists and picking close to what is drawn, and keeps hierarchyMinutes small enough for floats.
+void resyncHierarchy(void)
+{
+    syncCPUHierarchy();
+    uploadBodyParams();
+}
+// Transform feedback pass: write every object's transform (shaderBuffer[4]) and bounding
+// sphere (shaderBuffer[5]) on the GPU, in place of the uploads made by uploadObjectData
+void evaluateHierarchy(void)
+{
+    glEnable(GL_RASTERIZER_DISCARD);
+    glBindVertexArray(VertexArrayID[1]);
+    glActiveTexture(GL_TEXTURE6);
+    glBindTexture(GL_TEXTURE_BUFFER, textureName[6]);
+    glActiveTexture(GL_TEXTURE0);
+    GLfloat minutes = GLfloat(simulationMinutes - hierarchyEpoch);
+    for (int pass = 0; pass < 2; pass++) {
+        glUseProgram(program[4+pass]);
+        glUniform1f(uniformLocation[23+2*pass], minutes);
+        glUniform1f(uniformLocation[54+pass], solarSystem.currentScaleFactor());
+        glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, shaderBuffer[4+pass]);
+        glBeginTransformFeedback(GL_POINTS);
+        glDrawArrays(GL_POINTS, 0, solarSystem.numObjects);
+        glEndTransformFeedback();
+    }
+    glDisable(GL_RASTERIZER_DISCARD);
+    glBindVertexArray(VertexArrayID[0]);
+    glUseProgram(program[0]);
+}
+void toggleGPUHierarchy(void)
+{
+    gpuHierarchy = !gpuHierarchy;
+    if (gpuHierarchy) {
+        resyncHierarchy();
+        evaluateHierarchy();
+    }
+    else
+        syncCPUHierarchy();
+    reportParam(simhierarchy);
+}
+// After objects were added or removed, bring up to date what was built from the set of them. While
+// the slots in use fit the parameter buffers, only the changed slots are sent (glBufferSubData);
+// past that the buffers are made again with room to spare. The BVH is built again for the new tree.
+void refreshBodySlots(void)
+{
+    std::vector<int>& changed = solarSystem.changedSlots;
+    if (changed.empty()) return;
+    if (solarSystem.numObjects > orbitParamSlots) uploadOrbitParams();
+    else {
+        glBindBuffer(GL_TEXTURE_BUFFER, shaderBuffer[7]);
+        for (size_t k = 0; k < changed.size(); k++) {
+            glm::vec2 texel = orbitParamsOf(changed[k]);
+            glBufferSubData(GL_TEXTURE_BUFFER, sizeof(texel) * changed[k], sizeof(texel), &texel);
+        }
+    }
+    if (gpuHierarchy && solarSystem.numObjects > bodyParamSlots) uploadBodyParams();
+    else if (gpuHierarchy) {
+        glBindBuffer(GL_TEXTURE_BUFFER, shaderBuffer[11]);
+        for (size_t k = 0; k < changed.size(); k++) {
+            glm::vec4 texels[2];
+            bodyParamsOf(changed[k], texels);
+            glBufferSubData(GL_TEXTURE_BUFFER, sizeof(texels) * changed[k], sizeof(texels), texels);
+        }
+    }
+    changed.clear();
+    if (hoveredObject >= 0 && !solarSystem.alive(hoveredObject)) hoveredObject = -1;
+    if (selectedObject >= 0 && !solarSystem.alive(selectedObject)) {
+        selectedObject = -1;
+        glUseProgram(program[0]);
+        glUniform1i(uniformLocation[6], selectedObject);
+    }
+    bodyBVH.build(solarSystem);
+    uploadObjectData();
+    if (gpuHierarchy) evaluateHierarchy();
+    publishFeed();
+    overviewStale = GL_TRUE;
+}
+// Save the scene (see Snapshot.h): the objects as they are now, with the clock, the scale and the camera.
+// With the object tree on the GPU the CPU's objects are brought up to the clock first.
+bool saveScene(const char* path)
+{
+    if (gpuHierarchy) resyncHierarchy();
+    SnapshotScene scene;
+    memset((void*) &scene, 0, sizeof(scene));
+    scene.simulationMinutes = simulationMinutes;
+    scene.simulationSpeed = simulationSpeed;
+    scene.camEyeTheta = camEyeθ;
+    scene.camEyePhi = camEyeφ;
+    scene.camEyeR = camEyeR;
+    scene.camRight = camRight;
+    scene.camUp = camUp;
+    scene.selectedObject = selectedObject;
+    scene.flags = (simulationPaused ? SNAPSHOTPAUSED : 0) | (followSelected ? SNAPSHOTFOLLOWING : 0);
+    GLdouble start = glfwGetTime();
+    if (!Snapshot::save(path, solarSystem, scene)) return false;
+    std::cout << "Saved " << solarSystem.montum.count() << " objects to " << path << " in "
+              << 1000.0*(glfwGetTime()-start) << " ms" << std::endl;
+    return true;
+}
+// Resume a saved scene, and build again everything built from the objects. Other star systems are
+// not saved; they only take the saved scale.
+bool restoreScene(const char* path)
+{
+    GLdouble start = glfwGetTime();
+    Snapshot snapshot;
+    if (!snapshot.open(path)) return false;
+    const SnapshotScene& scene = snapshot.scene();
+    sceneManager.adjustScale(scene.scaleFactor - solarSystem.currentScaleFactor());
+    snapshot.restore(solarSystem);
+    simulationMinutes = hierarchyEpoch = scene.simulationMinutes;
+    simulationSpeed = scene.simulationSpeed;
+    simulationPaused = (scene.flags & SNAPSHOTPAUSED) ? GL_TRUE : GL_FALSE;
+    followSelected = (scene.flags & SNAPSHOTFOLLOWING) ? GL_TRUE : GL_FALSE;
+    camEyeθ = scene.camEyeTheta;
+    camEyeφ = scene.camEyePhi;
+    camEyeR = scene.camEyeR;
+    camRight = scene.camRight;
+    camUp = scene.camUp;
+    selectedObject = (scene.selectedObject >= 0 && scene.selectedObject < solarSystem.numObjects &&
+                      solarSystem.alive(scene.selectedObject)) ? scene.selectedObject : -1;
+    hoveredObject = -1;
+    glUseProgram(program[0]);
+    glUniform1i(uniformLocation[6], selectedObject);
+    bodyBVH.build(solarSystem);
+    uploadOrbitParams();
+    if (gpuHierarchy) uploadBodyParams();
+    uploadObjectData();
+    if (gpuHierarchy) evaluateHierarchy();
+    publishFeed();
+    trailFilled = 0;
+    overviewStale = GL_TRUE;
+    redrawNeeded = GL_TRUE;
+    std::cout << "Restored " << solarSystem.montum.count() << " objects from " << path << " in "
+              << 1000.0*(glfwGetTime()-start) << " ms" << std::endl;
+    return true;
+}
+// The viewing scale is a uniform of the shaders that draw from the objects' true sizes (orbits,
+// particles, the GPU hierarchy), so nothing is sent; the objects take it in their next step. Paused,
+// that step is taken at once (for no time) on the CPU, or the tree is only evaluated again on the GPU.
+void changeScale(float change)
+{
+    solarSystem.adjustScale(change);
+    sceneManager.adjustScale(change);
+    overviewStale = GL_TRUE;
+    if (simulationPaused && gpuHierarchy) evaluateHierarchy();
+    else if (simulationPaused) syncCPUHierarchy();
+    reportParam(simscale);
+}
+// Put a craft in orbit about the selected object (the Sun if none is selected). It takes the lowest
+// free slot, if any was left by a removal, and nothing already in the model moves.
+void launchCraft(void)
+{
+    int parent = selectedObject >= 0 ? selectedObject : 0;
+    AstroObject& around = solarSystem.montum[parent];
+    float orbitR = around.trueRadius() * (3.0 + 5.0*float(rand())/RAND_MAX);
+    float period = (parent == 0) ? pow(orbitR/149600000.0, 1.5) : 0.0748 * pow(orbitR/238900.0, 1.5);
+    AstroObject craft("Craft" + std::to_string(++craftLaunched), 50.0, 0.0, 9999.0, orbitR, period,
+                      solarSystem.currentScaleFactor());
+    craft.currentOrbitAngle = twoPi * float(rand())/RAND_MAX;
+    int slot = solarSystem.addObject(craft, parent);
+    std::cout << craft.name << " launched around " << around.name << " (slot " << slot << ")" << std::endl;
+    refreshBodySlots();
+}
+// Remove the selected object, and everything orbiting it. Their slots are left free for reuse.
+void removeSelected(void)
+{
+    if (selectedObject <= 0) return;                // nothing selected, or the Sun
+    std::string name = solarSystem.montum[selectedObject].name;
+    int removed = solarSystem.removeObject(selectedObject);
+    std::cout << name << " removed, with " << removed-1 << " orbiting it; "
+              << solarSystem.montum.count() << " objects in " << solarSystem.numObjects << " slots" << std::endl;
+    refreshBodySlots();
+}
+// With the object tree on the GPU, a scale change reaches the CPU's copy only at its next resync.
+// Picking needs the spheres at the new scale at once, so the copy is stepped for no time (its angles
+// stay at hierarchyEpoch, as the GPU's starting angles do) and the BVH refitted, once per change.
+void rescaleBVH(void)
+{
+    if (!solarSystem.rescaled()) return;
+    solarSystem.updateMontum(0.0);
+    bodyBVH.refit(solarSystem);
+}
+// Which object is under the given window position? Replies with its index in montum, or -1.
+// The cursor is unprojected through modelvMatrix/projMatrix into a ray, and the ray is
+// cast against the object spheres held in bodyBVH, so nothing is read back from the GPU.
+int pickObject(GLdouble xPos, GLdouble yPos)
+{
+    rescaleBVH();
+    GLfloat xNDC = 2.0*xPos/mainWinWidth - 1.0;
+    GLfloat yNDC = 1.0 - 2.0*yPos/mainWinHeight;
+    matr4 inverseViewProj = glm::inverse(projMatrix * modelvMatrix);
+    point4 nearPoint = inverseViewProj * point4(xNDC, yNDC, -1.0, 1.0);
+    point4 farPoint = inverseViewProj * point4(xNDC, yNDC, 1.0, 1.0);
+    point3 rayStart = point3(nearPoint) / nearPoint.w;
+    point3 rayDir = glm::normalize(point3(farPoint) / farPoint.w - rayStart);
+    float tHit;
+    return bodyBVH.raycast(rayStart, rayDir, tHit);
+}
+// Decide which objects are drawn as sphere meshes, which as impostors and which as terrain, by the
+// radius in pixels of each one's outline on screen, and send the first two lists to their instance
+// buffers (shader buffers 12 and 13). An object only becomes terrain once its six root height
+// tiles are on the GPU; until then it stays a mesh. The spheres are the CPU's; with the object tree on the GPU they
+// may be up to hierarchyResyncMinutes old, which only matters for objects near the threshold.
+void classifyBodies(void)
+{
+    meshBodies.clear();
+    impostorBodies.clear();
+    terrainBodies.clear();
+    GLfloat pixelsPerUnit = projMatrix[1][1] * halfWinHeight;  // of a small width at unit distance
+    for (int i=0; i < solarSystem.numObjects; i++) {
+        if (!solarSystem.alive(i)) continue;
+        glm::vec4 sphere = shadowCasters.spheres[i];
+        point3 toCentre = point3(sphere) - camEye;
+        GLfloat outside = glm::dot(toCentre, toCentre) - sphere.w*sphere.w;
+        // the outline's radius is pixelsPerUnit * r/sqrt(d²-r²); the eye inside a sphere gets the mesh
+        if (useImpostors && outside > 0.0 && pixelsPerUnit*sphere.w < impostorRadius*sqrt(outside))
+            impostorBodies.push_back(i);
+        else if (useTerrain && i > 0 && (outside <= 0.0 || pixelsPerUnit*sphere.w > terrainRadius*sqrt(outside))
+                 && planetTerrain.ready(i))
+            terrainBodies.push_back(i);
+        else
+            meshBodies.push_back(i);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, shaderBuffer[12]);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(GLint) * meshBodies.size(),
+                 meshBodies.empty() ? NULL : &meshBodies.front(), GL_STREAM_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, shaderBuffer[13]);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(GLint) * impostorBodies.size(),
+                 impostorBodies.empty() ? NULL : &impostorBodies.front(), GL_STREAM_DRAW);
 }
 /*@@##====--- General helper functions (END) ---====##@@*/
 
@@ -149,11 +808,13 @@ void quitApp(GLFWwindow *mainWin)
 {
     glfwDestroyWindow(mainWin);
     glfwTerminate();
+    liveFeed.close();
     exit(0);
 }
 // Keyboard callback (ascii input)
 void asciiTyping(GLFWwindow* mainWin, unsigned int key)
 {
+    redrawNeeded = GL_TRUE;
     switch (key) {
         case 'Q':
         case 'q':
@@ -166,21 +827,94 @@ void asciiTyping(GLFWwindow* mainWin, unsigned int key)
         case '-':
         break;
         case 'w':
+        saveScene(snapshotPath);
         break;
         case 'e':
+        if (eventFinder.searching()) {
+            std::cout << "The event search is still running" << std::endl;
+            break;
+        }
+        if (gpuHierarchy) resyncHierarchy();    // the search starts from the CPU's angles, so they must be of now
+        eventFinder.startSearch(solarSystem, 365.25*24.0*60.0);
+        std::cout << "Searching the coming year for events..." << std::endl;
+        break;
+        case 'b':
+        showParticles = !showParticles;
+        break;
+        case 'g':
+        toggleGPUHierarchy();
+        break;
+        case 'i':
+        useImpostors = !useImpostors;
+        reportParam(simimpostors);
+        break;
+        case '[':
+        impostorRadius *= 0.5;
+        reportParam(simimpostors);
+        break;
+        case ']':
+        impostorRadius *= 2.0;
+        reportParam(simimpostors);
+        break;
+        case 't':
+        useTerrain = !useTerrain;
+        reportParam(simterrain);
+        break;
+        case 'v':
+        showOverview = !showOverview;
+        break;
+        case 'l':
+        reportParam(siminput);
+        break;
+        case 'u':
+        reportParam(simpacing);
+        break;
+        case 'k':
+        paceRate = (paceRate+1) % 4;
+        framePacer.targetRate = paceRates[paceRate];
+        framePacer.restart();
+        reportParam(simpacing);
+        break;
+        case 'h':
+        showHud = !showHud;
+        break;
+        case 'f':
+        followSelected = !followSelected;
+        reportParam(simfollow);
+        break;
+        case 'p':
+        setSphereSource((sphereSource+1) % numSphereSources);
+        break;
+        case 'o':
+        orbitMode = (orbitMode+1) % numOrbitModes;
+        trailFilled = 0;            // a trail restarts from the present
+        reportParam(simorbits);
         break;
         case 's':
+        shadowMode = (shadowMode+1) % numShadowModes;
+        reportParam(simshadows);
+        break;
+        case 'a':
+        antiAliasing.sampleChoice = (antiAliasing.sampleChoice+1) % AntiAliasing::numSampleChoices;
+        sceneTargetsStale = GL_TRUE;
+        break;
+        case 'z':
+        antiAliasing.postFilter = (antiAliasing.postFilter+1) % numPostFilters;
+        sceneTargetsStale = GL_TRUE;
         break;
         case 'd':
         break;
         case 'x':
+        removeSelected();
         break;
         case 'c':
+        launchCraft();
         break;
         case 'm':
         togglePolyMode();
         break;
         case 'r':
+        restoreScene(snapshotPath);
         break;
         default:
         break;
@@ -192,17 +926,16 @@ void specialKeyTyping(GLFWwindow* mainWin, int key, int scancode, int action, in
     if (action == GLFW_RELEASE) { // only take action when the key is released
         return;
     }
+    redrawNeeded = GL_TRUE;
     switch (key) {
         case GLFW_KEY_ESCAPE:
         quitApp(mainWin);
         break;
         case GLFW_KEY_UP:
-            solarSystem.adjustScale(+0.01);
-            reportParam(simscale);
+            changeScale(+0.01);
         break;
         case GLFW_KEY_DOWN:
-            solarSystem.adjustScale(-0.01);
-            reportParam(simscale);
+            changeScale(-0.01);
         break;
         case GLFW_KEY_LEFT:
             simulationSpeed -= 0.05;
@@ -213,6 +946,9 @@ void specialKeyTyping(GLFWwindow* mainWin, int key, int scancode, int action, in
             reportParam(simspeed);
         break;
         case GLFW_KEY_SPACE:
+            simulationPaused = !simulationPaused;
+            reportParam(simspeed);
+        break;
         default:
         break;
     }
@@ -224,26 +960,86 @@ void windowReshape(GLFWwindow* window, int width, int height)
     mainWinHeight = height;
     halfWinHeight = mainWinWidth/2.0;
     halfWinHeight = mainWinHeight/2.0;
+    sceneTargetsStale = GL_TRUE;
+    redrawNeeded = GL_TRUE;
+}
+// The window was uncovered or needs drawing again, though nothing in the scene moved
+void windowRefresh(GLFWwindow* window)
+{
+    redrawNeeded = GL_TRUE;
 }
+// The mouse callbacks only queue what happened, and when; processInput acts on it
 void screenCursor(GLFWwindow* mainWin, double xpos, double ypos)
 {
-    // nothing to do here. I only poll the x and y pos when needed
-    // but un-comment these should it be necessary:
-    // xCursorPos = xpos;
-    // yCursorPos = ypos;
+    InputEvent event = {glfwGetTime(), CURSORMOVED, xpos, ypos, 0, 0};
+    inputQueue.push(event);
 }
 void mouseFunc(GLFWwindow* window, int button, int action, int mods)
 {
-//    if (button == GLFW_MOUSE_BUTTON_RIGHT && (action == GLFW_PRESS || action == GLFW_REPEAT))
-//        moveCamera();
+    GLdouble xClick, yClick;
+    glfwGetCursorPos(window, &xClick, &yClick);
+    InputEvent event = {glfwGetTime(), BUTTONCHANGED, xClick, yClick, button, action};
+    inputQueue.push(event);
 }
 void scrollFunc(GLFWwindow* mainWin, double xOffset, double yOffset)
 {
-    rShift = sqrt(fabs(yOffset)) * sgn(yOffset) * accelFactor;
-    camEyeR *= (1.0+rShift);
+    InputEvent event = {glfwGetTime(), SCROLLED, xOffset, yOffset, 0, 0};
+    inputQueue.push(event);
 }
 /*@@##====--- GLFW Callback functions (END) ---====##@@*/
 
+// The earliest camera input of the frame is the one its latency is measured from
+void noteCameraInput(GLdouble time)
+{
+    if (frameInputTime < 0.0 || time < frameInputTime) frameInputTime = time;
+}
+// Act on every queued mouse event, in order, then turn the camera by the time since it last
+// turned. Called once a frame, as late as possible: just before the camera is latched. Of a run
+// of cursor moves only the last is picked against, since only it can be seen.
+void processInput(void)
+{
+    InputEvent event;
+    GLboolean cursorMoved = GL_FALSE;
+    frameInputTime = -1.0;
+    while (inputQueue.pop(event)) {
+        switch (event.kind) {
+            case CURSORMOVED:
+                xCursorPos = event.x;
+                yCursorPos = event.y;
+                cursorMoved = GL_TRUE;
+                if (steering) noteCameraInput(event.time);
+                break;
+            case BUTTONCHANGED:
+                if (event.button == GLFW_MOUSE_BUTTON_RIGHT) {
+                    steering = (event.action == GLFW_PRESS);
+                    noteCameraInput(event.time);
+                }
+                else if (event.button == GLFW_MOUSE_BUTTON_LEFT && event.action == GLFW_PRESS) {
+                    selectedObject = pickObject(event.x, event.y);
+                    if (selectedObject >= 0) solarSystem.montum[selectedObject].report(0.0, 0.0);
+                    glUseProgram(program[0]);
+                    glUniform1i(uniformLocation[6], selectedObject);
+                }
+                break;
+            case SCROLLED:
+                rShift = sqrt(fabs(event.y)) * sgn(event.y) * accelFactor;
+                if (followSelected && selectedObject >= 0) {
+                    // over an object the height above it scales, so the ground can be reached in a few turns
+                    GLfloat radius = shadowCasters.spheres[selectedObject].w;
+                    camEyeR = radius + (camEyeR-radius)*(1.0+rShift);
+                }
+                else
+                    camEyeR *= (1.0+rShift);
+                noteCameraInput(event.time);
+                break;
+        }
+    }
+    if (cursorMoved) hoveredObject = pickObject(xCursorPos, yCursorPos);
+    GLdouble now = glfwGetTime();
+    if (steering) moveCamera(now - lastSteerTime);
+    lastSteerTime = now;
+}
+
 
 void initGLFW()
 {
@@ -259,8 +1055,10 @@ void initGLFW()
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-    glfwWindowHint(GLFW_DEPTH_BITS, 32);
-    glfwWindowHint(GLFW_SAMPLES, 16);
+    // the window itself has no samples: anti-aliasing is done in the scene target (see AntiAliasing.h),
+    // where it can be changed while running
+    glfwWindowHint(GLFW_DEPTH_BITS, 24);
+    glfwWindowHint(GLFW_SAMPLES, 0);
     strcpy(windowName,"Solar System");
     mainWin = glfwCreateWindow(mainWinWidth, mainWinHeight, windowName, NULL, NULL);
     if (!mainWin) {
@@ -278,19 +1076,33 @@ void initGLFW()
     //    /* function to handle window resizes */
     //    glfwSetFramebufferSizeCallback(wind, fbreshape);
     glfwSetWindowSizeCallback(mainWin, windowReshape);
+    glfwSetWindowRefreshCallback(mainWin, windowRefresh);
     glfwSetWindowCloseCallback(mainWin,quitApp);
     glfwSetKeyCallback(mainWin, specialKeyTyping);
     glfwSetCharCallback(mainWin, asciiTyping);
     glfwSetCursorPosCallback(mainWin, screenCursor);
     glfwSetScrollCallback(mainWin, scrollFunc);
     glfwSetMouseButtonCallback(mainWin, mouseFunc);
-    glfwSwapInterval(0);    // allows more than 60 FPS (though screen tearing is a risk)
+    glfwSwapInterval(0);    // allows more than 60 FPS (though screen tearing is a risk); framePacer sets the rate
     log_gl_params();
 }
 void initOpenGL()
 {
     glEnable(GL_DEPTH_TEST);
     program[0] = prepareShaders("AstronObjectGLSL.vert", "AstronObjectGLSL.frag");
+    program[1] = prepareShaders("OrbitGLSL.vert", "OrbitGLSL.frag");
+    program[2] = prepareShaders("StarGLSL.vert", "StarGLSL.frag");
+    program[3] = prepareShaders("ParticleGLSL.vert", "ParticleGLSL.frag");
+    const char* transformVaryings[2] = {"transformRotation", "transformTranslationScale"};
+    const char* sphereVaryings[1] = {"sphere"};
+    program[4] = prepareFeedbackShader("HierarchyGLSL.vert", 2, transformVaryings);
+    program[5] = prepareFeedbackShader("HierarchyGLSL.vert", 1, sphereVaryings);
+    program[6] = prepareShaders("ImpostorGLSL.vert", "AstronObjectGLSL.frag", "#define IMPOSTOR\n");
+    program[7] = prepareShaders("TerrainGLSL.vert", "AstronObjectGLSL.frag");
+    program[8] = prepareShaders("OverviewGLSL.vert", "OverviewGLSL.frag");
+    program[9] = prepareShaders("HudGLSL.vert", "HudGLSL.frag");
+    const char* particleVaryings[2] = {"rebasedOrbit", "rebasedNode"};
+    program[12] = prepareFeedbackShader("ParticleRebaseGLSL.vert", 2, particleVaryings);
 
     /*--- Create VAO and buffer stuff  ---*/
     glGenBuffers(numBuffers,shaderBuffer);
@@ -301,55 +1113,332 @@ void initOpenGL()
     // program 0 will use VAO 0
     glUseProgram(program[0]);
     
-    // Sphere model Indices are placed into shader buffer 0
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, shaderBuffer[0]);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER,
-                 (sizeof(solarSystem.s.theSphere.indices[0]) * solarSystem.s.theSphere.numIndices),
-                 &solarSystem.s.theSphere.indices.front(),GL_STATIC_DRAW);
-    
-    // Sphere model Vertices and Norms are placed into shader buffer 1
-    glBindBuffer(GL_ARRAY_BUFFER, shaderBuffer[1]);
-    glBufferData(GL_ARRAY_BUFFER,
-                 ((sizeof(solarSystem.s.theSphere.vertices[0])+sizeof(solarSystem.s.theSphere.norms[0]))
-                  * solarSystem.s.theSphere.numVertices),NULL,GL_STATIC_DRAW);
-    glBufferSubData(GL_ARRAY_BUFFER, 0,
-                    (sizeof(solarSystem.s.theSphere.vertices[0]) * solarSystem.s.theSphere.numVertices),
-                    &solarSystem.s.theSphere.vertices.front());
-    glBufferSubData(GL_ARRAY_BUFFER,
-                    (sizeof(solarSystem.s.theSphere.vertices[0]) * solarSystem.s.theSphere.numVertices),
-                    (sizeof(solarSystem.s.theSphere.norms[0]) * solarSystem.s.theSphere.numVertices),
-                    &solarSystem.s.theSphere.norms.front());
-    
-    // Sphere model texture map coords (stMap) are placed into shader buffer 2
-    glBindBuffer(GL_ARRAY_BUFFER, shaderBuffer[2]);
-    glBufferData(GL_ARRAY_BUFFER,
-                 ((sizeof(solarSystem.s.theSphere.stMap[0]))
-                  * solarSystem.s.theSphere.numVertices),
-                 &solarSystem.s.theSphere.stMap.front(),GL_STATIC_DRAW);
-    
-    // the shader variables 'vPosition', 'vNormal', and 'textureSTMap' are connected as vertex attribs
-    glBindVertexArray(VertexArrayID[0]);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, shaderBuffer[0]);
-    glBindBuffer(GL_ARRAY_BUFFER, shaderBuffer[1]);
+    // the shader variables 'vPosition', 'vNormal', and 'textureSTMap' are only read from buffers for
+    // the buffered sphere sources; by default the sphere is built from gl_VertexID (no buffers at all)
     attribLocation[0] = glGetAttribLocation(program[0], "vPosition");
-    glVertexAttribPointer(attribLocation[0],3,GL_FLOAT,GL_FALSE,0,BUFFER_OFFSET(0));
-
     attribLocation[1] = glGetAttribLocation(program[0], "vNormal");
-    glVertexAttribPointer(attribLocation[1],3,GL_FLOAT,GL_FALSE,0,BUFFER_OFFSET(0));
-
-    glBindBuffer(GL_ARRAY_BUFFER, shaderBuffer[2]);
     attribLocation[2] = glGetAttribLocation(program[0], "textureSTMap");
-    glVertexAttribPointer(attribLocation[2],2,GL_FLOAT,GL_FALSE,0,BUFFER_OFFSET(0));
+    uniformLocation[33] = glGetUniformLocation(program[0], "sphereFans");
+    glUniform1i(uniformLocation[33], sphereSource == PROCEDURALSPHERE ? solarSystem.s.getFans() : 0);
+    uniformLocation[34] = glGetUniformLocation(program[0], "sphereBands");
+    glUniform1i(uniformLocation[34], solarSystem.s.getBands());
+    glBindVertexArray(VertexArrayID[0]);
+    uploadSphereMesh();
 
-    // The shader uniform variable 'objectTransform' is connected
-    // It contains sphere specification matrices (i.e. transformations to scale, rotation, and translation)
-    uniformLocation[0] = glGetUniformLocation(program[0], "objectTransform");
-    // combine the orientation, translation, and scale transforms into a single matrix for each object
-    for (int i=0; i < solarSystem.numObjects; i++)
-        objTransforms[i] = solarSystem.montum[i].modelOrientation *
-        solarSystem.montum[i].absLocationMatrix *
-        solarSystem.montum[i].modelScale;
-    glUniformMatrix4fv(uniformLocation[0], solarSystem.numObjects, GL_FALSE, glm::value_ptr(objTransforms[0]));
+    // 'bodyIndex' advances once per instance, through the list of objects drawn as meshes (shader buffer 12)
+    glBindBuffer(GL_ARRAY_BUFFER, shaderBuffer[12]);
+    attribLocation[8] = glGetAttribLocation(program[0], "bodyIndex");
+    glVertexAttribIPointer(attribLocation[8],1,GL_INT,0,BUFFER_OFFSET(0));
+    glVertexAttribDivisor(attribLocation[8], 1);
+    glEnableVertexAttribArray(attribLocation[8]);
+
+    // The shader sampler 'objectTransforms' is connected to a texture buffer (shader buffer 4)
+    // It contains sphere specifications (i.e. transformations to scale, rotation, and translation)
+    // as CompactTransforms: a quaternion texel and a translation-and-scale texel per object.
+    glGenTextures(3, &textureName[1]);
+    uniformLocation[0] = glGetUniformLocation(program[0], "objectTransforms");
+    glUniform1i(uniformLocation[0], 1);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_BUFFER, textureName[1]);
+    glBindBuffer(GL_TEXTURE_BUFFER, shaderBuffer[4]);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, shaderBuffer[4]);
+
+    // Bounding spheres (shader buffer 5) and occluder lists (shader buffer 6) drive the eclipse shadows
+    uniformLocation[2] = glGetUniformLocation(program[0], "bodySpheres");
+    glUniform1i(uniformLocation[2], 2);
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_BUFFER, textureName[2]);
+    glBindBuffer(GL_TEXTURE_BUFFER, shaderBuffer[5]);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, shaderBuffer[5]);
+
+    uniformLocation[3] = glGetUniformLocation(program[0], "occluderLists");
+    glUniform1i(uniformLocation[3], 3);
+    glActiveTexture(GL_TEXTURE3);
+    glBindTexture(GL_TEXTURE_BUFFER, textureName[3]);
+    glBindBuffer(GL_TEXTURE_BUFFER, shaderBuffer[6]);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32I, shaderBuffer[6]);
+    glActiveTexture(GL_TEXTURE0);
+
+    uniformLocation[4] = glGetUniformLocation(program[0], "numBodies");
+    uniformLocation[5] = glGetUniformLocation(program[0], "shadowMode");
+    uniformLocation[6] = glGetUniformLocation(program[0], "selectedObject");
+    glUniform1i(uniformLocation[6], selectedObject);
+    uploadObjectData();
+    /*--- (END) Sphere Preparation  ---*/
+
+    /*--- (BEGIN) Orbit Preparation  ---*/
+    // program 1 draws orbit paths and trails; it has no vertex attributes, only VAO 1 bound
+    // It reads the bounding spheres (texture unit 2), the orbit parameters (shader buffer 7),
+    // and the trail ring buffer (shader buffer 8)
+    glUseProgram(program[1]);
+    glBindVertexArray(VertexArrayID[1]);
+    glGenTextures(2, &textureName[4]);
+    uniformLocation[7] = glGetUniformLocation(program[1], "bodySpheres");
+    glUniform1i(uniformLocation[7], 2);
+    uniformLocation[8] = glGetUniformLocation(program[1], "orbitParams");
+    glUniform1i(uniformLocation[8], 4);
+    glActiveTexture(GL_TEXTURE4);
+    glBindTexture(GL_TEXTURE_BUFFER, textureName[4]);
+    glBindBuffer(GL_TEXTURE_BUFFER, shaderBuffer[7]);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RG32F, shaderBuffer[7]);
+    uniformLocation[9] = glGetUniformLocation(program[1], "trailPoints");
+    glUniform1i(uniformLocation[9], 5);
+    glActiveTexture(GL_TEXTURE5);
+    glBindTexture(GL_TEXTURE_BUFFER, textureName[5]);
+    glBindBuffer(GL_TEXTURE_BUFFER, shaderBuffer[8]);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, shaderBuffer[8]);
+    glActiveTexture(GL_TEXTURE0);
+
+    uniformLocation[10] = glGetUniformLocation(program[1], "numBodies");
+    uniformLocation[11] = glGetUniformLocation(program[1], "orbitPart");
+    uniformLocation[12] = glGetUniformLocation(program[1], "trailHead");
+    uniformLocation[13] = glGetUniformLocation(program[1], "trailFilled");
+    uniformLocation[14] = glGetUniformLocation(program[1], "selectedObject");
+    uniformLocation[15] = glGetUniformLocation(program[1], "orbitSegments");
+    glUniform1i(uniformLocation[15], orbitSegments);
+    uniformLocation[16] = glGetUniformLocation(program[1], "trailLength");
+    glUniform1i(uniformLocation[16], trailLength);
+    uniformLocation[56] = glGetUniformLocation(program[1], "scaleFactor");
+    uploadOrbitParams();
+    glBindVertexArray(VertexArrayID[0]);
+    /*--- (END) Orbit Preparation  ---*/
+
+    /*--- (BEGIN) Star Preparation  ---*/
+    // program 2 draws the star catalog as points from shader buffer 9, using VAO 2
+    // The attributes read StarRecord fields directly: direction, magnitude, and RGBA bytes
+    glUseProgram(program[2]);
+    glBindVertexArray(VertexArrayID[2]);
+    glBindBuffer(GL_ARRAY_BUFFER, shaderBuffer[9]);
+    attribLocation[3] = glGetAttribLocation(program[2], "starDirection");
+    glVertexAttribPointer(attribLocation[3],3,GL_FLOAT,GL_FALSE,sizeof(StarRecord),BUFFER_OFFSET(0));
+    attribLocation[4] = glGetAttribLocation(program[2], "starMagnitude");
+    glVertexAttribPointer(attribLocation[4],1,GL_FLOAT,GL_FALSE,sizeof(StarRecord),
+                          BUFFER_OFFSET(offsetof(StarRecord, magnitude)));
+    attribLocation[5] = glGetAttribLocation(program[2], "starColour");
+    glVertexAttribPointer(attribLocation[5],4,GL_UNSIGNED_BYTE,GL_TRUE,sizeof(StarRecord),
+                          BUFFER_OFFSET(offsetof(StarRecord, colour)));
+    glEnableVertexAttribArray(attribLocation[3]);
+    glEnableVertexAttribArray(attribLocation[4]);
+    glEnableVertexAttribArray(attribLocation[5]);
+    uniformLocation[17] = glGetUniformLocation(program[2], "magnitudeLimit");
+    glUniform1f(uniformLocation[17], starMagnitudeLimit);
+    uniformLocation[18] = glGetUniformLocation(program[2], "maxStarSize");
+    glUniform1f(uniformLocation[18], 6.0);
+    loadStars(starCatalogPath);
+    glBindVertexArray(VertexArrayID[0]);
+    /*--- (END) Star Preparation  ---*/
+
+    /*--- (BEGIN) Particle Preparation  ---*/
+    // program 3 draws the belt and ring particles from shader buffer 10 or 19, using VAO 3
+    // (uploadParticles and rebaseParticles point it at the one in use); program 12 moves their
+    // phases on from that buffer into the other by transform feedback, using VAO 8
+    glUseProgram(program[3]);
+    attribLocation[6] = glGetAttribLocation(program[3], "particleOrbit");
+    attribLocation[7] = glGetAttribLocation(program[3], "particleNode");
+    uniformLocation[19] = glGetUniformLocation(program[3], "bodySpheres");
+    glUniform1i(uniformLocation[19], 2);
+    uniformLocation[20] = glGetUniformLocation(program[3], "simMinutes");
+    uniformLocation[21] = glGetUniformLocation(program[3], "scaleFactor");
+    glUseProgram(program[12]);
+    attribLocation[13] = glGetAttribLocation(program[12], "particleOrbit");
+    attribLocation[14] = glGetAttribLocation(program[12], "particleNode");
+    uniformLocation[65] = glGetUniformLocation(program[12], "rebaseMinutes");
+    particleBelts.addDefaultBelts(solarSystem, 200000);
+    uploadParticles();
+    /*--- (END) Particle Preparation  ---*/
+
+    /*--- (BEGIN) Hierarchy Preparation  ---*/
+    // programs 4 and 5 evaluate the object tree into shader buffers 4 and 5 by transform feedback,
+    // from the parameters in shader buffer 11 (texture unit 6); they draw with the empty VAO 1
+    glGenTextures(1, &textureName[6]);
+    glActiveTexture(GL_TEXTURE6);
+    glBindTexture(GL_TEXTURE_BUFFER, textureName[6]);
+    glBindBuffer(GL_TEXTURE_BUFFER, shaderBuffer[11]);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, shaderBuffer[11]);
+    glActiveTexture(GL_TEXTURE0);
+    for (int pass = 0; pass < 2; pass++) {
+        glUseProgram(program[4+pass]);
+        uniformLocation[22+2*pass] = glGetUniformLocation(program[4+pass], "bodyParams");
+        glUniform1i(uniformLocation[22+2*pass], 6);
+        uniformLocation[23+2*pass] = glGetUniformLocation(program[4+pass], "hierarchyMinutes");
+        uniformLocation[54+pass] = glGetUniformLocation(program[4+pass], "scaleFactor");
+    }
+    /*--- (END) Hierarchy Preparation  ---*/
+
+    /*--- (BEGIN) Impostor Preparation  ---*/
+    // program 6 draws the small objects as ray-cast squares, using VAO 4; it has the same
+    // fragment shader (and so the same samplers and uniforms) as program 0
+    // 'bodyIndex' advances once per instance, through the list of impostors (shader buffer 13)
+    glUseProgram(program[6]);
+    glBindVertexArray(VertexArrayID[4]);
+    glBindBuffer(GL_ARRAY_BUFFER, shaderBuffer[13]);
+    attribLocation[9] = glGetAttribLocation(program[6], "bodyIndex");
+    glVertexAttribIPointer(attribLocation[9],1,GL_INT,0,BUFFER_OFFSET(0));
+    glVertexAttribDivisor(attribLocation[9], 1);
+    glEnableVertexAttribArray(attribLocation[9]);
+    uniformLocation[26] = glGetUniformLocation(program[6], "objectTransforms");
+    glUniform1i(uniformLocation[26], 1);
+    uniformLocation[27] = glGetUniformLocation(program[6], "sample01");
+    glUniform1i(uniformLocation[27], 0);
+    uniformLocation[28] = glGetUniformLocation(program[6], "bodySpheres");
+    glUniform1i(uniformLocation[28], 2);
+    uniformLocation[29] = glGetUniformLocation(program[6], "occluderLists");
+    glUniform1i(uniformLocation[29], 3);
+    uniformLocation[30] = glGetUniformLocation(program[6], "numBodies");
+    uniformLocation[31] = glGetUniformLocation(program[6], "shadowMode");
+    uniformLocation[32] = glGetUniformLocation(program[6], "selectedObject");
+    uniformLocation[45] = glGetUniformLocation(program[6], "allBodies");
+    glUniform1i(uniformLocation[45], 0);
+    uniformLocation[46] = glGetUniformLocation(program[6], "minRadius");
+    // other star systems are drawn by program 6 too, from their own transforms (shader buffer 17,
+    // unit 9) and their objects' stars (shader buffer 18, unit 10), with "ownStars" set
+    uniformLocation[53] = glGetUniformLocation(program[6], "ownStars");
+    glUniform1i(uniformLocation[53], 0);
+    glGenTextures(2, &textureName[9]);
+    glActiveTexture(GL_TEXTURE9);
+    glBindTexture(GL_TEXTURE_BUFFER, textureName[9]);
+    glBindBuffer(GL_TEXTURE_BUFFER, shaderBuffer[17]);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, shaderBuffer[17]);
+    glActiveTexture(GL_TEXTURE10);
+    glBindTexture(GL_TEXTURE_BUFFER, textureName[10]);
+    glBindBuffer(GL_TEXTURE_BUFFER, shaderBuffer[18]);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, shaderBuffer[18]);
+    glActiveTexture(GL_TEXTURE0);
+    glBindVertexArray(VertexArrayID[0]);
+    /*--- (END) Impostor Preparation  ---*/
+
+    /*--- (BEGIN) Terrain Preparation  ---*/
+    // program 7 draws the objects that fill much of the window as quadtree patches, using VAO 5;
+    // like program 6 it shares program 0's fragment shader. Each instance is one patch from
+    // shader buffer 14 (see TerrainPatch), and its heights are a layer of the texture array
+    // on texture unit 7, which holds as many tiles as planetTerrain's memory budget allows
+    glUseProgram(program[7]);
+    glBindVertexArray(VertexArrayID[5]);
+    glBindBuffer(GL_ARRAY_BUFFER, shaderBuffer[14]);
+    attribLocation[10] = glGetAttribLocation(program[7], "patchCorner");
+    glVertexAttribPointer(attribLocation[10],3,GL_FLOAT,GL_FALSE,sizeof(TerrainPatch),BUFFER_OFFSET(0));
+    attribLocation[11] = glGetAttribLocation(program[7], "patchInfo");
+    glVertexAttribIPointer(attribLocation[11],4,GL_INT,sizeof(TerrainPatch),BUFFER_OFFSET(offsetof(TerrainPatch, face)));
+    glVertexAttribDivisor(attribLocation[10], 1);
+    glVertexAttribDivisor(attribLocation[11], 1);
+    glEnableVertexAttribArray(attribLocation[10]);
+    glEnableVertexAttribArray(attribLocation[11]);
+
+    GLint maxLayers, tileSide = planetTerrain.grid + 1;
+    glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxLayers);
+    GLint terrainLayers = std::min(planetTerrain.layersInBudget(), int(maxLayers));
+    glGenTextures(1, &textureName[7]);
+    glActiveTexture(GL_TEXTURE7);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, textureName[7]);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_R32F, tileSide, tileSide, terrainLayers, 0, GL_RED, GL_FLOAT, NULL);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glActiveTexture(GL_TEXTURE0);
+    planetTerrain.start(terrainLayers);
+
+    uniformLocation[35] = glGetUniformLocation(program[7], "objectTransforms");
+    glUniform1i(uniformLocation[35], 1);
+    uniformLocation[36] = glGetUniformLocation(program[7], "sample01");
+    glUniform1i(uniformLocation[36], 0);
+    uniformLocation[37] = glGetUniformLocation(program[7], "bodySpheres");
+    glUniform1i(uniformLocation[37], 2);
+    uniformLocation[38] = glGetUniformLocation(program[7], "occluderLists");
+    glUniform1i(uniformLocation[38], 3);
+    uniformLocation[39] = glGetUniformLocation(program[7], "heightTiles");
+    glUniform1i(uniformLocation[39], 7);
+    uniformLocation[40] = glGetUniformLocation(program[7], "numBodies");
+    uniformLocation[41] = glGetUniformLocation(program[7], "shadowMode");
+    uniformLocation[42] = glGetUniformLocation(program[7], "selectedObject");
+    uniformLocation[43] = glGetUniformLocation(program[7], "terrainGrid");
+    glUniform1i(uniformLocation[43], planetTerrain.grid);
+    uniformLocation[44] = glGetUniformLocation(program[7], "heightScale");
+    glUniform1f(uniformLocation[44], planetTerrain.heightScale);
+    glBindVertexArray(VertexArrayID[0]);
+    /*--- (END) Terrain Preparation  ---*/
+
+    /*--- (BEGIN) Overview Preparation  ---*/
+    // the inset redraws with programs 1 and 6 through a second camera block (shader buffer 15);
+    // program 8 marks the main camera in it, with no attributes (VAO 1)
+    glUseProgram(program[8]);
+    uniformLocation[47] = glGetUniformLocation(program[8], "markerEnds");
+    uniformLocation[48] = glGetUniformLocation(program[8], "markerColour");
+    glUniform4f(uniformLocation[48], 1.0, 0.85, 0.2, 1.0);
+    /*--- (END) Overview Preparation  ---*/
+
+    /*--- (BEGIN) HUD Preparation  ---*/
+    // every character cell of the panel is one instance in shader buffer 16 (VAO 6), made once at
+    // its full size; the glyphs are baked from HudText.h into one row of an R8 texture
+    glUseProgram(program[9]);
+    glBindVertexArray(VertexArrayID[6]);
+    glBindBuffer(GL_ARRAY_BUFFER, shaderBuffer[16]);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(hudText.glyphs), hudText.glyphs, GL_DYNAMIC_DRAW);
+    attribLocation[12] = glGetAttribLocation(program[9], "hudGlyph");
+    glEnableVertexAttribArray(attribLocation[12]);
+    glVertexAttribIPointer(attribLocation[12], 3, GL_INT, sizeof(HudGlyph), BUFFER_OFFSET(0));
+    glVertexAttribDivisor(attribLocation[12], 1);
+    std::vector<unsigned char> atlas(HudText::atlasWidth() * glyphHeight);
+    HudText::bakeAtlas(&atlas.front());
+    glGenTextures(1, &textureName[8]);
+    glActiveTexture(GL_TEXTURE8);
+    glBindTexture(GL_TEXTURE_2D, textureName[8]);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, HudText::atlasWidth(), glyphHeight, 0, GL_RED, GL_UNSIGNED_BYTE, &atlas.front());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glActiveTexture(GL_TEXTURE0);
+    uniformLocation[49] = glGetUniformLocation(program[9], "glyphAtlas");
+    glUniform1i(uniformLocation[49], 8);
+    uniformLocation[50] = glGetUniformLocation(program[9], "hudScale");
+    glUniform1f(uniformLocation[50], hudScale);
+    uniformLocation[51] = glGetUniformLocation(program[9], "hudColour");
+    glUniform4f(uniformLocation[51], 0.6, 0.9, 0.6, 1.0);
+    uniformLocation[52] = glGetUniformLocation(program[9], "viewportSize");
+    glBindVertexArray(VertexArrayID[0]);
+    /*--- (END) HUD Preparation  ---*/
+
+    /*--- (BEGIN) Post-pass Preparation  ---*/
+    // programs 10 (FXAA) and 11 (TAA) draw the resolved scene into the window as one triangle,
+    // from VAO 7, which has no buffers. The scene target is frame buffer 0 (render buffers 0 and 1,
+    // multisampled), resolved into frame buffer 1: its colour on texture unit 11 and its depth on
+    // unit 12. TAA writes frame buffers 2 and 3 in turn, their colour on units 13 and 14, and reads
+    // the other. They are all made at the window's size by makeSceneTargets.
+    program[10] = prepareShaders("PostGLSL.vert", "PostGLSL.frag");
+    program[11] = prepareShaders("PostGLSL.vert", "PostGLSL.frag", "#define TAA\n");
+    glBindVertexArray(VertexArrayID[7]);
+    glUseProgram(program[10]);
+    uniformLocation[57] = glGetUniformLocation(program[10], "sceneColour");
+    glUniform1i(uniformLocation[57], 11);
+    uniformLocation[58] = glGetUniformLocation(program[10], "texelSize");
+    glUseProgram(program[11]);
+    uniformLocation[59] = glGetUniformLocation(program[11], "sceneColour");
+    glUniform1i(uniformLocation[59], 11);
+    uniformLocation[60] = glGetUniformLocation(program[11], "sceneDepth");
+    glUniform1i(uniformLocation[60], 12);
+    uniformLocation[61] = glGetUniformLocation(program[11], "history");
+    uniformLocation[62] = glGetUniformLocation(program[11], "texelSize");
+    uniformLocation[63] = glGetUniformLocation(program[11], "reprojection");
+    uniformLocation[64] = glGetUniformLocation(program[11], "historyWeight");
+    glGenFramebuffers(4, frameBuffer);
+    glGenRenderbuffers(2, renderBuffer);
+    glGenTextures(4, &textureName[11]);
+    for (int t = 11; t < 15; t++) {
+        glActiveTexture(GL_TEXTURE0 + t);
+        glBindTexture(GL_TEXTURE_2D, textureName[t]);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, t == 12 ? GL_NEAREST : GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, t == 12 ? GL_NEAREST : GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+    glActiveTexture(GL_TEXTURE0);
+    glGetIntegerv(GL_MAX_SAMPLES, &antiAliasing.maxSamples);
+    sceneTargetsStale = GL_TRUE;
+    glBindVertexArray(VertexArrayID[0]);
+    /*--- (END) Post-pass Preparation  ---*/
+    glGenQueries(numTimerQueries, timerQuery);
+    glGenQueries(numTimerQueries, gpuTimerQuery);
 
     /*-- The shader Uniform block 'Camera' containing all View and Perspective transforms is connected
          It contains matrices 'modelvMatrix' (for camera placement) and 'projMatrix' (viewing frustrum)
@@ -390,6 +1479,29 @@ void initOpenGL()
     glBindBufferBase(GL_UNIFORM_BUFFER, uBlockBinding​[0], shaderBuffer[3]);
     glBindBuffer(GL_UNIFORM_BUFFER, shaderBuffer[3]);
     glBufferData(GL_UNIFORM_BUFFER, uBlockSize[0], uBufferCamera, GL_STATIC_DRAW);
+    // programs 1 (orbits), 2 (stars), 3 (particles), 6 (impostors), 7 (terrain) and 8 (overview) read the same camera block
+    uBlockIndex[1] = glGetUniformBlockIndex(program[1], "camera");
+    glUniformBlockBinding(program[1], uBlockIndex[1], uBlockBinding​[0]);
+    uBlockIndex[2] = glGetUniformBlockIndex(program[2], "camera");
+    glUniformBlockBinding(program[2], uBlockIndex[2], uBlockBinding​[0]);
+    uBlockIndex[3] = glGetUniformBlockIndex(program[3], "camera");
+    glUniformBlockBinding(program[3], uBlockIndex[3], uBlockBinding​[0]);
+    uBlockIndex[4] = glGetUniformBlockIndex(program[6], "camera");
+    glUniformBlockBinding(program[6], uBlockIndex[4], uBlockBinding​[0]);
+    uBlockIndex[5] = glGetUniformBlockIndex(program[7], "camera");
+    glUniformBlockBinding(program[7], uBlockIndex[5], uBlockBinding​[0]);
+    uBlockIndex[6] = glGetUniformBlockIndex(program[8], "camera");
+    glUniformBlockBinding(program[8], uBlockIndex[6], uBlockBinding​[0]);
+    // the overview inset's camera block has the same layout, in shader buffer 15; drawOverview
+    // binds it in place of shader buffer 3 while the inset is drawn
+    uBufferOverview = (GLubyte *) malloc(uBlockSize[0]);
+    if (uBufferOverview==NULL)
+    {
+        std::cout << "Failed while allocating uniform block buffer.\n\n"; exit(EXIT_FAILURE);
+    }
+    memcpy(uBufferOverview, uBufferCamera, uBlockSize[0]);
+    glBindBuffer(GL_UNIFORM_BUFFER, shaderBuffer[15]);
+    glBufferData(GL_UNIFORM_BUFFER, uBlockSize[0], uBufferOverview, GL_STATIC_DRAW);
     //-------- (END) Uniform block: Camera  --------//
 
     reportParam(simspeed);
@@ -399,7 +1511,6 @@ void initTextures()
 {
     /*--- (BEGIN) Texture preparation: Map of Luna and Venus ---*/
     glGenTextures(1, textureName);
-    glEnableVertexAttribArray(attribLocation[2]);
     glUseProgram(program[0]);
     glBindVertexArray(VertexArrayID[0]);
     glActiveTexture(GL_TEXTURE0);
@@ -438,42 +1549,610 @@ void initTextures()
 //    /*--- (END) Texture preparation: Panel and sliders  ---*/
 }
 
-void updateCamera(void)
+void computeCameraMatrices(void)
 {
-    camEye = euclidSpherical(camEyeR,camEyeθ,camEyeφ);
+    // following an object, the camera circles its centre instead of the origin, stays above its
+    // highest ground, and brings the near plane in as it comes down so the ground is not clipped
+    camAt = point3(0.0f,0.0f,0.0f);
+    frNear = 0.1f;
+    if (followSelected && selectedObject >= 0) {
+        glm::vec4 sphere = shadowCasters.spheres[selectedObject];
+        GLfloat highest = sphere.w * (1.0 + planetTerrain.heightScale);
+        camEyeR = std::max(camEyeR, sphere.w * (1.0f + 1.5f*planetTerrain.heightScale));
+        camAt = point3(sphere);
+        frNear = glm::clamp(0.5f*(camEyeR - highest), 0.001f, 0.1f);
+    }
+    camEye = camAt + euclidSpherical(camEyeR,camEyeθ,camEyeφ);
     modelvMatrix = glm::lookAt(camEye,camAt,camUp);
     projMatrix = glm::perspective(frFOV,frAspect,frNear,frFar);
+    sceneViewProj = projMatrix * modelvMatrix;
+    antiAliasing.jitter(projMatrix);
+}
+void updateCamera(void)
+{
+    computeCameraMatrices();
 
     memcpy(modelMatrixAddr,&modelvMatrix, uVarMemorySize[0]);
     memcpy(projMatrixAddr,&projMatrix, uVarMemorySize[1]);
     glBindBuffer(GL_UNIFORM_BUFFER, shaderBuffer[3]);
     glBufferData(GL_UNIFORM_BUFFER, uBlockSize[0], uBufferCamera, GL_STATIC_DRAW);
 }
-void modelAnimate(void)
+// Input-to-present timing. When a frame carries camera input, a timestamp query follows its last
+// draw; the GL's clock, read at the latch, turns the GPU time it reports into glfwGetTime's. The
+// queries are collected once they are ready, a few frames later at most, and never waited on.
+void latchInputTiming(void)
 {
-    solarSystem.updateMontum(60.0 * simulationSpeed);
-    for (int i=0; i < solarSystem.numObjects; i++)
-    {
-        objTransforms[i] = solarSystem.montum[i].modelOrientation *
-        solarSystem.montum[i].absLocationMatrix *
-        solarSystem.montum[i].modelScale;
+    frameLatchTime = glfwGetTime();
+    if (frameInputTime >= 0.0) glGetInteger64v(GL_TIMESTAMP, &frameLatchGPUTime);
+}
+void submitInputTiming(void)
+{
+    if (frameInputTime < 0.0) return;
+    PendingFrame& frame = pendingFrames[nextTimerQuery];
+    if (frame.waiting) return;                  // the GPU is numTimerQueries frames behind; this one goes unmeasured
+    glQueryCounter(timerQuery[nextTimerQuery], GL_TIMESTAMP);
+    frame.inputTime = frameInputTime;
+    frame.latchTime = frameLatchTime;
+    frame.latchGPUTime = frameLatchGPUTime;
+    frame.submitTime = glfwGetTime();
+    frame.waiting = GL_TRUE;
+    nextTimerQuery = (nextTimerQuery + 1) % numTimerQueries;
+}
+void collectInputTiming(void)
+{
+    for (int i = 0; i < numTimerQueries; i++) {
+        PendingFrame& frame = pendingFrames[i];
+        if (!frame.waiting) continue;
+        GLint available = 0;
+        glGetQueryObjectiv(timerQuery[i], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) continue;
+        GLuint64 done;
+        glGetQueryObjectui64v(timerQuery[i], GL_QUERY_RESULT, &done);
+        LatencySample sample = {frame.latchTime - frame.inputTime, frame.submitTime - frame.inputTime,
+                                frame.latchTime + 1.0e-9*GLdouble(GLint64(done) - frame.latchGPUTime) - frame.inputTime};
+        inputLatency.record(sample);
+        frame.waiting = GL_FALSE;
+    }
+}
+void modelAnimate(double minutes)
+{
+    simulationMinutes += minutes;
+    if (!sceneManager.systems.empty())
+        sceneManager.step(minutes, camEye, projMatrix * modelvMatrix);
+    if (gpuHierarchy) {
+        // only the clock moves on the CPU; a new scale reaches its copy at the next resync
+        if (simulationMinutes - hierarchyEpoch >= hierarchyResyncMinutes) resyncHierarchy();
+        evaluateHierarchy();
+        appendTrailPoints();
+        return;
+    }
+    solarSystem.updateMontum(float(minutes));
+    hierarchyEpoch = simulationMinutes;
+    bodyBVH.refit(solarSystem);
+    uploadObjectData();
+    publishFeed();
+    appendTrailPoints();
+}
+// Report the events of a search started with 'e', once it has finished on the pool
+void reportEvents(void)
+{
+    std::vector<AstroEvent> events;
+    if (eventFinder.searchFinished(events)) eventFinder.report(solarSystem, events);
+}
+// Step the model if a step is due. Paced, it steps every frame by the wall time since the last
+// step, so the clock runs at simulationSpeed/pauseLength hours a second at any frame rate; unpaced,
+// it steps 60*simulationSpeed minutes at a time, once pauseLength has passed since the last step.
+void animateIfDue(void)
+{
+    GLdouble now = glfwGetTime();
+    if (framePacer.targetRate > 0.0) {
+        GLdouble elapsed = std::min(now - lastStepTime, longestStep);
+        lastStepTime = now;
+        if (!simulationPaused && elapsed > 0.0) modelAnimate(60.0 * simulationSpeed * elapsed / pauseLength);
+        return;
+    }
+    lastStepTime = now;
+    if (donePausing == GL_TRUE) {
+        lastPauseEnd = now;
+        donePausing = GL_FALSE;
+        if (!simulationPaused) modelAnimate(60.0 * simulationSpeed);
     }
-    glUniformMatrix4fv(uniformLocation[0], solarSystem.numObjects, GL_FALSE, glm::value_ptr(objTransforms[0]));
 }
 
+// The small objects: four vertices each instead of a whole sphere mesh
+void drawImpostors(void)
+{
+    if (impostorBodies.empty()) return;
+    glUseProgram(program[6]);
+    glBindVertexArray(VertexArrayID[4]);
+    glUniform1i(uniformLocation[30], solarSystem.numObjects);
+    glUniform1i(uniformLocation[31], shadowMode);
+    glUniform1i(uniformLocation[32], selectedObject);
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, GLsizei(impostorBodies.size()));
+    glBindVertexArray(VertexArrayID[0]);
+    glUseProgram(program[0]);
+}
+// The objects that fill much of the window, as quadtree patches of their raised surfaces. The
+// height tiles read since the last frame are sent first, a few at most so that a burst of reading
+// never shows as one slow frame; then the patches are chosen, and all of them drawn in one call.
+// This runs every frame, terrain or not, so that tiles asked for in classifyBodies reach the loader.
+void drawTerrain(void)
+{
+    static std::vector<TerrainTile> tiles;
+    planetTerrain.takeLoaded(tiles, terrainUploadsPerFrame);
+    if (!tiles.empty()) {
+        GLsizei tileSide = planetTerrain.grid + 1;
+        glActiveTexture(GL_TEXTURE7);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, textureName[7]);
+        for (size_t t = 0; t < tiles.size(); t++)
+            glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, tiles[t].layer, tileSide, tileSide, 1,
+                            GL_RED, GL_FLOAT, &tiles[t].heights.front());
+        glActiveTexture(GL_TEXTURE0);
+    }
+    GLfloat pixelsPerUnit = projMatrix[1][1] * halfWinHeight;
+    planetTerrain.beginFrame(projMatrix * modelvMatrix);
+    for (size_t b = 0; b < terrainBodies.size(); b++)
+        planetTerrain.select(terrainBodies[b], solarSystem.montum[terrainBodies[b]].modelTransform,
+                             camEye, pixelsPerUnit, terrainPixelError);
+    planetTerrain.endFrame();
+    if (planetTerrain.patches.empty()) return;
+
+    glUseProgram(program[7]);
+    glBindVertexArray(VertexArrayID[5]);
+    glBindBuffer(GL_ARRAY_BUFFER, shaderBuffer[14]);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(TerrainPatch) * planetTerrain.patches.size(),
+                 &planetTerrain.patches.front(), GL_STREAM_DRAW);
+    glActiveTexture(GL_TEXTURE7);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, textureName[7]);
+    glActiveTexture(GL_TEXTURE0);
+    glUniform1i(uniformLocation[40], solarSystem.numObjects);
+    glUniform1i(uniformLocation[41], shadowMode);
+    glUniform1i(uniformLocation[42], selectedObject);
+    GLsizei grid = planetTerrain.grid;
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, grid*(2*grid+4), GLsizei(planetTerrain.patches.size()));
+    glBindVertexArray(VertexArrayID[0]);
+    glUseProgram(program[0]);
+}
 void drawObjects(void)
 {
     glBindVertexArray(VertexArrayID[0]);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, textureName[0]);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_BUFFER, textureName[1]);
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_BUFFER, textureName[2]);
+    glActiveTexture(GL_TEXTURE3);
+    glBindTexture(GL_TEXTURE_BUFFER, textureName[3]);
+    glActiveTexture(GL_TEXTURE0);
+    glUniform1i(uniformLocation[5], shadowMode);
+    classifyBodies();
+    if (sphereSource == PROCEDURALSPHERE) {
+        if (!meshBodies.empty()) solarSystem.drawMontumStrip(GLsizei(meshBodies.size()));
+        drawImpostors();
+        drawTerrain();
+        return;
+    }
     glEnableVertexAttribArray(attribLocation[0]);
+    glEnableVertexAttribArray(attribLocation[1]);
     glEnableVertexAttribArray(attribLocation[2]);
     glBindBuffer(GL_ARRAY_BUFFER, shaderBuffer[1]);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, shaderBuffer[0]);
-    solarSystem.drawMontum();
+    if (!meshBodies.empty() && sphereSource == UVSPHERE)
+        solarSystem.drawMontum(GLsizei(meshBodies.size()));
+    else if (!meshBodies.empty())
+        solarSystem.drawMontumTriangles(GLsizei(meshBodies.size()), sphereMeshIndices);
     glDisableVertexAttribArray(attribLocation[0]);
+    glDisableVertexAttribArray(attribLocation[1]);
     glDisableVertexAttribArray(attribLocation[2]);
+    drawImpostors();
+    drawTerrain();
+}
+// The whole star field in one draw, behind everything else
+void drawStars(void)
+{
+    if (starsDrawn == 0) return;
+    glUseProgram(program[2]);
+    glBindVertexArray(VertexArrayID[2]);
+    glEnable(GL_PROGRAM_POINT_SIZE);
+    glEnable(GL_BLEND);
+    glDisable(GL_DEPTH_TEST);
+    glDrawArrays(GL_POINTS, 0, starsDrawn);
+    glEnable(GL_DEPTH_TEST);
+    glDisable(GL_BLEND);
+    glBindVertexArray(VertexArrayID[0]);
+    glUseProgram(program[0]);
+}
+// Every belt and ring particle in one draw; only the clock since their epoch and the scale are sent
+void drawParticles(void)
+{
+    if (!showParticles || particlesDrawn == 0) return;
+    if (fabs(simulationMinutes - particleEpoch) >= particleRebaseMinutes) rebaseParticles();
+    glUseProgram(program[3]);
+    glBindVertexArray(VertexArrayID[3]);
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_BUFFER, textureName[2]);
+    glActiveTexture(GL_TEXTURE0);
+    glUniform1f(uniformLocation[20], GLfloat(simulationMinutes - particleEpoch));
+    glUniform1f(uniformLocation[21], solarSystem.currentScaleFactor());
+    glDrawArrays(GL_POINTS, 0, particlesDrawn);
+    glBindVertexArray(VertexArrayID[0]);
+    glUseProgram(program[0]);
+}
+// Every orbit path in one instanced draw, then every trail in another (see OrbitGLSL.vert)
+void drawOrbits(void)
+{
+    if (orbitMode == NOORBITS || solarSystem.numObjects < 2) return;
+    glUseProgram(program[1]);
+    glBindVertexArray(VertexArrayID[1]);
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_BUFFER, textureName[2]);
+    glActiveTexture(GL_TEXTURE4);
+    glBindTexture(GL_TEXTURE_BUFFER, textureName[4]);
+    glActiveTexture(GL_TEXTURE5);
+    glBindTexture(GL_TEXTURE_BUFFER, textureName[5]);
+    glActiveTexture(GL_TEXTURE0);
+    glUniform1i(uniformLocation[10], solarSystem.numObjects);
+    glUniform1i(uniformLocation[14], selectedObject);
+    glUniform1f(uniformLocation[56], solarSystem.currentScaleFactor());
+    glEnable(GL_BLEND);
+    glDepthMask(GL_FALSE);          // spheres hide the lines, but the faded lines do not hide each other
+    glUniform1i(uniformLocation[11], 0);
+    glDrawArraysInstanced(GL_LINE_STRIP, 0, orbitSegments+1, solarSystem.numObjects-1);
+    if (orbitMode == ORBITSANDTRAILS && trailFilled > 1 && trailBodies == solarSystem.numObjects) {
+        glUniform1i(uniformLocation[11], 1);
+        glUniform1i(uniformLocation[12], trailHead);
+        glUniform1i(uniformLocation[13], trailFilled);
+        glDrawArraysInstanced(GL_LINE_STRIP, 0, trailLength, solarSystem.numObjects-1);
+    }
+    glDepthMask(GL_TRUE);
+    glDisable(GL_BLEND);
+    glBindVertexArray(VertexArrayID[0]);
+    glUseProgram(program[0]);
+}
+
+// The overview's camera looks straight down on the Sun from high enough to see every object and
+// the main camera. It is only rebuilt and re-sent when what it must show, or the inset, changes.
+void updateOverviewCamera(GLsizei side)
+{
+    if (overviewStale) {
+        systemExtent = 0.0;
+        for (size_t i=0; i < shadowCasters.spheres.size(); i++)
+            systemExtent = std::max(systemExtent, glm::length(point3(shadowCasters.spheres[i])) + shadowCasters.spheres[i].w);
+        overviewStale = GL_FALSE;
+        overviewExtent = 0.0;
+    }
+    GLfloat extent = 1.05f * std::max(systemExtent, glm::length(camEye));
+    if (side == overviewSide && fabs(extent - overviewExtent) < 0.02f*overviewExtent) return;
+    overviewExtent = extent;
+    overviewSide = side;
+    // at this height the view is 2*extent across at the Sun's plane
+    GLfloat height = extent * glm::perspective(frFOV, 1.0f, 1.0f, 2.0f)[1][1];
+    matr4 overviewView = glm::lookAt(point3(0.0f, height, 0.0f), point3(0.0f), point3(0.0f, 0.0f, -1.0f));
+    matr4 overviewProj = glm::perspective(frFOV, 1.0f, std::max(height - 2.0f*extent, 1.0f), height + 2.0f*extent);
+    memcpy(uBufferOverview + (modelMatrixAddr - uBufferCamera), &overviewView, uVarMemorySize[0]);
+    memcpy(uBufferOverview + (projMatrixAddr - uBufferCamera), &overviewProj, uVarMemorySize[1]);
+    glBindBuffer(GL_UNIFORM_BUFFER, shaderBuffer[15]);
+    glBufferData(GL_UNIFORM_BUFFER, uBlockSize[0], uBufferOverview, GL_STATIC_DRAW);
+    // objects are at least a pixel and a half across in the inset
+    overviewMinRadius = 1.5f * 2.0f*extent/side;
+    glUseProgram(program[6]);
+    glUniform1f(uniformLocation[46], overviewMinRadius);
+}
+// The bird's-eye inset in the top right corner: where everything is, and where the camera is.
+// It is drawn from what the main view already put on the GPU: with the overview's camera block
+// bound in place of the main one, the orbit paths are one instanced draw and every object is one
+// instance of the impostor square, read straight from the transform buffer. Nothing is classified
+// or uploaded for it but the camera's two end points (and its own camera block, when that changes).
+void drawOverview(void)
+{
+    if (!showOverview) return;
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    GLsizei side = GLsizei(overviewFraction * std::min(viewport[2], viewport[3]));
+    GLint margin = side/24;
+    GLint left = viewport[0] + viewport[2] - side - margin, bottom = viewport[1] + viewport[3] - side - margin;
+    updateOverviewCamera(side);
+    glViewport(left, bottom, side, side);
+    glScissor(left, bottom, side, side);
+    glEnable(GL_SCISSOR_TEST);
+    glClearColor(0.04, 0.04, 0.1, 1.0);
+    glClear(GL_COLOR_BUFFER_BIT| GL_DEPTH_BUFFER_BIT);
+    glClearColor(0.0, 0.0, 0.0, 1.0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, uBlockBinding​[0], shaderBuffer[15]);
+
+    // program 1 still holds this frame's uniforms from drawOrbits
+    if (orbitMode != NOORBITS && solarSystem.numObjects > 1) {
+        glUseProgram(program[1]);
+        glBindVertexArray(VertexArrayID[1]);
+        glUniform1i(uniformLocation[11], 0);
+        glEnable(GL_BLEND);
+        glDepthMask(GL_FALSE);
+        glDrawArraysInstanced(GL_LINE_STRIP, 0, orbitSegments+1, solarSystem.numObjects-1);
+        glDepthMask(GL_TRUE);
+        glDisable(GL_BLEND);
+    }
+    glUseProgram(program[6]);
+    glBindVertexArray(VertexArrayID[4]);
+    glUniform1i(uniformLocation[30], solarSystem.numObjects);
+    glUniform1i(uniformLocation[31], shadowMode);
+    glUniform1i(uniformLocation[32], selectedObject);
+    glUniform1i(uniformLocation[45], 1);
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, solarSystem.numObjects);
+    glUniform1i(uniformLocation[45], 0);
+
+    glUseProgram(program[8]);
+    glBindVertexArray(VertexArrayID[1]);
+    GLfloat ends[6] = {camEye.x, camEye.y, camEye.z, camAt.x, camAt.y, camAt.z};
+    glUniform3fv(uniformLocation[47], 2, ends);
+    glDisable(GL_DEPTH_TEST);
+    glEnable(GL_PROGRAM_POINT_SIZE);
+    glDrawArrays(GL_LINES, 0, 2);
+    glDrawArrays(GL_POINTS, 0, 1);
+    glEnable(GL_DEPTH_TEST);
+
+    glBindBufferBase(GL_UNIFORM_BUFFER, uBlockBinding​[0], shaderBuffer[3]);
+    glDisable(GL_SCISSOR_TEST);
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+    glBindVertexArray(VertexArrayID[0]);
+    glUseProgram(program[0]);
+}
+
+// Write the panel's lines into hudText. Each is formatted on the stack, and hudText only rewrites
+// (and marks for sending) those that differ from last time, which is most frames none of them.
+void updateHud(void)
+{
+    char line[HudText::maxColumns+1];
+    long minutes = long(simulationMinutes);
+    snprintf(line, sizeof(line), "DAY %ld  %02ld:%02ld", minutes / (24*60), (minutes / 60) % 24, minutes % 60);
+    hudText.setLine(0, line);
+    float hoursPerSecond = simulationSpeed/pauseLength;
+    if (simulationPaused)
+        snprintf(line, sizeof(line), "SPEED %.2f H/S (PAUSED)", hoursPerSecond);
+    else
+        snprintf(line, sizeof(line), "SPEED %.2f H/S", hoursPerSecond);
+    hudText.setLine(1, line);
+    snprintf(line, sizeof(line), "SCALE %.3f", solarSystem.currentScaleFactor());
+    hudText.setLine(2, line);
+    snprintf(line, sizeof(line), "FPS %u", hudFPS);
+    hudText.setLine(3, line);
+    snprintf(line, sizeof(line), "%s", selectedObject >= 0 ? solarSystem.montum[selectedObject].name.c_str() : "");
+    hudText.setLine(4, line);
+    if (inputLatency.count() > 0)
+        snprintf(line, sizeof(line), "INPUT %.1f MS", 1000.0*inputLatency.last().toPresent);
+    else
+        line[0] = '\0';
+    hudText.setLine(5, line);
+    snprintf(line, sizeof(line), "FRAME %.1f MS SD %.1f CPU %.0f%% GPU %.0f%%", 1000.0*framePacer.report.meanFrame,
+             1000.0*framePacer.report.deviation, 100.0*framePacer.report.cpuUse, 100.0*framePacer.report.gpuUse);
+    hudText.setLine(6, line);
+}
+// The panel in the top left corner: any changed characters are sent into the one instance buffer
+// (a single range, usually empty), then every cell is drawn in one instanced call
+void drawHud(void)
+{
+    if (!showHud) return;
+    updateHud();
+    int first, count;
+    if (hudText.takeChanged(first, count)) {
+        glBindBuffer(GL_ARRAY_BUFFER, shaderBuffer[16]);
+        glBufferSubData(GL_ARRAY_BUFFER, first*sizeof(HudGlyph), count*sizeof(HudGlyph), &hudText.glyphs[first]);
+    }
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    glUseProgram(program[9]);
+    glBindVertexArray(VertexArrayID[6]);
+    glUniform2f(uniformLocation[52], viewport[2], viewport[3]);
+    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+    glDisable(GL_DEPTH_TEST);
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, HudText::maxLines*HudText::maxColumns);
+    glEnable(GL_DEPTH_TEST);
+    // polygonModeToggle holds the mode the next 'm' moves to, so the one in use is the one before it
+    glPolygonMode(GL_FRONT_AND_BACK, polygonModeToggle == SURFACE ? GL_LINE : polygonModeToggle == POINT ? GL_FILL : GL_POINT);
+    glBindVertexArray(VertexArrayID[0]);
+    glUseProgram(program[0]);
 }
 
+// The other star systems in view: every object one impostor, lit by its own star, in one draw.
+// Their transforms are sent again only when a step (or a change of view) gathered them anew.
+void drawSceneSystems(void)
+{
+    GLsizei objects = GLsizei(sceneManager.transforms.size());
+    if (objects == 0) return;
+    if (sceneManager.changed) {
+        glBindBuffer(GL_TEXTURE_BUFFER, shaderBuffer[17]);
+        glBufferData(GL_TEXTURE_BUFFER, objects*sizeof(CompactTransform), &sceneManager.transforms.front(), GL_STREAM_DRAW);
+        glBindBuffer(GL_TEXTURE_BUFFER, shaderBuffer[18]);
+        glBufferData(GL_TEXTURE_BUFFER, objects*sizeof(glm::vec4), &sceneManager.stars.front(), GL_STREAM_DRAW);
+        sceneManager.changed = GL_FALSE;
+    }
+    glUseProgram(program[6]);
+    glBindVertexArray(VertexArrayID[4]);
+    glUniform1i(uniformLocation[26], 9);
+    glUniform1i(uniformLocation[28], 10);
+    glUniform1i(uniformLocation[53], 1);
+    glUniform1i(uniformLocation[31], NOSHADOWS);
+    glUniform1i(uniformLocation[32], -1);
+    glUniform1i(uniformLocation[45], 1);
+    glUniform1f(uniformLocation[46], 0.0);
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, objects);
+    glUniform1f(uniformLocation[46], overviewMinRadius);
+    glUniform1i(uniformLocation[45], 0);
+    glUniform1i(uniformLocation[53], 0);
+    glUniform1i(uniformLocation[28], 2);
+    glUniform1i(uniformLocation[26], 1);
+    glBindVertexArray(VertexArrayID[0]);
+    glUseProgram(program[0]);
+}
+
+// Make the scene target and the textures behind it at the window's size, for the anti-aliasing
+// chosen. What the mode does not use is cut to one pixel, so it holds no memory to speak of.
+void makeSceneTargets(void)
+{
+    int width, height;
+    glfwGetFramebufferSize(mainWin, &width, &height);
+    antiAliasing.width = width;
+    antiAliasing.height = height;
+    antiAliasing.restart();
+    sceneTargetsStale = GL_FALSE;
+    GLboolean target = antiAliasing.needsTarget(), multisampled = antiAliasing.samples() > 0;
+    GLboolean temporal = antiAliasing.postFilter == TAAPOST;
+    GLsizei w = multisampled ? width : 1, h = multisampled ? height : 1;
+    glBindRenderbuffer(GL_RENDERBUFFER, renderBuffer[0]);
+    glRenderbufferStorageMultisample(GL_RENDERBUFFER, antiAliasing.samples(), GL_RGBA8, w, h);
+    glBindRenderbuffer(GL_RENDERBUFFER, renderBuffer[1]);
+    glRenderbufferStorageMultisample(GL_RENDERBUFFER, antiAliasing.samples(), GL_DEPTH_COMPONENT24, w, h);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    for (int t = 11; t < 15; t++) {
+        GLboolean used = t < 13 ? target : temporal;
+        glActiveTexture(GL_TEXTURE0 + t);
+        if (t == 12)
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, used ? width : 1, used ? height : 1, 0,
+                         GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, NULL);
+        else
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, used ? width : 1, used ? height : 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    }
+    glActiveTexture(GL_TEXTURE0);
+    glBindFramebuffer(GL_FRAMEBUFFER, frameBuffer[0]);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, renderBuffer[0]);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, renderBuffer[1]);
+    glBindFramebuffer(GL_FRAMEBUFFER, frameBuffer[1]);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, textureName[11], 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, textureName[12], 0);
+    GLboolean complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    for (int i = 0; i < 2; i++) {
+        glBindFramebuffer(GL_FRAMEBUFFER, frameBuffer[2+i]);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, textureName[13+i], 0);
+        complete = complete && glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    }
+    if (multisampled) {
+        glBindFramebuffer(GL_FRAMEBUFFER, frameBuffer[0]);
+        complete = complete && glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (!complete && target) {
+        std::cout << "The scene target could not be made; drawing without anti-aliasing" << std::endl;
+        antiAliasing.sampleChoice = 0;
+        antiAliasing.postFilter = NOPOST;
+        makeSceneTargets();
+        return;
+    }
+    reportParam(simantialias);
+}
+// Before the scene is drawn: point it at the scene target, or at the window when the mode has none
+void beginSceneTarget(void)
+{
+    if (sceneTargetsStale) makeSceneTargets();
+    glViewport(0, 0, antiAliasing.width, antiAliasing.height);
+    if (!antiAliasing.needsTarget()) return;
+    glBindFramebuffer(GL_FRAMEBUFFER, frameBuffer[antiAliasing.samples() > 0 ? 0 : 1]);
+    glClear(GL_COLOR_BUFFER_BIT| GL_DEPTH_BUFFER_BIT);
+}
+// After it: resolve the samples and run the post-pass into the window. With samples and no
+// post-pass the resolve goes straight to the window; with a post-pass and no samples the scene
+// was drawn into frame buffer 1 and there is nothing to resolve.
+void finishSceneTarget(void)
+{
+    if (!antiAliasing.needsTarget()) return;
+    GLint w = antiAliasing.width, h = antiAliasing.height;
+    GLboolean temporal = antiAliasing.postFilter == TAAPOST;
+    if (antiAliasing.samples() > 0) {
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, frameBuffer[0]);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, antiAliasing.postFilter == NOPOST ? 0 : frameBuffer[1]);
+        glBlitFramebuffer(0, 0, w, h, 0, 0, w, h, GL_COLOR_BUFFER_BIT | (temporal ? GL_DEPTH_BUFFER_BIT : 0), GL_NEAREST);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        if (antiAliasing.postFilter == NOPOST) return;
+    }
+    glBindVertexArray(VertexArrayID[7]);
+    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+    glDisable(GL_DEPTH_TEST);
+    if (temporal) {
+        int next = antiAliasing.historyValid ? 1 - antiAliasing.lastHistory : 0;
+        glBindFramebuffer(GL_FRAMEBUFFER, frameBuffer[2+next]);
+        glUseProgram(program[11]);
+        glUniform1i(uniformLocation[61], 14-next);          // the other history texture
+        glUniform2f(uniformLocation[62], 1.0f/w, 1.0f/h);
+        glUniformMatrix4fv(uniformLocation[63], 1, GL_FALSE, glm::value_ptr(antiAliasing.reprojection(sceneViewProj)));
+        glUniform1f(uniformLocation[64], antiAliasing.historyValid ? taaHistoryWeight : 0.0f);
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, frameBuffer[2+next]);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+        glBlitFramebuffer(0, 0, w, h, 0, 0, w, h, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        antiAliasing.lastHistory = next;
+        antiAliasing.advance(sceneViewProj, !simulationPaused);
+    }
+    else {
+        glUseProgram(program[10]);
+        glUniform2f(uniformLocation[58], 1.0f/w, 1.0f/h);
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+    }
+    glEnable(GL_DEPTH_TEST);
+    glPolygonMode(GL_FRONT_AND_BACK, polygonModeToggle == SURFACE ? GL_LINE : polygonModeToggle == POINT ? GL_FILL : GL_POINT);
+    glBindVertexArray(VertexArrayID[0]);
+    glUseProgram(program[0]);
+}
+
+// Everything in the window, back to front, through the scene target; then the overview inset and
+// the panel over it, drawn straight into the window after the post-pass
+void drawScene(void)
+{
+    beginSceneTarget();
+    drawStars();
+    drawObjects();
+    drawSceneSystems();
+    drawParticles();
+    drawOrbits();
+    finishSceneTarget();
+    drawOverview();
+    drawHud();
+}
+// GPU time: a GL_TIME_ELAPSED query around each frame's drawing, collected once it is ready and
+// added to framePacer's count. When all are still in flight a frame goes untimed.
+void beginGPUTiming(void)
+{
+    gpuQueryActive = !gpuQueryWaiting[nextGPUQuery];
+    if (gpuQueryActive) glBeginQuery(GL_TIME_ELAPSED, gpuTimerQuery[nextGPUQuery]);
+}
+void endGPUTiming(void)
+{
+    if (!gpuQueryActive) return;
+    glEndQuery(GL_TIME_ELAPSED);
+    gpuQueryWaiting[nextGPUQuery] = GL_TRUE;
+    nextGPUQuery = (nextGPUQuery + 1) % numTimerQueries;
+}
+void collectGPUTiming(void)
+{
+    for (int i = 0; i < numTimerQueries; i++) {
+        if (!gpuQueryWaiting[i]) continue;
+        GLint available = 0;
+        glGetQueryObjectiv(gpuTimerQuery[i], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) continue;
+        GLuint64 elapsed;
+        glGetQueryObjectui64v(gpuTimerQuery[i], GL_QUERY_RESULT, &elapsed);
+        framePacer.addGPUTime(1.0e-9*elapsed);
+        gpuQueryWaiting[i] = GL_FALSE;
+    }
+}
+// Nothing on screen would change: the clock is stopped, no input is waiting or being acted on,
+// no tiles are arriving, and nothing has asked for the window to be drawn again
+GLboolean sceneIsStill(void)
+{
+    if (redrawNeeded || !simulationPaused || steering || inputQueue.waiting() > 0) return GL_FALSE;
+    if (planetTerrain.waitingTiles() > 0) return GL_FALSE;
+    if (antiAliasing.settling()) return GL_FALSE;   // TAA has not yet been through its jitter while still
+    return GL_TRUE;
+}
+// Take the input that has come in, latch the camera from it, and draw. Everything else in the
+// frame (the model's step, its uploads) is done before this, so the camera is as fresh as it can be.
+void latchAndDraw(void)
+{
+    glfwPollEvents();
+    processInput();
+    updateCamera();
+    latchInputTiming();
+    drawScene();
+    submitInputTiming();
+}
 
 #endif